@@ -0,0 +1,29 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <time.h>
+
+// Monotonic clock in nanoseconds
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Small deterministic generator so runs are comparable
+static inline uint64_t bench_rand(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Keeps the optimiser from discarding benchmark results
+static inline void bench_consume(uint64_t value) {
+    static volatile uint64_t sink;
+    sink += value;
+}
+
+#endif  // BENCH_COMMON_H
@@ -0,0 +1,106 @@
+// Cost of keeping the Zobrist state hash in step with the board, per lock
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "tetris_board.h"
+#include "tetris_bot.h"
+#include "tetris_fsm.h"
+#include "tetris_hash.h"
+#include "tetris_pieces.h"
+
+#define TRACE_LOCKS 20000
+#define REPEATS 20
+
+// Board just before a piece locks, plus that piece
+typedef struct {
+    Board_t board;
+    Piece_t piece;
+} LockEvent_t;
+
+static int record_trace(LockEvent_t *trace) {
+    int count = 0;
+
+    for (uint64_t seed = 1; count < TRACE_LOCKS; seed++) {
+        TetrisGame_t game;
+        Bot_t bot;
+        game_init(&game, BOARD_WIDTH, BOARD_HEIGHT);
+        seed_piece_generator(&game, seed);
+        bot_init(&bot, &game, NULL);
+
+        while (count < TRACE_LOCKS && bot_play(&bot, &game)) {
+            if (game.state != STATE_ATTACHING) continue;
+
+            board_init(&trace[count].board, BOARD_WIDTH, BOARD_HEIGHT);
+            board_copy(&trace[count].board, &game.board);
+            trace[count].piece = game.current_piece;
+            count++;
+        }
+
+        bot_free(&bot);
+        game_destroy(&game);
+    }
+    return count;
+}
+
+typedef enum { MODE_PLAIN, MODE_INCREMENTAL, MODE_RECOMPUTE } HashMode_t;
+
+static double run(const LockEvent_t *trace, int count, Board_t *scratch, HashMode_t mode) {
+    uint64_t hash = 0;
+    uint64_t start = bench_now_ns();
+
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < count; i++) {
+            const Piece_t *piece = &trace[i].piece;
+            board_copy(scratch, &trace[i].board);
+
+            if (mode == MODE_INCREMENTAL) {
+                hash = board_hash_place(hash, scratch, piece);
+                scratch->kernels->place(scratch, piece);
+                hash = board_hash_clear(hash, scratch, piece->y, piece->y + PIECE_SIZE - 1);
+                scratch->kernels->clear_lines(scratch);
+            } else {
+                scratch->kernels->place(scratch, piece);
+                scratch->kernels->clear_lines(scratch);
+                if (mode == MODE_RECOMPUTE) hash += board_hash(scratch);
+            }
+            bench_consume(hash + scratch->kernels->get_row(scratch, TOTAL_HEIGHT - 1));
+        }
+    }
+    return (double)(bench_now_ns() - start) / ((double)REPEATS * count);
+}
+
+int main(void) {
+    LockEvent_t *trace = calloc(TRACE_LOCKS, sizeof(LockEvent_t));
+    Board_t scratch;
+    if (!trace || !board_init(&scratch, BOARD_WIDTH, BOARD_HEIGHT)) return 1;
+
+    int count = record_trace(trace);
+    int clears = 0;
+    for (int i = 0; i < count; i++) {
+        board_copy(&scratch, &trace[i].board);
+        scratch.kernels->place(&scratch, &trace[i].piece);
+        clears += scratch.kernels->clear_lines(&scratch) > 0;
+    }
+
+    double plain = run(trace, count, &scratch, MODE_PLAIN);
+    double incremental = run(trace, count, &scratch, MODE_INCREMENTAL);
+    double recompute = run(trace, count, &scratch, MODE_RECOMPUTE);
+
+    printf("%d locks from bot games, %.1f%% clear lines\n", count, 100.0 * clears / count);
+    printf("%-22s %8.1f ns/lock\n", "place + clear", plain);
+    printf("%-22s %8.1f ns/lock (+%.1f)\n", "incremental hash", incremental, incremental - plain);
+    printf("%-22s %8.1f ns/lock (+%.1f)\n", "full recompute", recompute, recompute - plain);
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < count; i++) {
+        bench_consume(piece_hash(&trace[i].piece));
+    }
+    printf("%-22s %8.1f ns/call\n", "piece_hash", (double)(bench_now_ns() - start) / count);
+
+    for (int i = 0; i < count; i++) {
+        board_free(&trace[i].board);
+    }
+    board_free(&scratch);
+    free(trace);
+    return 0;
+}
@@ -0,0 +1,131 @@
+// BFS move generation versus the rotate-then-drop enumeration the bot uses
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "tetris_board.h"
+#include "tetris_bot.h"
+#include "tetris_fsm.h"
+#include "tetris_movegen.h"
+#include "tetris_pieces.h"
+
+#define POSITIONS 5000
+#define REPEATS 5
+
+// Board and piece right after a spawn
+typedef struct {
+    Board_t board;
+    Piece_t piece;
+} Position_t;
+
+static int record_positions(Position_t *positions) {
+    int count = 0;
+
+    for (uint64_t seed = 1; count < POSITIONS; seed++) {
+        TetrisGame_t game;
+        Bot_t bot;
+        int last_spawn = 0;
+        game_init(&game, BOARD_WIDTH, BOARD_HEIGHT);
+        seed_piece_generator(&game, seed);
+        bot_init(&bot, &game, NULL);
+
+        while (count < POSITIONS && bot_play(&bot, &game)) {
+            if (game.state != STATE_MOVING || game.pieces_spawned == last_spawn) continue;
+
+            last_spawn = game.pieces_spawned;
+            board_init(&positions[count].board, BOARD_WIDTH, BOARD_HEIGHT);
+            board_copy(&positions[count].board, &game.board);
+            positions[count].piece = game.current_piece;
+            count++;
+        }
+
+        bot_free(&bot);
+        game_destroy(&game);
+    }
+    return count;
+}
+
+static int drop_y(const Board_t *board, Piece_t piece) {
+    while (board->kernels->fits(board, &piece)) {
+        piece.y++;
+    }
+    return piece.y - 1;
+}
+
+// Every rotation at every column, straight down from the spawn row
+static int naive_placements(const Board_t *board, const Piece_t *start) {
+    Piece_t piece;
+    int count = 0;
+    init_piece(&piece, start->type);
+
+    for (int rotation = 0; rotation < 4; rotation++) {
+        if (rotation > 0) rotate_piece(&piece);
+        for (int x = 1 - PIECE_SIZE; x < board->width; x++) {
+            piece.x = x;
+            piece.y = start->y;
+            if (board->kernels->fits(board, &piece)) {
+                bench_consume((uint64_t)drop_y(board, piece));
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+int main(void) {
+    Position_t *positions = calloc(POSITIONS, sizeof(Position_t));
+    MoveGen_t gen;
+    if (!positions || !movegen_init(&gen, BOARD_WIDTH, BOARD_HEIGHT)) return 1;
+
+    int count = record_positions(positions);
+    long landings = 0;
+    long tucks = 0;
+    long naive = 0;
+
+    // Landings a straight drop from the spawn row cannot produce
+    for (int i = 0; i < count; i++) {
+        const Board_t *board = &positions[i].board;
+        landings += movegen_generate(&gen, board, &positions[i].piece);
+        naive += naive_placements(board, &positions[i].piece);
+
+        for (int l = 0; l < gen.landing_count; l++) {
+            Piece_t piece;
+            init_piece(&piece, positions[i].piece.type);
+            while (piece.rotation != gen.landings[l].rotation) rotate_piece(&piece);
+            piece.x = gen.landings[l].x;
+            piece.y = positions[i].piece.y;
+            tucks += !board->kernels->fits(board, &piece) || drop_y(board, piece) != gen.landings[l].y;
+        }
+    }
+
+    gen.states_expanded = 0;
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < count; i++) {
+            bench_consume((uint64_t)movegen_generate(&gen, &positions[i].board, &positions[i].piece));
+        }
+    }
+    double bfs_s = (bench_now_ns() - start) / 1e9;
+
+    start = bench_now_ns();
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < count; i++) {
+            bench_consume((uint64_t)naive_placements(&positions[i].board, &positions[i].piece));
+        }
+    }
+    double naive_s = (bench_now_ns() - start) / 1e9;
+
+    printf("%d positions from bot games\n", count);
+    printf("bfs:   %.1f landings/position (%.1f%% need a slide or spin), %.2f us/position\n",
+           (double)landings / count, 100.0 * tucks / landings, bfs_s * 1e6 / (REPEATS * count));
+    printf("       %.2f M moves/s, %.2f M states/s\n", landings * REPEATS / bfs_s / 1e6,
+           gen.states_expanded / bfs_s / 1e6);
+    printf("naive: %.1f placements/position (duplicates included), %.2f us/position\n",
+           (double)naive / count, naive_s * 1e6 / (REPEATS * count));
+
+    for (int i = 0; i < count; i++) {
+        board_free(&positions[i].board);
+    }
+    movegen_free(&gen);
+    free(positions);
+    return 0;
+}
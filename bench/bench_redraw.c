@@ -0,0 +1,94 @@
+// Engine-side CPU per frame of the serial game loop over a scripted session
+// at human key rates: building a GameInfo_t every frame against skipping
+// frames whose state version was already drawn
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "tetris.h"
+
+#define FPS 60
+#define SESSION_FRAMES (10 * 60 * FPS)  // ten minutes
+#define KEYS_PER_SECOND 3
+#define REPEATS 5
+
+// -1 for a frame without a key, else the action; hard drops set the high bit
+static int script[SESSION_FRAMES];
+
+static void build_script(void) {
+    uint64_t rng = 0x9e3779b97f4a7c15ull;
+    for (int f = 0; f < SESSION_FRAMES; f++) {
+        script[f] = -1;
+        if (bench_rand(&rng) % FPS >= KEYS_PER_SECOND) continue;
+
+        // Start restarts a finished game and does nothing during play
+        static const int keys[] = {Left, Right, Action, Action, Down, Down, Left, Right, Start};
+        script[f] = keys[bench_rand(&rng) % (sizeof(keys) / sizeof(keys[0]))];
+        if (script[f] == Down && bench_rand(&rng) % 2) script[f] |= 0x100;
+    }
+}
+
+static void feed_key(int key) {
+    if (key >= 0) userInput((UserAction_t)(key & 0xff), key & 0x100);
+}
+
+static uint64_t run_full(void) {
+    init_game();
+    userInput(Start, false);
+    uint64_t start = bench_now_ns();
+    for (int f = 0; f < SESSION_FRAMES; f++) {
+        feed_key(script[f]);
+        GameInfo_t info = updateCurrentState();
+        bench_consume((uint64_t)info.field[BOARD_HEIGHT - 1][0] + (uint64_t)info.score);
+        free_field_memory(info.field, BOARD_HEIGHT);
+        free_field_memory(info.next, PIECE_SIZE);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    cleanup_game();
+    return elapsed;
+}
+
+static uint64_t run_versioned(int *redraws) {
+    init_game();
+    userInput(Start, false);
+    uint64_t drawn = 0;
+    *redraws = 0;
+    uint64_t start = bench_now_ns();
+    for (int f = 0; f < SESSION_FRAMES; f++) {
+        feed_key(script[f]);
+        uint64_t version = tetris_state_version();
+        if (version == drawn) {
+            update_game_timer();
+            continue;
+        }
+        GameInfo_t info = updateCurrentState();
+        bench_consume((uint64_t)info.field[BOARD_HEIGHT - 1][0] + (uint64_t)info.score);
+        free_field_memory(info.field, BOARD_HEIGHT);
+        free_field_memory(info.next, PIECE_SIZE);
+        drawn = version;
+        (*redraws)++;
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    cleanup_game();
+    return elapsed;
+}
+
+int main(void) {
+    build_script();
+
+    uint64_t full_ns = UINT64_MAX;
+    uint64_t versioned_ns = UINT64_MAX;
+    int redraws = 0;
+    for (int r = 0; r < REPEATS; r++) {
+        uint64_t elapsed = run_full();
+        if (elapsed < full_ns) full_ns = elapsed;
+        elapsed = run_versioned(&redraws);
+        if (elapsed < versioned_ns) versioned_ns = elapsed;
+    }
+
+    printf("%d frames at %d FPS, %d keys/s, %d redrawn (%.1f%%)\n", SESSION_FRAMES, FPS,
+           KEYS_PER_SECOND, redraws, 100.0 * redraws / SESSION_FRAMES);
+    printf("every frame:   %7.1f ns/frame\n", (double)full_ns / SESSION_FRAMES);
+    printf("by version:    %7.1f ns/frame (%.1fx less engine CPU, draws skipped too)\n",
+           (double)versioned_ns / SESSION_FRAMES, (double)full_ns / versioned_ns);
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Full-row detection and compaction: scalar versus SSE2/AVX2 kernels
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_types.h"
+#include "tetris_rowscan.h"
+
+#define ITERATIONS 2000
+
+typedef struct {
+    int row_bits;
+    int rows;
+    int full_rows;
+} BenchCase_t;
+
+static void fill_rows(void *rows, const BenchCase_t *bc, uint64_t full) {
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    int row_bytes = bc->row_bits / 8;
+
+    for (int i = 0; i < bc->rows; i++) {
+        // Never full by accident: clear one random column
+        uint64_t row = bench_rand(&state) & full;
+        row &= ~(UINT64_C(1) << (bench_rand(&state) % bc->row_bits));
+        memcpy((char *)rows + (size_t)i * row_bytes, &row, row_bytes);
+    }
+
+    // Full rows spread over the lower half, where the stack is
+    for (int k = 0; k < bc->full_rows; k++) {
+        int y = bc->rows - 1 - (int)(bench_rand(&state) % (bc->rows / 2));
+        memcpy((char *)rows + (size_t)y * row_bytes, &full, row_bytes);
+    }
+}
+
+static double run_case(const BenchCase_t *bc, RowScanLevel_t level) {
+    size_t bytes = (size_t)bc->rows * (bc->row_bits / 8);
+    uint64_t full = bc->row_bits == 64 ? UINT64_MAX : (UINT64_C(1) << bc->row_bits) - 1;
+    void *source = malloc(bytes);
+    void *rows = malloc(bytes);
+
+    fill_rows(source, bc, full);
+    memcpy(rows, source, bytes);
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        // Boards without full rows are left untouched, so only reset when needed
+        if (bc->full_rows) memcpy(rows, source, bytes);
+        bench_consume(rows_clear_full(level, rows, bc->row_bits, bc->rows,
+                                      BOARD_EXTRA_HEIGHT, full));
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    free(rows);
+    free(source);
+    return (double)elapsed / ITERATIONS;
+}
+
+int main(void) {
+    const BenchCase_t cases[] = {
+        {16, TOTAL_HEIGHT, 0},
+        {16, TOTAL_HEIGHT, 2},
+        {16, 1004, 0},
+        {16, 1004, 4},
+        {32, 1004, 0},
+        {32, 1004, 4},
+        {64, 1004, 0},
+        {64, 1004, 4},
+        {64, 16388, 0},
+        {64, 16388, 4},
+    };
+
+    printf("best level: %s\n", rowscan_level_name(rowscan_best_level()));
+    printf("%-6s %-7s %-5s", "bits", "rows", "full");
+    for (int level = 0; level < ROWSCAN_LEVEL_COUNT; level++) {
+        printf(" %12s", rowscan_level_name(level));
+    }
+    printf("   (ns per clear, speedup vs scalar)\n");
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        const BenchCase_t *bc = &cases[c];
+        double scalar = run_case(bc, ROWSCAN_SCALAR);
+
+        printf("%-6d %-7d %-5d %12.0f", bc->row_bits, bc->rows, bc->full_rows, scalar);
+        for (int level = ROWSCAN_SCALAR + 1; level < ROWSCAN_LEVEL_COUNT; level++) {
+            if (!rowscan_level_supported(level)) {
+                printf(" %12s", "n/a");
+                continue;
+            }
+            double ns = run_case(bc, level);
+            printf(" %7.0f x%-4.1f", ns, scalar / ns);
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Writer-side cost of publishing frames to the shared-memory spectator feed
+#include "bench_common.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "tetris_fsm.h"
+#include "tetris_frame.h"
+#include "tetris_spectator.h"
+
+#define FRAMES 2000000
+
+static atomic_bool reader_running;
+
+static void *reader_thread(void *arg) {
+    const char *name = arg;
+    SpectatorFeed_t feed;
+    SpectatorFrame_t frame;
+    uint64_t rows[BOARD_MAX_HEIGHT];
+    uint64_t reads = 0;
+
+    if (!spectator_open_reader(&feed, name)) return NULL;
+    while (atomic_load(&reader_running)) {
+        reads += spectator_read_latest(&feed, &frame, rows);
+    }
+    spectator_close(&feed);
+    bench_consume(reads);
+    return NULL;
+}
+
+// ns per frame for export alone (publish == false) or export plus publish
+static double run(TetrisGame_t *game, SpectatorFeed_t *feed, bool publish) {
+    FrameExport_t fx;
+    frame_export_init(&fx, game->board.width, game->board.height);
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < FRAMES; i++) {
+        // Alternate between two positions so every frame carries a delta
+        game->current_piece.x = 3 + (i & 1);
+        const FrameView_t *view = frame_export(&fx, game);
+        if (publish) spectator_publish(feed, view);
+        bench_consume(view->change_count);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    frame_export_free(&fx);
+    return (double)elapsed / FRAMES;
+}
+
+int main(void) {
+    const int heights[] = {BOARD_HEIGHT, 200};
+    char name[64];
+    snprintf(name, sizeof(name), "tetris_bench_%d", (int)getpid());
+
+    printf("%-8s %12s %12s %12s %14s\n", "board", "export ns", "+publish ns",
+           "writer ns", "w/ reader ns");
+
+    for (int h = 0; h < 2; h++) {
+        TetrisGame_t game;
+        SpectatorFeed_t feed;
+
+        game_init(&game, BOARD_WIDTH, heights[h]);
+        fsm_process_action(&game, Start, false);
+        fsm_process_action(&game, Start, false);
+        game.current_piece.y = BOARD_EXTRA_HEIGHT + heights[h] / 2;
+
+        if (!spectator_open_writer(&feed, name, BOARD_WIDTH, heights[h])) {
+            fprintf(stderr, "cannot open feed\n");
+            return 1;
+        }
+
+        double base = run(&game, &feed, false);
+        double with_publish = run(&game, &feed, true);
+
+        pthread_t reader;
+        atomic_store(&reader_running, true);
+        pthread_create(&reader, NULL, reader_thread, name);
+        double contended = run(&game, &feed, true);
+        atomic_store(&reader_running, false);
+        pthread_join(reader, NULL);
+
+        printf("%2dx%-5d %12.1f %12.1f %12.1f %14.1f\n", BOARD_WIDTH, heights[h], base,
+               with_publish, with_publish - base, contended - base);
+
+        spectator_close(&feed);
+        game_destroy(&game);
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Frame stream size and speed over recorded bot games: bytes per frame
+// against a GameInfo_t-style grid dump, then encode and decode ns/frame
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_bot.h"
+#include "tetris_frame.h"
+#include "tetris_fsm.h"
+#include "tetris_pieces.h"
+#include "tetris_stream.h"
+
+#define GAMES 20
+#define MAX_TICKS 5000
+#define REPEATS 20
+
+// What the GameInfo_t field and next grid cost as plain ints, plus its scalars
+#define GRID_BYTES ((BOARD_WIDTH * BOARD_HEIGHT + PIECE_SIZE * PIECE_SIZE + 5) * (int)sizeof(int))
+
+typedef struct {
+    uint64_t rows[BOARD_HEIGHT];
+    int score, high_score, level, speed, pause, hold;
+    uint8_t next;
+} Snapshot_t;
+
+int main(void) {
+    Snapshot_t *snapshots = malloc(sizeof(Snapshot_t) * GAMES * MAX_TICKS);
+    uint8_t *stream_buf = malloc((size_t)GAMES * MAX_TICKS * STREAM_MAX_FRAME_BYTES(BOARD_HEIGHT));
+    if (!snapshots || !stream_buf) return 1;
+
+    // Record one frame per tick of bot play
+    int frames = 0;
+    for (int g = 0; g < GAMES; g++) {
+        TetrisGame_t game;
+        FrameExport_t fx;
+        Bot_t bot;
+        if (!game_init(&game, BOARD_WIDTH, BOARD_HEIGHT) ||
+            !frame_export_init(&fx, BOARD_WIDTH, BOARD_HEIGHT) || !bot_init(&bot, &game, NULL)) {
+            return 1;
+        }
+        seed_piece_generator(&game, (uint64_t)g + 1);
+
+        for (int t = 0; t < MAX_TICKS && bot_play(&bot, &game); t++) {
+            fsm_update_timer(&game);
+            const FrameView_t *view = frame_export(&fx, &game);
+            Snapshot_t *s = &snapshots[frames++];
+            memcpy(s->rows, view->rows, sizeof(s->rows));
+            s->score = view->score;
+            s->high_score = view->high_score;
+            s->level = view->level;
+            s->speed = view->speed;
+            s->pause = view->pause;
+            s->hold = view->hold;
+            s->next = view->preview[0];
+        }
+        bot_free(&bot);
+        frame_export_free(&fx);
+        game_destroy(&game);
+    }
+
+    // Replays the snapshots as views, the way an exporter would hand them over
+    FrameView_t view = {.width = BOARD_WIDTH, .height = BOARD_HEIGHT, .preview_count = 1};
+    FrameStream_t encoder;
+    FrameStream_t decoder;
+    if (!stream_init(&encoder, BOARD_WIDTH, BOARD_HEIGHT, STREAM_DEFAULT_KEYFRAME_INTERVAL) ||
+        !stream_init(&decoder, BOARD_WIDTH, BOARD_HEIGHT, 0)) {
+        return 1;
+    }
+
+    size_t total = 0;
+    size_t keyframe_bytes = 0;
+    int keyframes = 0;
+    uint64_t encode_ns = UINT64_MAX;
+    for (int r = 0; r < REPEATS; r++) {
+        stream_request_keyframe(&encoder);
+        encoder.frames = 0;
+        total = 0;
+        uint64_t start = bench_now_ns();
+        for (int f = 0; f < frames; f++) {
+            const Snapshot_t *s = &snapshots[f];
+            view.rows = s->rows;
+            view.score = s->score;
+            view.high_score = s->high_score;
+            view.level = s->level;
+            view.speed = s->speed;
+            view.pause = s->pause;
+            view.hold = s->hold;
+            view.preview = &s->next;
+
+            size_t size = stream_encode(&encoder, &view, stream_buf + total);
+            if (r == 0 && (stream_buf[total] & STREAM_KEYFRAME)) {
+                keyframes++;
+                keyframe_bytes += size;
+            }
+            total += size;
+        }
+        uint64_t elapsed = bench_now_ns() - start;
+        if (elapsed < encode_ns) encode_ns = elapsed;
+    }
+
+    uint64_t decode_ns = UINT64_MAX;
+    for (int r = 0; r < REPEATS; r++) {
+        decoder.synced = false;
+        size_t offset = 0;
+        StreamFrame_t frame;
+        uint64_t start = bench_now_ns();
+        for (int f = 0; f < frames; f++) {
+            int used = stream_decode(&decoder, stream_buf + offset, total - offset, &frame);
+            if (used < 0) {
+                fprintf(stderr, "decode failed at frame %d\n", f);
+                return 1;
+            }
+            offset += (size_t)used;
+        }
+        uint64_t elapsed = bench_now_ns() - start;
+        if (elapsed < decode_ns) decode_ns = elapsed;
+        bench_consume(frame.rows[BOARD_HEIGHT - 1] + (uint64_t)frame.score);
+        if (memcmp(frame.rows, snapshots[frames - 1].rows, sizeof(snapshots[0].rows)) != 0) {
+            fprintf(stderr, "decoded field differs from the last frame\n");
+            return 1;
+        }
+    }
+
+    double per_frame = (double)total / frames;
+    printf("%d frames from %d bot games, keyframe every %d\n", frames, GAMES,
+           STREAM_DEFAULT_KEYFRAME_INTERVAL);
+    printf("grid dump:     %5d bytes/frame\n", GRID_BYTES);
+    printf("packed rows:   %5d bytes/frame\n",
+           (int)(BOARD_HEIGHT * sizeof(uint64_t) + 5 * sizeof(int)));
+    printf("stream:        %5.2f bytes/frame (%.0fx smaller than the grid), keyframes %.1f bytes\n",
+           per_frame, GRID_BYTES / per_frame, keyframes ? (double)keyframe_bytes / keyframes : 0.0);
+    printf("encode %.1f ns/frame, decode %.1f ns/frame\n", (double)encode_ns / frames,
+           (double)decode_ns / frames);
+
+    stream_free(&encoder);
+    stream_free(&decoder);
+    free(stream_buf);
+    free(snapshots);
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Cost of per-piece telemetry on the game thread: seeded bot games driven
+// a frame at a time like a frontend, with recording off and on, plus the
+// bare append into the writer's ring
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tetris_bot.h"
+#include "tetris_fsm.h"
+#include "tetris_pieces.h"
+#include "tetris_telemetry.h"
+
+#define GAMES 30
+#define PIECE_LIMIT 500
+#define REPEATS 5
+#define APPENDS 1000000
+
+typedef struct {
+    uint64_t ns;
+    uint64_t frames;
+    uint64_t pieces;
+} RunResult_t;
+
+static RunResult_t run_games(TelemetryWriter_t *writer) {
+    RunResult_t result = {0};
+    uint64_t start = bench_now_ns();
+    for (int g = 0; g < GAMES; g++) {
+        TetrisGame_t game;
+        Bot_t bot;
+        game_init(&game, BOARD_WIDTH, BOARD_HEIGHT);
+        seed_piece_generator(&game, (uint64_t)g + 1);
+        game.telemetry = writer;
+        bot_init(&bot, &game, NULL);
+
+        while (game.pieces_spawned < PIECE_LIMIT && bot_play(&bot, &game)) {
+            fsm_update_timer(&game);
+            result.frames++;
+        }
+        result.pieces += (uint64_t)game.pieces_spawned;
+        bench_consume((uint64_t)game.score);
+
+        bot_free(&bot);
+        game_destroy(&game);
+    }
+    result.ns = bench_now_ns() - start;
+    return result;
+}
+
+int main(void) {
+    char path[] = "/tmp/bench_telemetry_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    RunResult_t off = {UINT64_MAX, 0, 0};
+    RunResult_t on = {UINT64_MAX, 0, 0};
+    uint64_t dropped = 0;
+    for (int r = 0; r < REPEATS; r++) {
+        RunResult_t result = run_games(NULL);
+        if (result.ns < off.ns) off = result;
+
+        TelemetryWriter_t *writer = telemetry_open(path);
+        if (!writer) {
+            perror(path);
+            return 1;
+        }
+        result = run_games(writer);
+        dropped += telemetry_dropped(writer);
+        telemetry_close(writer);
+        if (result.ns < on.ns) on = result;
+    }
+
+    // The ring alone, with the flush thread draining it behind us
+    TelemetryWriter_t *writer = telemetry_open(path);
+    TelemetryRecord_t record = {.piece = PIECE_T, .level = 1};
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < APPENDS; i++) {
+        record.lock_frame = (uint32_t)i;
+        if (!telemetry_append(writer, &record)) {
+            i--;  // full: count only records that went in
+        }
+    }
+    uint64_t append_ns = bench_now_ns() - start;
+    telemetry_close(writer);
+    unlink(path);
+
+    printf("%d bot games, %llu frames, %llu pieces per run\n", GAMES,
+           (unsigned long long)off.frames, (unsigned long long)off.pieces);
+    printf("telemetry off: %7.1f ns/frame\n", (double)off.ns / off.frames);
+    printf("telemetry on:  %7.1f ns/frame (%+.1f ns/frame, %+.1f ns/piece, %llu dropped)\n",
+           (double)on.ns / on.frames, ((double)on.ns - off.ns) / on.frames,
+           ((double)on.ns - off.ns) / on.pieces, (unsigned long long)dropped);
+    printf("append:        %7.1f ns/record including waits on a full ring\n",
+           (double)append_ns / APPENDS);
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Versus matches between two bots at full speed: whole matches per second,
+// then the same inputs replayed without the bots to isolate the engine
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "tetris_bot.h"
+#include "tetris_versus.h"
+
+#define MATCHES 200
+#define PLAYERS 2
+#define MAX_TICKS 20000
+
+typedef struct {
+    VersusKey_t *keys;  // MAX_TICKS * PLAYERS per match, one key per player and tick
+    int ticks;
+} MatchTrace_t;
+
+int main(void) {
+    VersusMatch_t match;
+    Bot_t bots[PLAYERS];
+    MatchTrace_t *traces = calloc(MATCHES, sizeof(MatchTrace_t));
+    if (!traces || !versus_init(&match, PLAYERS, BOARD_WIDTH, BOARD_HEIGHT, 1)) return 1;
+    for (int p = 0; p < PLAYERS; p++) {
+        if (!bot_init(&bots[p], &match.players[p].game, NULL)) return 1;
+    }
+
+    long ticks = 0;
+    long attacks = 0;
+    long garbage = 0;
+    int decided = 0;
+    uint64_t start = bench_now_ns();
+
+    for (int m = 0; m < MATCHES; m++) {
+        MatchTrace_t *trace = &traces[m];
+        trace->keys = malloc(sizeof(VersusKey_t) * MAX_TICKS * PLAYERS);
+        if (!trace->keys) return 1;
+
+        versus_restart(&match, (uint64_t)m + 1);
+        // Piece counters restart with the match, so force a fresh plan
+        for (int p = 0; p < PLAYERS; p++) {
+            bots[p].planned_piece = -1;
+        }
+
+        bool running = true;
+        while (running && trace->ticks < MAX_TICKS) {
+            VersusKey_t *keys = &trace->keys[trace->ticks * PLAYERS];
+            VersusInput_t inputs[PLAYERS] = {0};
+            for (int p = 0; p < PLAYERS; p++) {
+                keys[p] = (VersusKey_t){FSM_IDLE, false};  // kept by a topped-out bot
+                bot_next_input(&bots[p], &match.players[p].game, &keys[p].action, &keys[p].hold);
+                versus_input_push(&inputs[p], keys[p].action, keys[p].hold);
+            }
+            running = versus_tick(&match, inputs);
+            attacks += match.event_count;
+            trace->ticks++;
+        }
+
+        ticks += trace->ticks;
+        decided += match.over && match.winner >= 0;
+        for (int p = 0; p < PLAYERS; p++) {
+            garbage += match.players[p].lines_received;
+        }
+    }
+    double seconds = (bench_now_ns() - start) / 1e9;
+
+    // Engine only: the recorded inputs, no bot search
+    start = bench_now_ns();
+    for (int m = 0; m < MATCHES; m++) {
+        versus_restart(&match, (uint64_t)m + 1);
+        for (int t = 0; t < traces[m].ticks; t++) {
+            VersusInput_t inputs[PLAYERS];
+            for (int p = 0; p < PLAYERS; p++) {
+                inputs[p].keys[0] = traces[m].keys[t * PLAYERS + p];
+                inputs[p].count = 1;
+            }
+            versus_tick(&match, inputs);
+        }
+        bench_consume(match.tick + (uint64_t)match.winner);
+    }
+    double replay = (bench_now_ns() - start) / 1e9;
+
+    printf("%d matches, %d players, %d decided, %.0f ticks/match (cap %d)\n", MATCHES, PLAYERS,
+           decided, (double)ticks / MATCHES, MAX_TICKS);
+    printf("%.1f attacks and %.1f garbage rows per match\n", (double)attacks / MATCHES,
+           (double)garbage / MATCHES);
+    printf("with bots:   %8.1f matches/s  %6.2f M ticks/s\n", MATCHES / seconds, ticks / seconds / 1e6);
+    printf("engine only: %8.1f matches/s  %6.2f M ticks/s  %.1f ns/tick\n", MATCHES / replay,
+           ticks / replay / 1e6, replay * 1e9 / ticks);
+
+    for (int m = 0; m < MATCHES; m++) {
+        free(traces[m].keys);
+    }
+    free(traces);
+    for (int p = 0; p < PLAYERS; p++) {
+        bot_free(&bots[p]);
+    }
+    versus_free(&match);
+    return 0;
+}
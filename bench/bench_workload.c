@@ -0,0 +1,78 @@
+// Representative headless workload: seeded bot games plus scripted input.
+// Used as the training run for PGO and to compare build variants; the
+// checksum must match across variants.
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "tetris_bot.h"
+#include "tetris_frame.h"
+#include "tetris_fsm.h"
+#include "tetris_pieces.h"
+
+#define BOT_GAMES 60
+#define BOT_PIECE_LIMIT 400
+#define SCRIPTED_GAMES 40
+#define SCRIPTED_FRAMES 5000
+
+static uint64_t run_bot_games(void) {
+    uint64_t checksum = 0;
+
+    for (int g = 0; g < BOT_GAMES; g++) {
+        TetrisGame_t game;
+        Bot_t bot;
+        game_init(&game, BOARD_WIDTH, BOARD_HEIGHT);
+        seed_piece_generator(&game, (uint64_t)g + 1);
+        bot_init(&bot, &game, NULL);
+
+        while (game.pieces_spawned < BOT_PIECE_LIMIT && bot_play(&bot, &game)) {
+        }
+        checksum = checksum * 31 + (uint64_t)game.score + (uint64_t)game.pieces_spawned;
+
+        bot_free(&bot);
+        game_destroy(&game);
+    }
+
+    return checksum;
+}
+
+// Pseudo-random key presses with a frame export per tick, like a frontend
+static uint64_t run_scripted_games(void) {
+    uint64_t checksum = 0;
+
+    for (int g = 0; g < SCRIPTED_GAMES; g++) {
+        TetrisGame_t game;
+        FrameExport_t frames;
+        uint64_t script = 0x5eed0000u + (uint64_t)g;
+        game_init(&game, BOARD_WIDTH, BOARD_HEIGHT);
+        seed_piece_generator(&game, (uint64_t)g + 1000);
+        frame_export_init(&frames, BOARD_WIDTH, BOARD_HEIGHT);
+        fsm_process_action(&game, Start, false);
+
+        for (int frame = 0; frame < SCRIPTED_FRAMES; frame++) {
+            uint64_t r = bench_rand(&script);
+            UserAction_t action = (UserAction_t)(r % 8);
+            if (action == Pause || action == Terminate) action = Down;
+            if (game.state == STATE_GAME_OVER) action = Start;
+
+            fsm_process_action(&game, action, (r >> 8) % 16 == 0);
+            fsm_update_timer(&game);
+            checksum += (uint64_t)frame_export(&frames, &game)->change_count;
+        }
+        checksum = checksum * 31 + (uint64_t)game.score;
+
+        frame_export_free(&frames);
+        game_destroy(&game);
+    }
+
+    return checksum;
+}
+
+int main(void) {
+    uint64_t start = bench_now_ns();
+    uint64_t checksum = run_bot_games();
+    checksum ^= run_scripted_games() << 1;
+    uint64_t elapsed = bench_now_ns() - start;
+
+    printf("workload: %.1f ms checksum %016llx\n", elapsed / 1e6, (unsigned long long)checksum);
+    return 0;
+}
@@ -0,0 +1,25 @@
+#!/bin/sh
+# Usage: compare_variants.sh ROOT WORKLOAD VARIANT...
+# Runs ROOT/VARIANT/WORKLOAD a few times per variant and reports the best
+# time and the speedup over the first variant listed.
+set -e
+
+root=$1
+workload=$2
+shift 2
+runs=${RUNS:-3}
+base=
+
+printf '%-8s %10s %8s  %s\n' variant best_ms speedup checksum
+for variant in "$@"; do
+    best=
+    for i in $(seq "$runs"); do
+        out=$("$root/$variant/$workload")
+        ms=$(echo "$out" | awk '{print $2}')
+        sum=$(echo "$out" | awk '{print $5}')
+        best=$(awk -v a="$best" -v b="$ms" 'BEGIN {print (a == "" || b < a) ? b : a}')
+    done
+    base=${base:-$best}
+    speedup=$(awk -v a="$base" -v b="$best" 'BEGIN {printf "%.2fx", a / b}')
+    printf '%-8s %10s %8s  %s\n' "$variant" "$best" "$speedup" "$sum"
+done
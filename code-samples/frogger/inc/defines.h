@@ -34,6 +34,8 @@
 #define FROGSTART_X      (BOARD_M / 2)
 #define FROGSTART_Y      (BOARD_N)
 #define INITIAL_TIMEOUT  150
+#define TICK_NS(speed)   ((INITIAL_TIMEOUT - (speed) * 15) * 1000000LL)
+#define JITTER_FLAG      "-j"
 
 #define BOARD_N     (ROWS_MAP + MAP_PADDING * 2)
 #define BOARD_M     30
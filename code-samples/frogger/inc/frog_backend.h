@@ -6,11 +6,14 @@
 #include "objects.h"
 #include "string.h"
 
+int levels_load(void);
+int read_lane(FILE *level, char *lane);
 int lvlproc(board_t *map, game_stats_t *stats);
 void add_proggress(board_t *map);
 void stats_init(game_stats_t *stats);
 void frogpos_init(player_pos *frog);
 void fill_finish(char *finish_line);
+void lanes_init(board_t *map);
 void shift_map(board_t *map);
 
 bool check_collide(player_pos *frog, board_t *map);
@@ -6,6 +6,11 @@
 #include "frog_backend.h"
 #include "frog_frontend.h"
 
-void game_loop();
+void game_loop(ticker_t *ticker);
+long long now_ns(void);
+void sleep_until(long long deadline);
+signals next_signal(ticker_t *ticker, frog_state state, int speed);
+signals ticker_fire(ticker_t *ticker, long long now, long long period);
+void print_jitter(const ticker_t *ticker);
 
 #endif
\ No newline at end of file
@@ -27,6 +27,7 @@ typedef enum
     MOVE_LEFT,
     ESCAPE_BTN,
     ENTER_BTN,
+    TICK,
     NOSIG
 } signals;
 
@@ -10,12 +10,36 @@ typedef struct
     int y;
 } player_pos;
 
+/*
+    Each lane is a ring of COLS_MAP cells. Moving a lane only advances its
+    offset by its step, so column col of a lane lives at
+    ways[lane][(col - offset[lane]) mod COLS_MAP]; read it with lane_cell().
+    Steps are per lane, positive moving right, and may differ in size.
+*/
 typedef struct
 {
     char finish[BOARD_M + 2];
     char ways[ROWS_MAP + 2][COLS_MAP + 2];
+    int offset[ROWS_MAP];
+    int step[ROWS_MAP];
 } board_t;
 
+static inline char lane_cell(const board_t *map, int lane, int col)
+{
+    int idx = col - map->offset[lane];
+
+    if (idx < 0)
+        idx += COLS_MAP;
+
+    return map->ways[lane][idx];
+}
+
+typedef struct
+{
+    char ways[LEVEL_CNT][ROWS_MAP + 2][COLS_MAP + 2];
+    bool loaded;
+} levels_t;
+
 typedef struct
 {
     int score;
@@ -25,6 +49,20 @@ typedef struct
     int won;
 } game_stats_t;
 
+/*
+    Fixed-step clock for lane movement. Ticks fall on deadlines of the
+    monotonic clock, so keys neither speed lanes up nor delay them.
+*/
+typedef struct
+{
+    long long deadline;  // ns on CLOCK_MONOTONIC of the next tick
+    bool armed;
+    long ticks;
+    long dropped;        // whole periods skipped after a stall
+    long long late_sum;  // ns past the deadline, over all ticks
+    long long late_max;
+} ticker_t;
+
 typedef struct
 {
     char matrix[BANNER_N + 1][BANNER_M + 1];
@@ -1,27 +1,66 @@
 #include "frog_backend.h"
 
-int lvlproc(board_t *map, game_stats_t *stats)
-{
-    timeout(INITIAL_TIMEOUT - stats->speed * 15);
-
-    char levelname[LEVELNAME_MAX + 1] = { 0 };
+// Every level, read and checked once by levels_load() so spawning never
+// touches the filesystem
+static levels_t levels;
 
-    sprintf(levelname, LEVEL_DIR"%d.txt", stats->level);
-    
-    FILE *level = fopen(levelname, "r");
-    
+int levels_load(void)
+{
     int rc = SUCCESS;
 
-    if (level)
+    for (int n = 0; n < LEVEL_CNT && !rc; n++)
     {
-        for (int i = 0; i < ROWS_MAP && !rc; i++)
+        char levelname[LEVELNAME_MAX + 1] = { 0 };
+
+        sprintf(levelname, LEVEL_DIR"%d.txt", n + 1);
+
+        FILE *level = fopen(levelname, "r");
+
+        if (level)
         {
-            if (fgets(map->ways[i], COLS_MAP + 2, level) == NULL)
-                rc = ERROR;
-            else
-                map->ways[i][strcspn(map->ways[i], "\n")] = '\0';
+            for (int i = 0; i < ROWS_MAP && !rc; i++)
+                rc = read_lane(level, levels.ways[n][i]);
+            fclose(level);
         }
-        fclose(level);
+        else
+            rc = ERROR;
+    }
+
+    levels.loaded = !rc;
+
+    return rc;
+}
+
+// A lane is a full ring of COLS_MAP cells; shorter lines would leave holes.
+// The line buffer also holds a CRLF ending, so it is consumed with the cells.
+int read_lane(FILE *level, char *lane)
+{
+    int rc = SUCCESS;
+    char line[COLS_MAP + 3];
+
+    if (fgets(line, sizeof(line), level) == NULL)
+        rc = ERROR;
+    else
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (strlen(line) != COLS_MAP)
+            rc = ERROR;
+        else
+            memcpy(lane, line, COLS_MAP + 1);
+    }
+
+    return rc;
+}
+
+int lvlproc(board_t *map, game_stats_t *stats)
+{
+    int rc = SUCCESS;
+
+    if (levels.loaded && stats->level >= 1 && stats->level <= LEVEL_CNT)
+    {
+        memcpy(map->ways, levels.ways[stats->level - 1], sizeof(levels.ways[0]));
+        lanes_init(map);
     }
     else
         rc = ERROR;
@@ -29,6 +68,15 @@ int lvlproc(board_t *map, game_stats_t *stats)
     return rc;
 }
 
+void lanes_init(board_t *map)
+{
+    for (int i = 0; i < ROWS_MAP; i++)
+    {
+        map->offset[i] = 0;
+        map->step[i] = i % 2;
+    }
+}
+
 void add_proggress(board_t *map)
 {
     int position = 0;
@@ -64,7 +112,7 @@ bool check_collide(player_pos *frog, board_t *map)
     bool rc = FALSE;
 
     if (frog->y > MAP_PADDING && frog->y < ROWS_MAP + MAP_PADDING + 1 && \
-        map->ways[frog->y - MAP_PADDING - 1][frog->x - 1] == ']')
+        lane_cell(map, frog->y - MAP_PADDING - 1, frog->x - 1) == ']')
         rc = TRUE;
 
     return rc;
@@ -95,9 +143,11 @@ void stats_init(game_stats_t *stats)
 
 void shift_map(board_t *map)
 {
-    for (int i = 1; i < ROWS_MAP; i += 2)
+    for (int i = 0; i < ROWS_MAP; i++)
     {
-        memmove(&map->ways[i][1], &map->ways[i][0], COLS_MAP * sizeof(char));
-        map->ways[i][0] = map->ways[i][COLS_MAP];
+        map->offset[i] = (map->offset[i] + map->step[i]) % COLS_MAP;
+
+        if (map->offset[i] < 0)
+            map->offset[i] += COLS_MAP;
     }
 }
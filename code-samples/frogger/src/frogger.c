@@ -1,37 +1,45 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <time.h>
 #include "frogger.h"
 
-int main(void)
+int main(int argc, char *argv[])
 {
+    ticker_t ticker = { 0 };
+
     WIN_INIT(50);
     setlocale(LC_ALL, "");
     print_overlay();
-    game_loop();
+    game_loop(&ticker);
     endwin();
 
+    if (argc > 1 && !strcmp(argv[1], JITTER_FLAG))
+        print_jitter(&ticker);
+
     return SUCCESS;
 }
 
-void game_loop()
+void game_loop(ticker_t *ticker)
 {
     board_t map;
     game_stats_t stats;
     player_pos frog;
 
     bool break_flag = TRUE;
-    int signal = 0;
-    frog_state state = START;
+    signals signal = NOSIG;
+    frog_state state = levels_load() ? FILE_ERROR_STATE : START;
 
     stats_init(&stats);
 
     while (break_flag)
-    {   
+    {
         if (state == GAMEOVER || state == EXIT_STATE || state == FILE_ERROR_STATE)
             break_flag = FALSE;
 
-        sigact(get_signal(signal), &state, &stats, &map, &frog);
+        sigact(signal, &state, &stats, &map, &frog);
 
         if (state == MOVING || state == START)
-            signal = GET_USER_INPUT;
+            signal = next_signal(ticker, state, stats.speed);
     }
 
     if (state == FILE_ERROR_STATE)
@@ -40,4 +48,95 @@ void game_loop()
         nodelay(stdscr, FALSE);
         getch();
     }
-}
\ No newline at end of file
+}
+
+long long now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void sleep_until(long long deadline)
+{
+    struct timespec ts = { deadline / 1000000000LL, deadline % 1000000000LL };
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)) ;
+}
+
+/*
+    Waits for whichever comes first: a key, or the next tick deadline while
+    lanes are moving. getch() only ever blocks until that deadline, and keys
+    already typed come back at once, so input is drained between ticks
+    without moving the clock.
+*/
+signals next_signal(ticker_t *ticker, frog_state state, int speed)
+{
+    signals sig = NOSIG;
+    bool ticking = state == MOVING;
+    long long period = TICK_NS(speed);
+
+    if (!ticking)
+        ticker->armed = FALSE;
+    else if (!ticker->armed)
+    {
+        ticker->deadline = now_ns() + period;
+        ticker->armed = TRUE;
+    }
+
+    while (sig == NOSIG)
+    {
+        long long now = now_ns();
+
+        if (ticking && now >= ticker->deadline)
+            sig = ticker_fire(ticker, now, period);
+        else if (ticking && ticker->deadline - now < 1000000)
+            sleep_until(ticker->deadline);
+        else
+        {
+            // getch() counts whole ms; the last fraction is slept off above
+            timeout(ticking ? (int)((ticker->deadline - now) / 1000000) : -1);
+
+            int key = GET_USER_INPUT;
+
+            if (key != ERR)
+                sig = get_signal(key);
+        }
+    }
+
+    return sig;
+}
+
+signals ticker_fire(ticker_t *ticker, long long now, long long period)
+{
+    long long late = now - ticker->deadline;
+
+    ticker->ticks++;
+    ticker->late_sum += late;
+    if (late > ticker->late_max)
+        ticker->late_max = late;
+
+    // Keep the phase; after a stall skip the missed ticks instead of bursting
+    ticker->deadline += period;
+    if (ticker->deadline <= now)
+    {
+        long long missed = (now - ticker->deadline) / period + 1;
+
+        ticker->dropped += missed;
+        ticker->deadline += missed * period;
+    }
+
+    return TICK;
+}
+
+void print_jitter(const ticker_t *ticker)
+{
+    if (ticker->ticks)
+        printf("%ld ticks, late by %lld us on average, %lld us at most, %ld dropped\n",
+               ticker->ticks, ticker->late_sum / ticker->ticks / 1000,
+               ticker->late_max / 1000, ticker->dropped);
+    else
+        printf("no ticks\n");
+}
@@ -21,9 +21,9 @@ void print_overlay(void)
 void print_levelerror(void)
 {
     clear();
-    MVPRINTW(0, 0, "An error occured openning level file!");
+    MVPRINTW(0, 0, "An error occured loading level files!");
     MVPRINTW(2, 0, "Please check ./tests/ directory.");
-    MVPRINTW(3, 0, "There should be 5 level files named level_(1-5).txt.");
+    MVPRINTW(3, 0, "There should be 5 level files named level_(1-5).txt of 21 lines, 90 columns each.");
     MVPRINTW(4, 0, "Also try to open the game nearby ./tests/ directory.");
     MVPRINTW(6, 0, "Press any key to exit.");
 }
@@ -78,7 +78,7 @@ void print_cars(board_t *game)
         {
             for (int j = 1; j < BOARD_M + 1; j++)
             {
-                if (game->ways[i - MAP_PADDING - 1][j - 1] == '0')
+                if (lane_cell(game, i - MAP_PADDING - 1, j - 1) == '0')
                     MVADDCH(i, j, ' ');
                 else
                     MVADDCH(i, j, ']');
@@ -121,18 +121,21 @@ void on_moving_state(signals sig, frog_state *state, board_t *map, player_pos *f
         case ESCAPE_BTN:
             *state = EXIT_STATE;
             break;
+        case TICK:
+            *state = SHIFTING;
+            break;
         default:
             break;
     }
     
-    if (*state != EXIT_STATE)
+    if (*state == MOVING)
     {
         if (check_collide(frog_pos, map))
             *state = COLLIDE;
         else if (check_finish_state(frog_pos, map))
             *state = REACH;
         else
-            *state = SHIFTING;
+            PRINT_FROG(frog_pos->x, frog_pos->y);
     }
 }
 
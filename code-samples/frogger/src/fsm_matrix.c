@@ -36,16 +36,17 @@ void collide(params_t *prms);
 void gameover(params_t *prms);
 void exitstate(params_t *prms);
 void check(params_t *prms);
-
-action fsm_table[8][7] = {
-    {NULL, NULL, NULL, NULL, exitstate, spawn, NULL},
-    {spawn, spawn, spawn, spawn, spawn, spawn, spawn},
-    {moveup, movedown, moveright, moveleft, exitstate, check, check},
-    {shifting, shifting, shifting, shifting, shifting, shifting, shifting},
-    {reach, reach, reach, reach, reach, reach, reach},
-    {collide, collide, collide, collide, collide, collide, collide},
-    {gameover, gameover, gameover, gameover, gameover, gameover, gameover},
-    {exitstate, exitstate, exitstate, exitstate, exitstate, exitstate, exitstate}
+void tick(params_t *prms);
+
+action fsm_table[8][8] = {
+    {NULL, NULL, NULL, NULL, exitstate, spawn, NULL, NULL},
+    {spawn, spawn, spawn, spawn, spawn, spawn, spawn, spawn},
+    {moveup, movedown, moveright, moveleft, exitstate, check, tick, check},
+    {shifting, shifting, shifting, shifting, shifting, shifting, shifting, shifting},
+    {reach, reach, reach, reach, reach, reach, reach, reach},
+    {collide, collide, collide, collide, collide, collide, collide, collide},
+    {gameover, gameover, gameover, gameover, gameover, gameover, gameover, gameover},
+    {exitstate, exitstate, exitstate, exitstate, exitstate, exitstate, exitstate, exitstate}
 };
 
 void sigact(signals sig, frog_state *state, game_stats_t *stats, board_t *map, player_pos *frog_pos)
@@ -105,7 +106,15 @@ void check(params_t *prms)
     else if (check_finish_state(prms->frog_pos, prms->map))
         *prms->state = REACH;
     else
-        *prms->state = SHIFTING;
+    {
+        *prms->state = MOVING;
+        PRINT_FROG(prms->frog_pos->x, prms->frog_pos->y);
+    }
+}
+
+void tick(params_t *prms)
+{
+    *prms->state = SHIFTING;
 }
 
 void spawn(params_t *prms)
@@ -0,0 +1,414 @@
+#define _POSIX_C_SOURCE 200809L
+#include "ansi_view.h"
+#include "loop_stats.h"
+#include "tetris_pieces.h"
+#include <errno.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+// A cell is a character in the low byte and an attribute above it.
+// Characters below 0x20 stand for the block glyphs.
+#define GLYPH_UPPER 1
+#define GLYPH_LOWER 2
+#define GLYPH_FULL 3
+#define CELL(ch, attr) ((uint32_t)(ch) | (uint32_t)(attr) << 8)
+#define CELL_BLANK CELL(' ', 0)
+
+// Attribute: foreground and background terminal colour (0-15) + 1, where 0
+// is the terminal default, and bold
+#define FG(color) ((color) + 1)
+#define BG(color) (((color) + 1) << 5)
+#define ATTR_FG_MASK 0x1f
+#define ATTR_BG_MASK (0x1f << 5)
+#define ATTR_BOLD (1 << 10)
+#define ATTR_BORDER FG(3)
+#define ATTR_TEXT FG(2)
+
+// Unchanged cells shorter than this between two changes are resent rather
+// than paying for another cursor move
+#define RUN_GAP_MAX 2
+
+// Worst case per cell: a cursor move, an attribute change and a 3-byte glyph
+#define CUP_MAX 8   // ESC [ rr ; cc H
+#define SGR_MAX 13  // ESC [ 0 ; 1 ; 9 f ; 1 0 b m
+#define OUT_CAPACITY (ANSI_ROWS * ANSI_COLS * (CUP_MAX + SGR_MAX + 3))
+
+// Field and panels, in canvas coordinates
+#define FIELD_LINES ((BOARD_HEIGHT + 1) / 2)
+#define FIELD_Y 2
+#define FIELD_X 2
+#define INFO_X (FIELD_X + BOARD_WIDTH + 3)
+#define QUEUE_X (INFO_X + 14)
+
+static uint32_t canvas[ANSI_ROWS][ANSI_COLS];  // frame being painted
+static uint32_t screen[ANSI_ROWS][ANSI_COLS];  // what the terminal shows
+static char out[OUT_CAPACITY];
+static int out_fd = -1;
+static int screen_attr;
+
+static struct termios saved_termios;
+static bool termios_saved = false;
+static unsigned char pending[64];
+static int pending_len;
+static uint64_t partial_since_ns;  // when pending began with a partial sequence
+
+void ansi_view_open(int fd) {
+    static const char reset[] = "\x1b[0m\x1b[2J";
+
+    out_fd = fd;
+    for (int y = 0; y < ANSI_ROWS; y++) {
+        for (int x = 0; x < ANSI_COLS; x++) {
+            screen[y][x] = CELL_BLANK;
+        }
+    }
+    screen_attr = 0;
+    if (write(fd, reset, sizeof(reset) - 1) < 0) {
+        out_fd = -1;
+    }
+}
+
+void ansi_view_close(void) {
+    out_fd = -1;
+}
+
+static void canvas_clear(void) {
+    for (int y = 0; y < ANSI_ROWS; y++) {
+        for (int x = 0; x < ANSI_COLS; x++) {
+            canvas[y][x] = CELL_BLANK;
+        }
+    }
+}
+
+static void paint_text(int y, int x, int attr, const char *text) {
+    for (; *text && x < ANSI_COLS; text++, x++) {
+        canvas[y][x] = CELL(*text, attr);
+    }
+}
+
+static void paint_number(int y, int x, int attr, int value) {
+    char digits[12];
+    int n = 0;
+    unsigned v = value < 0 ? 0u - (unsigned)value : (unsigned)value;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0) digits[n++] = '-';
+
+    while (n > 0 && x < ANSI_COLS) {
+        canvas[y][x++] = CELL(digits[--n], attr);
+    }
+}
+
+// Two vertically stacked cells as one glyph; colours are terminal colours,
+// -1 for an empty cell. Differing halves use the background for the lower.
+static uint32_t half_block(int upper, int lower) {
+    if (upper < 0 && lower < 0) return CELL_BLANK;
+    if (lower < 0) return CELL(GLYPH_UPPER, FG(upper));
+    if (upper < 0) return CELL(GLYPH_LOWER, FG(lower));
+    if (upper == lower) return CELL(GLYPH_FULL, FG(upper));
+    return CELL(GLYPH_UPPER, FG(upper) | BG(lower));
+}
+
+static int field_cell_color(const GameInfo_t *info, const uint64_t *colors, int x, int y) {
+    if (y >= BOARD_HEIGHT || !info->field[y][x]) return -1;
+    return colors ? cell_palette_color(frame_cell_color(colors, x, y)) : 7;
+}
+
+static void paint_border(void) {
+    int top = FIELD_Y - 1;
+    int bottom = FIELD_Y + FIELD_LINES;
+    int left = FIELD_X - 1;
+    int right = FIELD_X + BOARD_WIDTH;
+
+    for (int x = left; x <= right; x++) {
+        canvas[top][x] = CELL('-', ATTR_BORDER);
+        canvas[bottom][x] = CELL('-', ATTR_BORDER);
+    }
+    for (int y = FIELD_Y; y < bottom; y++) {
+        canvas[y][left] = CELL('|', ATTR_BORDER);
+        canvas[y][right] = CELL('|', ATTR_BORDER);
+    }
+    canvas[top][left] = canvas[top][right] = CELL('+', ATTR_BORDER);
+    canvas[bottom][left] = canvas[bottom][right] = CELL('+', ATTR_BORDER);
+}
+
+static void paint_field(const GameInfo_t *info, const uint64_t *colors) {
+    for (int line = 0; line < FIELD_LINES; line++) {
+        for (int x = 0; x < BOARD_WIDTH; x++) {
+            canvas[FIELD_Y + line][FIELD_X + x] =
+                half_block(field_cell_color(info, colors, x, 2 * line),
+                           field_cell_color(info, colors, x, 2 * line + 1));
+        }
+    }
+}
+
+// Spawn orientation fills template rows 1 and 2, so a preview is one line
+static void paint_piece_preview(int y, int x, int type) {
+    int color = cell_palette_color(type);
+    for (int i = 0; i < PIECE_SIZE; i++) {
+        canvas[y][x + i] = half_block(piece_templates[type][0][1][i] ? color : -1,
+                                      piece_templates[type][0][2][i] ? color : -1);
+    }
+}
+
+static void paint_info(const GameInfo_t *info, bool pieces, int next_type) {
+    const PanelLabels_t *labels = panel_labels();
+    paint_text(FIELD_Y, INFO_X, ATTR_TEXT, labels->title);
+    paint_text(FIELD_Y + 2, INFO_X, ATTR_TEXT, "Score:");
+    paint_number(FIELD_Y + 2, INFO_X + 7, ATTR_TEXT, info->score);
+    paint_text(FIELD_Y + 3, INFO_X, ATTR_TEXT, "High:");
+    paint_number(FIELD_Y + 3, INFO_X + 7, ATTR_TEXT, info->high_score);
+    paint_text(FIELD_Y + 4, INFO_X, ATTR_TEXT, "Level:");
+    paint_number(FIELD_Y + 4, INFO_X + 7, ATTR_TEXT, info->level);
+    paint_text(FIELD_Y + 5, INFO_X, ATTR_TEXT, labels->speed);
+    paint_text(FIELD_Y + 5, INFO_X + (int)strlen(labels->speed), ATTR_TEXT, ":");
+    paint_number(FIELD_Y + 5, INFO_X + 7, ATTR_TEXT, info->speed);
+
+    if (pieces) paint_text(FIELD_Y + 7, INFO_X, ATTR_TEXT, "Next:");
+    if (pieces && info->next) {
+        int color = next_type >= 0 ? cell_palette_color(next_type) : 6;
+        for (int i = 0; i < PIECE_SIZE; i++) {
+            canvas[FIELD_Y + 8][INFO_X + i] =
+                half_block(info->next[1][i] ? color : -1, info->next[2][i] ? color : -1);
+        }
+    }
+
+    for (int i = 0; labels->controls[i]; i++) {
+        paint_text(FIELD_Y + 10 + i, INFO_X, ATTR_TEXT, labels->controls[i]);
+    }
+}
+
+static void paint_queue(const QueueView_t *queue) {
+    paint_text(FIELD_Y, QUEUE_X, ATTR_TEXT, "Hold:");
+    if (queue->hold >= 0) {
+        paint_piece_preview(FIELD_Y + 1, QUEUE_X, queue->hold);
+    }
+    if (queue->count > 1) {
+        paint_text(FIELD_Y + 3, QUEUE_X, ATTR_TEXT, "Then:");
+    }
+    // The first entry is already shown as the next piece
+    for (int i = 1; i < queue->count; i++) {
+        paint_piece_preview(FIELD_Y + 4 + (i - 1) * 2, QUEUE_X, queue->types[i]);
+    }
+}
+
+static void paint_pause(void) {
+    int y = FIELD_Y + FIELD_LINES / 2 - 1;
+    paint_text(y, FIELD_X + (BOARD_WIDTH - 6) / 2, ATTR_TEXT | ATTR_BOLD, "PAUSED");
+    paint_text(y + 1, FIELD_X + (BOARD_WIDTH - 9) / 2, ATTR_TEXT | ATTR_BOLD, "P: resume");
+}
+
+static char *put_number(char *p, int value) {
+    if (value >= 10) *p++ = (char)('0' + value / 10);
+    *p++ = (char)('0' + value % 10);
+    return p;
+}
+
+static char *put_cursor(char *p, int y, int x) {
+    *p++ = '\x1b';
+    *p++ = '[';
+    p = put_number(p, y + 1);
+    *p++ = ';';
+    p = put_number(p, x + 1);
+    *p++ = 'H';
+    return p;
+}
+
+// SGR colour parameter: 3x/4x for the first eight colours, 9x/10x for the
+// bright ones
+static char *put_color(char *p, int color, bool background) {
+    *p++ = ';';
+    if (color < 8) {
+        *p++ = background ? '4' : '3';
+    } else {
+        color -= 8;
+        if (background) {
+            *p++ = '1';
+            *p++ = '0';
+        } else {
+            *p++ = '9';
+        }
+    }
+    *p++ = (char)('0' + color);
+    return p;
+}
+
+static char *put_attr(char *p, int attr) {
+    *p++ = '\x1b';
+    *p++ = '[';
+    *p++ = '0';
+    if (attr & ATTR_BOLD) {
+        memcpy(p, ";1", 2);
+        p += 2;
+    }
+    if (attr & ATTR_FG_MASK) {
+        p = put_color(p, (attr & ATTR_FG_MASK) - 1, false);
+    }
+    if (attr & ATTR_BG_MASK) {
+        p = put_color(p, ((attr & ATTR_BG_MASK) >> 5) - 1, true);
+    }
+    *p++ = 'm';
+    return p;
+}
+
+static char *put_cell(char *p, uint32_t cell) {
+    // Foreground and bold do not show on a space, so blanks keep the current
+    // attribute unless it has a background
+    int attr = (int)(cell >> 8);
+    unsigned ch = cell & 0xff;
+    if (attr != screen_attr && (ch != ' ' || (screen_attr & ATTR_BG_MASK))) {
+        p = put_attr(p, attr);
+        screen_attr = attr;
+    }
+
+    // U+2580 upper half, U+2584 lower half, U+2588 full block
+    static const char glyph_tail[] = {0, '\x80', '\x84', '\x88'};
+    if (ch < ' ') {
+        *p++ = '\xe2';
+        *p++ = '\x96';
+        *p++ = glyph_tail[ch];
+    } else {
+        *p++ = (char)ch;
+    }
+    return p;
+}
+
+static void flush_output(const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(out_fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+}
+
+// Sends the cells that differ from the screen and makes them the screen
+static void present(void) {
+    if (out_fd < 0) return;
+
+    char *p = out;
+    for (int y = 0; y < ANSI_ROWS; y++) {
+        const uint32_t *row = canvas[y];
+        uint32_t *shown = screen[y];
+        int x = 0;
+        while (x < ANSI_COLS) {
+            if (row[x] == shown[x]) {
+                x++;
+                continue;
+            }
+
+            // Extend the run over short gaps up to its last changed cell
+            int end = x + 1;
+            for (int i = end; i < ANSI_COLS && i <= end + RUN_GAP_MAX; i++) {
+                if (row[i] != shown[i]) end = i + 1;
+            }
+
+            p = put_cursor(p, y, x);
+            for (; x < end; x++) {
+                p = put_cell(p, row[x]);
+                shown[x] = row[x];
+            }
+        }
+    }
+
+    if (p != out) {
+        flush_output(out, (size_t)(p - out));
+    }
+}
+
+static void ansi_draw_game(const GameInfo_t *info, const QueueView_t *queue,
+                           const uint64_t *colors) {
+    if (!info || !info->field) return;
+
+    canvas_clear();
+    paint_border();
+    paint_field(info, colors);
+    bool pieces = queue_has_pieces(queue);
+    paint_info(info, pieces, queue && queue->count ? queue->types[0] : -1);
+    if (queue && pieces) {
+        paint_queue(queue);
+    }
+    if (info->pause) {
+        paint_pause();
+    }
+    present();
+}
+
+static void ansi_show_instructions(void) {
+    const char *const *help = panel_labels()->help;
+
+    canvas_clear();
+    for (int i = 0; help[i]; i++) {
+        paint_text(2 + i, 2, ATTR_TEXT, help[i]);
+    }
+    present();
+}
+
+static UserAction_t ansi_get_input(void) {
+    if (pending_len < (int)sizeof(pending)) {
+        ssize_t n = read(STDIN_FILENO, pending + pending_len, sizeof(pending) - pending_len);
+        if (n > 0) pending_len += (int)n;
+    }
+    if (pending_len == 0) return -1;
+
+    // Hold a cut-off escape sequence until the rest arrives or ESC_WAIT_MS
+    // passes, so half an arrow key is not read as ESC
+    int used;
+    int key = decode_key(pending, pending_len, false, &used);
+    if (key == KEY_PARTIAL) {
+        uint64_t now = loop_now_ns();
+        if (!partial_since_ns) partial_since_ns = now;
+        if (now - partial_since_ns < ESC_WAIT_MS * 1000000ull) return -1;
+        key = decode_key(pending, pending_len, true, &used);
+    }
+    partial_since_ns = 0;
+    pending_len -= used;
+    memmove(pending, pending + used, (size_t)pending_len);
+    return map_key(key);
+}
+
+static bool ansi_init(void) {
+    // Unbuffered keys without echo; reads return at once when none is waiting
+    if (tcgetattr(STDIN_FILENO, &saved_termios) == 0) {
+        struct termios raw = saved_termios;
+        raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+        raw.c_cc[VMIN] = 0;
+        raw.c_cc[VTIME] = 0;
+        termios_saved = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+    }
+    pending_len = 0;
+    partial_since_ns = 0;
+
+    // Alternate screen, cursor hidden
+    static const char enter[] = "\x1b[?1049h\x1b[?25l";
+    out_fd = STDOUT_FILENO;
+    flush_output(enter, sizeof(enter) - 1);
+    ansi_view_open(STDOUT_FILENO);
+    return out_fd >= 0;
+}
+
+static void ansi_cleanup(void) {
+    static const char leave[] = "\x1b[0m\x1b[?25h\x1b[?1049l";
+    if (out_fd >= 0) {
+        flush_output(leave, sizeof(leave) - 1);
+    }
+    ansi_view_close();
+    if (termios_saved) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+        termios_saved = false;
+    }
+}
+
+const RenderBackend_t ansi_backend = {
+    .name = "ansi",
+    .init = ansi_init,
+    .cleanup = ansi_cleanup,
+    .get_input = ansi_get_input,
+    .draw_game = ansi_draw_game,
+    .show_instructions = ansi_show_instructions,
+};
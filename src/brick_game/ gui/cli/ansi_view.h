@@ -0,0 +1,24 @@
+#ifndef ANSI_VIEW_H
+#define ANSI_VIEW_H
+
+#include <stdbool.h>
+#include "gui.h"
+
+// Canvas the ANSI backend paints each frame; the terminal needs at least
+// this many lines and columns
+#define ANSI_ROWS 25
+#define ANSI_COLS 64
+
+// Direct ANSI backend. Each frame is painted into a cell canvas, diffed
+// against what the terminal already shows, and the changed cells go out as
+// cursor-addressed runs in a single write(2). The field uses half-block
+// glyphs, two board rows per terminal line.
+extern const RenderBackend_t ansi_backend;
+
+// Starts rendering to fd with an assumed blank screen and leaves terminal
+// modes alone; ansi_backend.init calls this for stdout after switching the
+// terminal over
+void ansi_view_open(int fd);
+void ansi_view_close(void);
+
+#endif  // ANSI_VIEW_H
@@ -0,0 +1,41 @@
+#include "game_loop.h"
+#include <stdatomic.h>
+
+static atomic_bool running = true;
+
+void stop_game_loop(void) {
+    atomic_store(&running, false);
+}
+
+bool game_loop_running(void) {
+    return atomic_load(&running);
+}
+
+void input_state_init(InputState_t *state) {
+    state->game_started = false;
+    state->hold_key = false;
+    state->last_action = -1;
+    state->hold_counter = 0;
+}
+
+bool track_input(InputState_t *state, UserAction_t action) {
+    // Handle key holding for movement
+    if (action == state->last_action && (action == Left || action == Right || action == Down)) {
+        state->hold_counter++;
+        if (state->hold_counter > 5) {  // Start holding after 5 frames
+            state->hold_key = true;
+        }
+    } else {
+        state->hold_counter = 0;
+        state->hold_key = false;
+    }
+    
+    if ((int)action != -1) {
+        state->last_action = action;
+        if (action == Start) {
+            state->game_started = true;
+        }
+    }
+    
+    return state->hold_key;
+}
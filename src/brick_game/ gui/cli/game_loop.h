@@ -0,0 +1,28 @@
+#ifndef GAME_LOOP_H
+#define GAME_LOOP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris.h"
+#include "gui.h"
+#include "loop_stats.h"
+
+#define FRAME_NS 16666667ull  // 60 FPS
+
+// Key-hold tracking shared by the runtime loops
+typedef struct {
+    bool game_started;
+    bool hold_key;
+    UserAction_t last_action;
+    int hold_counter;
+} InputState_t;
+
+void input_state_init(InputState_t *state);
+// Hold tracking for one polled action (-1 for none); returns the hold flag
+// to send with it
+bool track_input(InputState_t *state, UserAction_t action);
+
+void stop_game_loop(void);
+bool game_loop_running(void);
+
+#endif  // GAME_LOOP_H
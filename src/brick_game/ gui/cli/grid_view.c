@@ -0,0 +1,203 @@
+#define _POSIX_C_SOURCE 200809L
+#include "grid_view.h"
+#include "game_loop.h"
+#include "gui.h"
+#include "tetris_bot.h"
+#include "tetris_frame.h"
+#include "tetris_fsm.h"
+#include "tetris_pieces.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct {
+    TetrisGame_t game;
+    Bot_t bot;
+    FrameExport_t frames;
+    int tile_y;
+    int tile_x;
+    bool visible;
+    int shown_score;
+    int shown_games;
+    int games_played;
+    long pieces_finished;  // pieces from earlier games, which a restart forgets
+} GridBoard_t;
+
+void grid_default_options(GridOptions_t *options) {
+    options->games = 8;
+    options->actions_per_frame = 1;
+    options->refresh_interval = 2;
+    options->uncapped = false;
+    options->duration = 0.0;
+}
+
+static int visible_tiles(void) {
+    return (COLS / GRID_TILE_WIDTH) * (LINES / GRID_TILE_HEIGHT);
+}
+
+static void draw_tile_border(const GridBoard_t *board) {
+    int top = board->tile_y;
+    int left = board->tile_x;
+    int bottom = top + BOARD_HEIGHT + 1;
+    int right = left + BOARD_WIDTH + 1;
+
+    attron(COLOR_PAIR(COLOR_BORDER));
+    mvhline(top, left + 1, '-', BOARD_WIDTH);
+    mvhline(bottom, left + 1, '-', BOARD_WIDTH);
+    mvvline(top + 1, left, '|', BOARD_HEIGHT);
+    mvvline(top + 1, right, '|', BOARD_HEIGHT);
+    mvaddch(top, left, '+');
+    mvaddch(top, right, '+');
+    mvaddch(bottom, left, '+');
+    mvaddch(bottom, right, '+');
+    attroff(COLOR_PAIR(COLOR_BORDER));
+}
+
+// Static parts are drawn once; exporters restart so the next delta is complete
+static void layout_boards(GridBoard_t *boards, int count) {
+    int columns = COLS / GRID_TILE_WIDTH;
+    int shown = visible_tiles();
+
+    clear();
+    for (int i = 0; i < count; i++) {
+        GridBoard_t *board = &boards[i];
+        board->visible = columns > 0 && i < shown;
+        if (!board->visible) continue;
+
+        board->tile_y = (i / columns) * GRID_TILE_HEIGHT;
+        board->tile_x = (i % columns) * GRID_TILE_WIDTH;
+        board->shown_score = -1;
+        frame_export_free(&board->frames);
+        frame_export_init(&board->frames, BOARD_WIDTH, BOARD_HEIGHT);
+        draw_tile_border(board);
+    }
+}
+
+// Only cells that changed since this board's last repaint are touched
+static void paint_board(GridBoard_t *board) {
+    const FrameView_t *view = frame_export(&board->frames, &board->game);
+    if (!view) return;
+
+    if (view->change_count) {
+        attron(COLOR_PAIR(COLOR_FIELD));
+        for (int i = 0; i < view->change_count; i++) {
+            const CellChange_t *change = &view->changes[i];
+            mvaddch(board->tile_y + 1 + change->y, board->tile_x + 1 + change->x,
+                    change->filled ? ACS_CKBOARD : ' ');
+        }
+        attroff(COLOR_PAIR(COLOR_FIELD));
+    }
+
+    if (view->score != board->shown_score || board->games_played != board->shown_games) {
+        board->shown_score = view->score;
+        board->shown_games = board->games_played;
+        attron(COLOR_PAIR(COLOR_TEXT));
+        mvprintw(board->tile_y + BOARD_HEIGHT + 2, board->tile_x, "%-*.*s",
+                 GRID_TILE_WIDTH - 1, GRID_TILE_WIDTH - 1, "");
+        mvprintw(board->tile_y + BOARD_HEIGHT + 2, board->tile_x, "%d#%d",
+                 view->score, board->games_played);
+        attroff(COLOR_PAIR(COLOR_TEXT));
+    }
+}
+
+static void step_board(GridBoard_t *board, int actions) {
+    for (int i = 0; i < actions; i++) {
+        if (!bot_play(&board->bot, &board->game)) {
+            // Game over: back to the start screen, the bot starts again
+            board->pieces_finished += board->game.pieces_spawned;
+            fsm_process_action(&board->game, Start, false);
+            board->games_played++;
+        }
+    }
+}
+
+static void sleep_until(struct timespec *deadline) {
+    deadline->tv_nsec += (long)FRAME_NS;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_nsec -= 1000000000L;
+        deadline->tv_sec++;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL);
+}
+
+static void free_boards(GridBoard_t *boards, int count) {
+    for (int i = 0; i < count; i++) {
+        frame_export_free(&boards[i].frames);
+        bot_free(&boards[i].bot);
+        game_destroy(&boards[i].game);
+    }
+    free(boards);
+}
+
+bool grid_loop(const GridOptions_t *options, LoopMetrics_t *metrics, GridReport_t *report) {
+    int count = options->games;
+    GridBoard_t *boards = calloc(count, sizeof(GridBoard_t));
+    if (!boards) return false;
+
+    for (int i = 0; i < count; i++) {
+        if (!game_init(&boards[i].game, BOARD_WIDTH, BOARD_HEIGHT) ||
+            !bot_init(&boards[i].bot, &boards[i].game, NULL)) {
+            free_boards(boards, count);
+            return false;
+        }
+        seed_piece_generator(&boards[i].game, (uint64_t)i + 1);
+    }
+    layout_boards(boards, count);
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    uint64_t start_ns = loop_now_ns();
+    uint64_t last_frame_ns = start_ns;
+    uint64_t frames = 0;
+    int interval = options->refresh_interval > 0 ? options->refresh_interval : 1;
+
+    while (game_loop_running()) {
+        int ch = getch();
+        if (ch == 'q' || ch == 'Q') break;
+        if (ch == KEY_RESIZE) layout_boards(boards, count);
+
+        for (int i = 0; i < count; i++) {
+            step_board(&boards[i], options->actions_per_frame);
+        }
+
+        // Staggered repaints, then a single terminal update for all boards
+        for (int i = 0; i < count; i++) {
+            if (boards[i].visible && (frames + i) % interval == 0) {
+                paint_board(&boards[i]);
+            }
+        }
+        refresh();
+        frames++;
+
+        uint64_t frame_ns = loop_now_ns();
+        loop_stats_add(&metrics->frame_time, frame_ns - last_frame_ns);
+        last_frame_ns = frame_ns;
+
+        if (options->duration > 0 && (frame_ns - start_ns) / 1e9 >= options->duration) break;
+        if (!options->uncapped) sleep_until(&deadline);
+    }
+
+    report->games = count;
+    report->shown = visible_tiles() < count ? visible_tiles() : count;
+    report->columns = COLS;
+    report->lines = LINES;
+    report->seconds = (loop_now_ns() - start_ns) / 1e9;
+    report->frames_per_second = frames / report->seconds;
+    report->actions_per_second =
+        (double)frames * count * options->actions_per_frame / report->seconds;
+    report->pieces = 0;
+    for (int i = 0; i < count; i++) {
+        report->pieces += boards[i].pieces_finished + boards[i].game.pieces_spawned;
+    }
+
+    free_boards(boards, count);
+    return true;
+}
+
+void grid_print_report(const GridReport_t *report) {
+    printf("grid: %d games, %d shown on a %dx%d terminal\n",
+           report->games, report->shown, report->columns, report->lines);
+    printf("grid: %.1f frames/s over %.1fs, %.0f bot actions/s, %.0f pieces/s\n",
+           report->frames_per_second, report->seconds, report->actions_per_second,
+           report->pieces / report->seconds);
+}
@@ -0,0 +1,35 @@
+#ifndef GRID_VIEW_H
+#define GRID_VIEW_H
+
+#include <stdbool.h>
+#include "loop_stats.h"
+
+// Compact tile: border, one column per cell, border, plus a stats line
+#define GRID_TILE_WIDTH (BOARD_WIDTH + 3)
+#define GRID_TILE_HEIGHT (BOARD_HEIGHT + 3)
+
+typedef struct {
+    int games;              // concurrent bot games
+    int actions_per_frame;  // bot actions per game per frame
+    int refresh_interval;   // frames between repaints of one board
+    bool uncapped;          // render as fast as possible instead of 60 FPS
+    double duration;        // seconds to run, 0 for until Q
+} GridOptions_t;
+
+// Sustained throughput of one wallboard run
+typedef struct {
+    int games;
+    int shown;
+    int columns;
+    int lines;
+    double seconds;
+    double frames_per_second;
+    double actions_per_second;
+    long pieces;
+} GridReport_t;
+
+void grid_default_options(GridOptions_t *options);
+bool grid_loop(const GridOptions_t *options, LoopMetrics_t *metrics, GridReport_t *report);
+void grid_print_report(const GridReport_t *report);
+
+#endif  // GRID_VIEW_H
@@ -1,9 +1,15 @@
 #include "gui.h"
+#include "tetris_game.h"
+#include "tetris_pieces.h"
 #include <string.h>
 #include <unistd.h>
 
 void init_gui(void) {
     initscr();
+    configure_gui();
+}
+
+void configure_gui(void) {
     cbreak();
     noecho();
     keypad(stdscr, TRUE);
@@ -17,123 +23,324 @@ void init_gui(void) {
         init_pair(COLOR_BORDER, COLOR_YELLOW, COLOR_BLACK);
         init_pair(COLOR_TEXT, COLOR_GREEN, COLOR_BLACK);
         init_pair(COLOR_PIECE, COLOR_CYAN, COLOR_BLACK);
+        for (int color = 0; color <= CELL_GARBAGE; color++) {
+            short fg = (short)cell_palette_color(color);
+            init_pair(COLOR_CELL(color), fg < COLORS ? fg : fg & 7, COLOR_BLACK);
+        }
     }
     
     clear();
     refresh();
 }
 
+int cell_palette_color(int color) {
+    // I cyan, O bright yellow, T magenta, S green, Z red, J blue, L yellow
+    // (orange on most palettes), garbage grey
+    static const int palette[CELL_GARBAGE + 1] = {6, 11, 5, 2, 1, 4, 3, 8};
+    return color >= 0 && color <= CELL_GARBAGE ? palette[color] : 7;
+}
+
+static void delete_windows(void);
+
 void cleanup_gui(void) {
+    delete_windows();
     endwin();
 }
 
-void draw_game(const GameInfo_t *info) {
-    if (!info) return;
+static bool ncurses_init(void) {
+    init_gui();
+    return true;
+}
+
+const RenderBackend_t ncurses_backend = {
+    .name = "ncurses",
+    .init = ncurses_init,
+    .cleanup = cleanup_gui,
+    .get_input = get_user_input,
+    .draw_game = draw_game,
+    .show_instructions = show_instructions,
+};
+
+// Screen regions as separate windows. The border and controls are drawn
+// once per layout; the others are redrawn only when what they show changed,
+// and a frame flushes just those with one doupdate().
+typedef struct {
+    WINDOW *border;
+    WINDOW *field;
+    WINDOW *stats;
+    WINDOW *next;
+    WINDOW *queue;
+    WINDOW *controls;
+    WINDOW *overlay;
+    bool laid_out;  // static windows are on screen and the caches below valid
+    uint64_t rows[BOARD_HEIGHT];
+    uint64_t colors[BOARD_HEIGHT * COLOR_PLANES];
+    bool colored;
+    int stats_values[4];
+    int next_type;
+    uint8_t queue_types[PREVIEW_MAX];
+    int queue_count;
+    int hold;
+    bool paused;
+} GameWindows_t;
+
+static GameWindows_t windows;
+static PanelLabels_t labels;  // filled from tetris_game_vtable on first use
+
+void set_panel_labels(const GameVtable_t *game) {
+    if (!game) game = &tetris_game_vtable;
+    labels = (PanelLabels_t){game->title, game->speed_label, game->controls, game->help};
+    windows.laid_out = false;
+}
+
+const PanelLabels_t *panel_labels(void) {
+    if (!labels.title) set_panel_labels(NULL);
+    return &labels;
+}
+
+bool queue_has_pieces(const QueueView_t *queue) {
+    return !queue || queue->hold >= 0 || queue->count > 0;
+}
+
+#define STATS_ROWS 6
+#define NEXT_ROWS (PIECE_SIZE + 1)
+#define QUEUE_ROWS (5 + (PREVIEW_MAX - 1) * QUEUE_ENTRY_ROWS)
+#define CONTROLS_ROWS 8
+#define PANEL_COLS 14
+#define OVERLAY_COLS 19
+
+static void delete_windows(void) {
+    WINDOW **all[] = {&windows.border, &windows.field, &windows.stats, &windows.next,
+                      &windows.queue, &windows.controls, &windows.overlay};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) {
+        if (*all[i]) delwin(*all[i]);
+        *all[i] = NULL;
+    }
+    windows.laid_out = false;
+}
+
+static bool create_windows(void) {
+    windows.border = newwin(BOARD_HEIGHT + 2, BOARD_WIDTH * 2 + 2, FIELD_START_Y - 1,
+                            FIELD_START_X - 1);
+    windows.field = newwin(BOARD_HEIGHT, BOARD_WIDTH * 2, FIELD_START_Y, FIELD_START_X);
+    windows.stats = newwin(STATS_ROWS, PANEL_COLS, FIELD_START_Y, INFO_PANEL_X);
+    windows.next = newwin(NEXT_ROWS, PANEL_COLS, NEXT_PIECE_Y - 1, INFO_PANEL_X);
+    windows.queue = newwin(QUEUE_ROWS, PIECE_SIZE * 2 + 2, FIELD_START_Y, QUEUE_PANEL_X);
+    windows.controls = newwin(CONTROLS_ROWS, PANEL_COLS, FIELD_START_Y + 12, INFO_PANEL_X);
+    windows.overlay = newwin(2, OVERLAY_COLS, FIELD_START_Y + BOARD_HEIGHT / 2 - 1,
+                             FIELD_START_X + BOARD_WIDTH - (OVERLAY_COLS + 1) / 2);
+
+    if (!windows.border || !windows.field || !windows.stats || !windows.next ||
+        !windows.queue || !windows.controls || !windows.overlay) {
+        delete_windows();
+        return false;
+    }
+    return true;
+}
+
+// Wipes whatever stdscr showed and puts the static windows up
+static void draw_layout(void) {
+    werase(stdscr);
+    wnoutrefresh(stdscr);
+    
+    wattron(windows.border, COLOR_PAIR(COLOR_BORDER));
+    wborder(windows.border, '|', '|', '-', '-', '+', '+', '+', '+');
+    wattroff(windows.border, COLOR_PAIR(COLOR_BORDER));
+    wnoutrefresh(windows.border);
+    
+    const char *const *controls = panel_labels()->controls;
+    werase(windows.controls);
+    wattron(windows.controls, COLOR_PAIR(COLOR_TEXT));
+    for (int i = 0; i < CONTROLS_ROWS && controls[i]; i++) {
+        mvwaddstr(windows.controls, i, 0, controls[i]);
+    }
+    wattroff(windows.controls, COLOR_PAIR(COLOR_TEXT));
+    wnoutrefresh(windows.controls);
+}
+
+void draw_game(const GameInfo_t *info, const QueueView_t *queue, const uint64_t *colors) {
+    if (!info || !info->field) return;
+    if (!windows.field && !create_windows()) return;
     
-    clear();
+    bool all = !windows.laid_out;
+    if (all) {
+        draw_layout();
+        windows.laid_out = true;
+    }
     
-    draw_border();
-    draw_field(info);
-    draw_info_panel(info);
-    draw_next_piece(info);
+    bool field_changed = draw_field(info, colors, all);
+    draw_info_panel(info, all);
+    if (queue_has_pieces(queue)) {
+        draw_next_piece(info, queue && queue->count ? queue->types[0] : -1, all);
+        draw_queue(queue, all);
+    }
     
-    if (info->pause) {
+    // The overlay sits on the field: redraw it over a changed field, and
+    // uncover the field when it goes away
+    bool paused = info->pause != 0;
+    if (paused && (all || field_changed || !windows.paused)) {
         draw_pause();
+    } else if (!paused && windows.paused && !all) {
+        touchwin(windows.field);
+        wnoutrefresh(windows.field);
     }
+    windows.paused = paused;
     
-    refresh();
+    doupdate();
 }
 
-void draw_field(const GameInfo_t *info) {
-    if (!info || !info->field) return;
-    
-    attron(COLOR_PAIR(COLOR_FIELD));
-    
+bool draw_field(const GameInfo_t *info, const uint64_t *colors, bool force) {
+    uint64_t rows[BOARD_HEIGHT];
     for (int y = 0; y < BOARD_HEIGHT; y++) {
+        rows[y] = 0;
         for (int x = 0; x < BOARD_WIDTH; x++) {
-            int screen_y = FIELD_START_Y + y;
-            int screen_x = FIELD_START_X + x * 2;
-            
-            if (info->field[y][x]) {
-                mvaddstr(screen_y, screen_x, "██");
-            } else {
-                mvaddstr(screen_y, screen_x, "  ");
-            }
+            rows[y] |= (uint64_t)(info->field[y][x] != 0) << x;
         }
     }
     
-    attroff(COLOR_PAIR(COLOR_FIELD));
-}
-
-void draw_border(void) {
-    attron(COLOR_PAIR(COLOR_BORDER));
-    
-    // Draw game field border
-    int field_width = BOARD_WIDTH * 2;
-    int field_height = BOARD_HEIGHT;
+    bool changed = force || memcmp(rows, windows.rows, sizeof(rows)) != 0 ||
+                   windows.colored != (colors != NULL) ||
+                   (colors && memcmp(colors, windows.colors, sizeof(windows.colors)) != 0);
+    if (!changed) return false;
     
-    // Top and bottom borders
-    for (int x = 0; x <= field_width + 1; x++) {
-        mvaddch(FIELD_START_Y - 1, FIELD_START_X + x - 1, '-');
-        mvaddch(FIELD_START_Y + field_height, FIELD_START_X + x - 1, '-');
+    memcpy(windows.rows, rows, sizeof(rows));
+    windows.colored = colors != NULL;
+    if (colors) {
+        memcpy(windows.colors, colors, sizeof(windows.colors));
     }
     
-    // Left and right borders
-    for (int y = 0; y < field_height; y++) {
-        mvaddch(FIELD_START_Y + y, FIELD_START_X - 1, '|');
-        mvaddch(FIELD_START_Y + y, FIELD_START_X + field_width, '|');
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        draw_field_row(windows.field, y, 0, BOARD_WIDTH, rows[y],
+                       colors ? colors + (size_t)y * COLOR_PLANES : NULL);
     }
-    
-    // Corners
-    mvaddch(FIELD_START_Y - 1, FIELD_START_X - 1, '+');
-    mvaddch(FIELD_START_Y - 1, FIELD_START_X + field_width, '+');
-    mvaddch(FIELD_START_Y + field_height, FIELD_START_X - 1, '+');
-    mvaddch(FIELD_START_Y + field_height, FIELD_START_X + field_width, '+');
-    
-    attroff(COLOR_PAIR(COLOR_BORDER));
+    wnoutrefresh(windows.field);
+    return true;
 }
 
-void draw_info_panel(const GameInfo_t *info) {
-    if (!info) return;
-    
-    attron(COLOR_PAIR(COLOR_TEXT));
-    
-    mvprintw(FIELD_START_Y, INFO_PANEL_X, "TETRIS");
-    mvprintw(FIELD_START_Y + 2, INFO_PANEL_X, "Score: %d", info->score);
-    mvprintw(FIELD_START_Y + 3, INFO_PANEL_X, "High:  %d", info->high_score);
-    mvprintw(FIELD_START_Y + 4, INFO_PANEL_X, "Level: %d", info->level);
-    mvprintw(FIELD_START_Y + 5, INFO_PANEL_X, "Speed: %d", info->speed);
-    
-    mvprintw(FIELD_START_Y + 7, INFO_PANEL_X, "Next:");
-    
-    // Controls
-    mvprintw(FIELD_START_Y + 12, INFO_PANEL_X, "Controls:");
-    mvprintw(FIELD_START_Y + 13, INFO_PANEL_X, "A/D - Move");
-    mvprintw(FIELD_START_Y + 14, INFO_PANEL_X, "S - Drop");
-    mvprintw(FIELD_START_Y + 15, INFO_PANEL_X, "W - Rotate");
-    mvprintw(FIELD_START_Y + 16, INFO_PANEL_X, "P - Pause");
-    mvprintw(FIELD_START_Y + 17, INFO_PANEL_X, "Q - Quit");
-    mvprintw(FIELD_START_Y + 18, INFO_PANEL_X, "R - Restart");
-    
-    attroff(COLOR_PAIR(COLOR_TEXT));
+// Colour pair a cell is drawn with, 0 when it is empty
+static int cell_pair(uint64_t row, const uint64_t *planes, int x) {
+    if (!((row >> x) & 1)) return 0;
+    if (!planes) return COLOR_FIELD;
+    
+    int color = 0;
+    for (int k = 0; k < COLOR_PLANES; k++) {
+        color |= (int)((planes[k] >> x) & 1) << k;
+    }
+    return COLOR_CELL(color);
 }
 
-void draw_next_piece(const GameInfo_t *info) {
-    if (!info || !info->next) return;
-    
-    attron(COLOR_PAIR(COLOR_PIECE));
-    
+void draw_field_row(WINDOW *win, int y, int x0, int width, uint64_t row,
+                    const uint64_t *planes) {
+    static const char block[] = "██";
+    char run[BOARD_MAX_WIDTH * (sizeof(block) - 1) + 1];
+    
+    int x = 0;
+    while (x < width) {
+        int pair = cell_pair(row, planes, x);
+        int end = x + 1;
+        while (end < width && cell_pair(row, planes, end) == pair) end++;
+        
+        char *p = run;
+        for (int i = x; i < end; i++) {
+            if (pair) {
+                memcpy(p, block, sizeof(block) - 1);
+                p += sizeof(block) - 1;
+            } else {
+                *p++ = ' ';
+                *p++ = ' ';
+            }
+        }
+        *p = '\0';
+        
+        wattron(win, COLOR_PAIR(pair ? pair : COLOR_FIELD));
+        mvwaddstr(win, y, x0 + x * 2, run);
+        wattroff(win, COLOR_PAIR(pair ? pair : COLOR_FIELD));
+        x = end;
+    }
+}
+
+void draw_info_panel(const GameInfo_t *info, bool force) {
+    int values[4] = {info->score, info->high_score, info->level, info->speed};
+    if (!force && memcmp(values, windows.stats_values, sizeof(values)) == 0) return;
+    memcpy(windows.stats_values, values, sizeof(values));
+    
+    WINDOW *win = windows.stats;
+    werase(win);
+    wattron(win, COLOR_PAIR(COLOR_TEXT));
+    mvwaddstr(win, 0, 0, panel_labels()->title);
+    mvwprintw(win, 2, 0, "Score: %d", info->score);
+    mvwprintw(win, 3, 0, "High:  %d", info->high_score);
+    mvwprintw(win, 4, 0, "Level: %d", info->level);
+    mvwprintw(win, 5, 0, "%s: %d", panel_labels()->speed, info->speed);
+    wattroff(win, COLOR_PAIR(COLOR_TEXT));
+    wnoutrefresh(win);
+}
+
+void draw_next_piece(const GameInfo_t *info, int type, bool force) {
+    if (!force && type == windows.next_type) return;
+    windows.next_type = type;
+    
+    WINDOW *win = windows.next;
+    werase(win);
+    wattron(win, COLOR_PAIR(COLOR_TEXT));
+    mvwaddstr(win, 0, 0, "Next:");
+    wattroff(win, COLOR_PAIR(COLOR_TEXT));
+    
+    if (info->next) {
+        int pair = type >= 0 ? COLOR_CELL(type) : COLOR_PIECE;
+        wattron(win, COLOR_PAIR(pair));
+        for (int y = 0; y < PIECE_SIZE; y++) {
+            for (int x = 0; x < PIECE_SIZE; x++) {
+                if (info->next[y][x]) {
+                    mvwaddstr(win, 1 + y, 2 + x * 2, "██");
+                }
+            }
+        }
+        wattroff(win, COLOR_PAIR(pair));
+    }
+    wnoutrefresh(win);
+}
+
+// Spawn orientation; its cells sit in template rows 1 and 2
+void draw_piece_preview(WINDOW *win, int y0, int x0, int type) {
+    wattron(win, COLOR_PAIR(COLOR_CELL(type)));
     for (int y = 0; y < PIECE_SIZE; y++) {
         for (int x = 0; x < PIECE_SIZE; x++) {
-            if (info->next[y][x]) {
-                int screen_y = NEXT_PIECE_Y + y;
-                int screen_x = NEXT_PIECE_X + x * 2;
-                mvaddstr(screen_y, screen_x, "██");
+            if (piece_templates[type][0][y][x]) {
+                mvwaddstr(win, y0 + y - 1, x0 + x * 2, "██");
             }
         }
     }
+    wattroff(win, COLOR_PAIR(COLOR_CELL(type)));
+}
+
+void draw_queue(const QueueView_t *queue, bool force) {
+    if (!queue) return;
+    if (!force && queue->hold == windows.hold && queue->count == windows.queue_count &&
+        memcmp(queue->types, windows.queue_types, (size_t)queue->count) == 0) {
+        return;
+    }
+    windows.hold = queue->hold;
+    windows.queue_count = queue->count;
+    memcpy(windows.queue_types, queue->types, (size_t)queue->count);
+    
+    WINDOW *win = windows.queue;
+    werase(win);
+    wattron(win, COLOR_PAIR(COLOR_TEXT));
+    mvwaddstr(win, 0, 0, "Hold:");
+    if (queue->count > 1) {
+        mvwaddstr(win, 4, 0, "Then:");
+    }
+    wattroff(win, COLOR_PAIR(COLOR_TEXT));
     
-    attroff(COLOR_PAIR(COLOR_PIECE));
+    if (queue->hold >= 0) {
+        draw_piece_preview(win, 1, 0, queue->hold);
+    }
+    // The first entry is already shown as the next piece
+    for (int i = 1; i < queue->count; i++) {
+        draw_piece_preview(win, 5 + (i - 1) * QUEUE_ENTRY_ROWS, 0, queue->types[i]);
+    }
+    wnoutrefresh(win);
 }
 
 void draw_game_over(void) {
@@ -151,20 +358,41 @@ void draw_game_over(void) {
 }
 
 void draw_pause(void) {
-    attron(COLOR_PAIR(COLOR_TEXT) | A_BOLD);
-    
-    int center_y = LINES / 2;
-    int center_x = COLS / 2;
-    
-    mvprintw(center_y, center_x - 3, "PAUSED");
-    mvprintw(center_y + 1, center_x - 8, "Press P to continue");
-    
-    attroff(COLOR_PAIR(COLOR_TEXT) | A_BOLD);
+    WINDOW *win = windows.overlay;
+    werase(win);
+    wattron(win, COLOR_PAIR(COLOR_TEXT) | A_BOLD);
+    mvwaddstr(win, 0, (OVERLAY_COLS - 6) / 2, "PAUSED");
+    mvwaddstr(win, 1, 0, "Press P to continue");
+    wattroff(win, COLOR_PAIR(COLOR_TEXT) | A_BOLD);
+    wnoutrefresh(win);
 }
 
 UserAction_t get_user_input(void) {
-    int ch = getch();
+    return map_key(getch());
+}
+
+int decode_key(const unsigned char *buf, int len, bool final, int *used) {
+    bool introducer = len < 2 || buf[1] == '[' || buf[1] == 'O';
+    if (buf[0] == 27 && len < 3 && introducer && !final) {
+        *used = 0;
+        return KEY_PARTIAL;
+    }
+    if (buf[0] == 27 && len >= 3 && introducer) {
+        *used = 3;
+        switch (buf[2]) {
+            case 'A': return KEY_UP;
+            case 'B': return KEY_DOWN;
+            case 'C': return KEY_RIGHT;
+            case 'D': return KEY_LEFT;
+            default: return -1;
+        }
+    }
     
+    *used = 1;
+    return buf[0];
+}
+
+UserAction_t map_key(int ch) {
     switch (ch) {
         case 'r':
         case 'R':
@@ -193,36 +421,24 @@ UserAction_t get_user_input(void) {
         case KEY_UP:
         case ' ':  // Space for rotation
             return Action;
+        case 'c':
+        case 'C':
+            return Up;  // Hold
         default:
             return -1;  // No valid input
     }
 }
 
 void show_instructions(void) {
+    // Drawn on stdscr, so the game windows need a fresh layout afterwards
+    windows.laid_out = false;
     clear();
     attron(COLOR_PAIR(COLOR_TEXT));
     
-    mvprintw(2, 2, "TETRIS - Instructions");
-    mvprintw(4, 2, "Arrange falling pieces to form complete horizontal lines.");
-    mvprintw(5, 2, "Complete lines will disappear and award points.");
-    mvprintw(6, 2, "Game ends when pieces reach the top.");
-    
-    mvprintw(8, 2, "Controls:");
-    mvprintw(9, 4, "A/← - Move left");
-    mvprintw(10, 4, "D/→ - Move right");
-    mvprintw(11, 4, "S/↓ - Soft drop");
-    mvprintw(12, 4, "W/↑/Space - Rotate piece");
-    mvprintw(13, 4, "P - Pause/Resume");
-    mvprintw(14, 4, "R - Restart game");
-    mvprintw(15, 4, "Q/ESC - Quit");
-    
-    mvprintw(17, 2, "Scoring:");
-    mvprintw(18, 4, "1 line  = 100 points");
-    mvprintw(19, 4, "2 lines = 300 points");
-    mvprintw(20, 4, "3 lines = 700 points");
-    mvprintw(21, 4, "4 lines = 1500 points");
-    
-    mvprintw(23, 2, "Press R to start playing!");
+    const char *const *help = panel_labels()->help;
+    for (int i = 0; help[i]; i++) {
+        mvaddstr(2 + i, 2, help[i]);
+    }
     
     attroff(COLOR_PAIR(COLOR_TEXT));
     refresh();
@@ -2,6 +2,7 @@
 #define GUI_H
 
 #include <ncurses.h>
+#include "brick_runtime.h"
 #include "tetris.h"
 
 #define FIELD_START_Y 2
@@ -9,24 +10,87 @@
 #define INFO_PANEL_X (FIELD_START_X + BOARD_WIDTH * 2 + 4)
 #define NEXT_PIECE_Y (FIELD_START_Y + 8)
 #define NEXT_PIECE_X (INFO_PANEL_X + 2)
+#define QUEUE_PANEL_X (INFO_PANEL_X + 16)
+#define QUEUE_ENTRY_ROWS 3
 
 // Color pairs
 #define COLOR_FIELD 1
 #define COLOR_BORDER 2
 #define COLOR_TEXT 3
 #define COLOR_PIECE 4
+// One pair per cell colour (PieceType_t, then CELL_GARBAGE)
+#define COLOR_CELL(color) (5 + (color))
+
+// Preview queue (next piece first) and hold slot, borrowed from the engine
+typedef struct {
+    const uint8_t *types;
+    int count;
+    int hold;  // -1 when empty
+} QueueView_t;
+
+// False for a game without pieces (nothing queued or held), whose frontend
+// leaves out the Next and Hold panels; a NULL queue still shows Next
+bool queue_has_pieces(const QueueView_t *queue);
+
+// Screen backend for the single-player loops, chosen at startup
+typedef struct {
+    const char *name;
+    bool (*init)(void);
+    void (*cleanup)(void);
+    UserAction_t (*get_input)(void);  // -1 when no key is waiting
+    // colors are the field's colour planes as in FrameView_t, NULL for plain blocks
+    void (*draw_game)(const GameInfo_t *info, const QueueView_t *queue, const uint64_t *colors);
+    void (*show_instructions)(void);
+} RenderBackend_t;
+
+extern const RenderBackend_t ncurses_backend;
+
+// Info panel heading, the name of its speed stat, the controls listed under
+// it and the instruction screen, shared by the backends
+typedef struct {
+    const char *title;
+    const char *speed;
+    const char *const *controls;  // NULL-terminated, as in GameVtable_t
+    const char *const *help;
+} PanelLabels_t;
+
+// Tetris's until a runtime game names its own; NULL goes back to Tetris
+void set_panel_labels(const GameVtable_t *game);
+const PanelLabels_t *panel_labels(void);
 
 // Function prototypes
+// Terminal colour (0-15) of a cell colour; pieces follow the usual scheme
+int cell_palette_color(int color);
+
 void init_gui(void);
+// Input modes and colour pairs for the current screen, e.g. one from newterm()
+void configure_gui(void);
 void cleanup_gui(void);
-void draw_game(const GameInfo_t *info);
-void draw_field(const GameInfo_t *info);
-void draw_border(void);
-void draw_info_panel(const GameInfo_t *info);
-void draw_next_piece(const GameInfo_t *info);
+void draw_game(const GameInfo_t *info, const QueueView_t *queue, const uint64_t *colors);
+// The windowed panels below redraw only when their content differs from
+// what they last drew, unless force is set; draw_field reports whether it did
+bool draw_field(const GameInfo_t *info, const uint64_t *colors, bool force);
+// One field row as runs of same-coloured cells, one attribute switch per
+// run; planes is the row's COLOR_PLANES words or NULL
+void draw_field_row(WINDOW *win, int y, int x0, int width, uint64_t row,
+                    const uint64_t *planes);
+void draw_info_panel(const GameInfo_t *info, bool force);
+void draw_next_piece(const GameInfo_t *info, int type, bool force);
+void draw_queue(const QueueView_t *queue, bool force);
+void draw_piece_preview(WINDOW *win, int y0, int x0, int type);
 void draw_game_over(void);
 void draw_pause(void);
 UserAction_t get_user_input(void);
+UserAction_t map_key(int ch);
+// decode_key result for bytes that may be the start of an escape sequence
+#define KEY_PARTIAL -2
+// A lone ESC counts as a key once nothing has followed it for this long
+#define ESC_WAIT_MS 25
+// Decodes raw terminal bytes (arrow keys arrive as ESC [ A..D) into a
+// getch()-style key; used is set to the bytes taken. An escape sequence cut
+// short by the read gives KEY_PARTIAL and takes nothing, unless final says
+// no more bytes are coming.
+int decode_key(const unsigned char *buf, int len, bool final, int *used);
 void show_instructions(void);
 
 #endif
\ No newline at end of file
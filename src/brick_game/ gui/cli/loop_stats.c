@@ -0,0 +1,53 @@
+#define _POSIX_C_SOURCE 200809L
+#include "loop_stats.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+uint64_t loop_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void loop_stats_add(LoopStats_t *stats, uint64_t sample_ns) {
+    stats->samples[stats->count % LOOP_STATS_CAPACITY] = sample_ns;
+    stats->count++;
+}
+
+static int compare_samples(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+void loop_stats_print(FILE *out, const char *label, const LoopStats_t *stats) {
+    size_t n = stats->count < LOOP_STATS_CAPACITY ? stats->count : LOOP_STATS_CAPACITY;
+    if (n == 0) {
+        fprintf(out, "%-14s no samples\n", label);
+        return;
+    }
+
+    uint64_t *sorted = malloc(n * sizeof(uint64_t));
+    if (!sorted) return;
+    memcpy(sorted, stats->samples, n * sizeof(uint64_t));
+    qsort(sorted, n, sizeof(uint64_t), compare_samples);
+
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        sum += (double)sorted[i];
+    }
+    double mean = sum / n;
+
+    double variance = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double d = (double)sorted[i] - mean;
+        variance += d * d;
+    }
+
+    fprintf(out, "%-14s n=%-6zu mean=%7.2fms stddev=%6.2fms p50=%7.2fms p99=%7.2fms max=%7.2fms\n",
+            label, n, mean / 1e6, sqrt(variance / n) / 1e6, sorted[n / 2] / 1e6,
+            sorted[(n * 99) / 100] / 1e6, sorted[n - 1] / 1e6);
+    free(sorted);
+}
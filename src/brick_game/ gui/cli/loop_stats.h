@@ -0,0 +1,27 @@
+#ifndef LOOP_STATS_H
+#define LOOP_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define LOOP_STATS_CAPACITY 65536
+
+// Fixed-capacity sample recorder; the newest samples win once full
+typedef struct {
+    uint64_t samples[LOOP_STATS_CAPACITY];
+    uint64_t count;
+} LoopStats_t;
+
+// Latency and frame pacing of one run of a game loop
+typedef struct {
+    LoopStats_t input_latency;  // key read until the frame showing it is flushed
+    LoopStats_t frame_time;     // interval between presented frames
+    uint64_t frames;            // loop iterations
+    uint64_t frames_drawn;      // iterations that redrew the screen
+} LoopMetrics_t;
+
+uint64_t loop_now_ns(void);
+void loop_stats_add(LoopStats_t *stats, uint64_t sample_ns);
+void loop_stats_print(FILE *out, const char *label, const LoopStats_t *stats);
+
+#endif  // LOOP_STATS_H
@@ -1,85 +1,211 @@
 #include "gui.h"
+#include "ansi_view.h"
 #include "tetris.h"
-#include <unistd.h>
+#include "game_loop.h"
+#include "grid_view.h"
+#include "puzzle_cli.h"
+#include "render_bench.h"
+#include "runtime_loop.h"
+#include "versus_cli.h"
+#include "frogger_game.h"
+#include "tetris_game.h"
 #include <signal.h>
 #include <stdbool.h>
-
-static volatile bool running = true;
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 void signal_handler(int sig) {
     (void)sig;
-    running = false;
+    stop_game_loop();
+}
+
+// Games the -G option can pick, in the order usage lists them
+static void register_games(void) {
+    game_registry_add(&tetris_game_vtable);
+    game_registry_add(&frogger_game_vtable);
+}
+
+static void print_usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-A] [-t] [-m] [-n N] [-s NAME] [-T FILE] [-v] [-g GAMES [-a N] [-r N] [-u] [-d SEC]]\n", prog);
+    fprintf(stderr, "       %s -G GAME [-A] [-t] [-m]\n", prog);
+    fprintf(stderr, "       %s solve [-l] [-H ROWS] [-c MB] FILE\n", prog);
+    fprintf(stderr, "       %s render-bench [-f FRAMES]\n", prog);
+    fprintf(stderr, "  -A       draw with direct ANSI output instead of ncurses\n");
+    fprintf(stderr, "  -t       run input, simulation and rendering on separate threads\n");
+    fprintf(stderr, "  -m       print input latency and frame time statistics on exit\n");
+    fprintf(stderr, "  -n N     show the next N pieces (%d-%d)\n", PREVIEW_MIN, PREVIEW_MAX);
+    fprintf(stderr, "  -s NAME  publish frames to shared memory for tetris-spectate\n");
+    fprintf(stderr, "  -T FILE  record every locked piece to FILE for tetris-stats\n");
+    fprintf(stderr, "  -v       two-player versus on one keyboard, split screen\n");
+    fprintf(stderr, "  -g N     wallboard: N bot games tiled across the terminal\n");
+    fprintf(stderr, "  -a N     bot actions per game per frame (wallboard)\n");
+    fprintf(stderr, "  -r N     repaint each board every N frames (wallboard)\n");
+    fprintf(stderr, "  -u       do not cap the wallboard at 60 FPS\n");
+    fprintf(stderr, "  -d SEC   stop the wallboard after SEC seconds\n");
+    fprintf(stderr, "  -G GAME  play a registered game, tetris by default:");
+    for (int i = 0; game_registry_get(i); i++) {
+        fprintf(stderr, " %s", game_registry_get(i)->name);
+    }
+    fprintf(stderr, "\n");
 }
 
-void game_loop(void) {
-    bool game_started = false;
-    bool hold_key = false;
-    UserAction_t last_action = -1;
-    int hold_counter = 0;
+int main(int argc, char **argv) {
+    const char *spectate_name = NULL;
+    const char *telemetry_path = NULL;
+    bool threaded = false;
+    bool measure = false;
+    bool grid = false;
+    bool versus = false;
+    const char *game_name = NULL;
+    bool custom_preview = false;
+    const RenderBackend_t *backend = &ncurses_backend;
+    int preview = PREVIEW_MIN;
+    GridOptions_t grid_options;
+    grid_default_options(&grid_options);
+    register_games();
     
-    while (running) {
-        UserAction_t action = get_user_input();
-        
-        // Handle key holding for movement
-        if (action == last_action && (action == Left || action == Right || action == Down)) {
-            hold_counter++;
-            if (hold_counter > 5) {  // Start holding after 5 frames
-                hold_key = true;
-            }
-        } else {
-            hold_counter = 0;
-            hold_key = false;
-        }
-        
-        if (action != -1) {
-            last_action = action;
-            userInput(action, hold_key);
-            
-            if (action == Terminate) {
-                break;
-            }
-            
-            if (action == Start) {
-                game_started = true;
-            }
-        }
-        
-        GameInfo_t info = updateCurrentState();
-        
-        if (!game_started) {
-            show_instructions();
+    if (argc > 1 && strcmp(argv[1], "solve") == 0) {
+        return puzzle_command(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "render-bench") == 0) {
+        return render_bench_command(argc - 1, argv + 1);
+    }
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-A") == 0) {
+            backend = &ansi_backend;
+        } else if (strcmp(argv[i], "-t") == 0) {
+            threaded = true;
+        } else if (strcmp(argv[i], "-m") == 0) {
+            measure = true;
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            preview = atoi(argv[++i]);
+            custom_preview = true;
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            spectate_name = argv[++i];
+        } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            telemetry_path = argv[++i];
+        } else if (strcmp(argv[i], "-G") == 0 && i + 1 < argc) {
+            game_name = argv[++i];
+        } else if (strcmp(argv[i], "-v") == 0) {
+            versus = true;
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            grid = true;
+            grid_options.games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            grid_options.actions_per_frame = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            grid_options.refresh_interval = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-u") == 0) {
+            grid_options.uncapped = true;
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            grid_options.duration = atof(argv[++i]);
         } else {
-            draw_game(&info);
+            print_usage(argv[0]);
+            return 1;
         }
-        
-        // Free allocated memory
-        if (info.field) {
-            free_field_memory(info.field, BOARD_HEIGHT);
-        }
-        if (info.next) {
-            free_field_memory(info.next, PIECE_SIZE);
-        }
-        
-        // Control game speed (60 FPS)
-        usleep(16667);  // ~16.67ms = 60 FPS
     }
-}
-
-int main(void) {
+    
+    // The wallboard and versus screens draw with ncurses directly
+    bool ansi_conflict = backend != &ncurses_backend && (grid || versus);
+    // Single-player games all run through the runtime, Tetris unless -G
+    // names another; preview, spectator and telemetry act on Tetris only
+    const GameVtable_t *runtime_game = game_name ? game_registry_find(game_name) : &tetris_game_vtable;
+    bool tetris_options = spectate_name || custom_preview || telemetry_path;
+    bool runtime_conflict = game_name && (!runtime_game || grid || versus ||
+                                          (tetris_options && runtime_game != &tetris_game_vtable));
+    // Telemetry follows the single-player game only
+    bool telemetry_conflict = telemetry_path && (grid || versus);
+    if ((grid && grid_options.games <= 0) || preview < PREVIEW_MIN || preview > PREVIEW_MAX ||
+        ansi_conflict || runtime_conflict || telemetry_conflict) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
     // Set up signal handler for graceful exit
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
     
     // Initialize game and GUI
     init_game();
-    init_gui();
+    set_preview_count(preview);
+    if (spectate_name && !enable_spectator_feed(spectate_name)) {
+        fprintf(stderr, "Cannot create spectator feed '%s'\n", spectate_name);
+        cleanup_game();
+        return 1;
+    }
+    if (telemetry_path && !enable_telemetry(telemetry_path)) {
+        fprintf(stderr, "Cannot create telemetry file '%s'\n", telemetry_path);
+        cleanup_game();
+        return 1;
+    }
+    static BrickRuntime_t runtime;
+    bool single = !grid && !versus;
+    if (single && !runtime_open(&runtime, runtime_game, (uint64_t)time(NULL))) {
+        fprintf(stderr, "Cannot create a %s game\n", runtime_game->name);
+        cleanup_game();
+        return 1;
+    }
+    if (!backend->init()) {
+        fprintf(stderr, "Cannot start the %s renderer\n", backend->name);
+        runtime_close(&runtime);
+        cleanup_game();
+        return 1;
+    }
     
     // Main game loop
-    game_loop();
+    static LoopMetrics_t metrics;
+    GridReport_t grid_report;
+    VersusReport_t versus_report;
+    bool grid_ok = false;
+    bool versus_ok = false;
+    bool threads_ok = true;
+    if (grid) {
+        grid_ok = grid_loop(&grid_options, &metrics, &grid_report);
+    } else if (versus) {
+        versus_ok = versus_loop(&metrics, &versus_report);
+    } else if (threaded) {
+        threads_ok = runtime_loop_threaded(backend, &runtime, &metrics);
+    } else {
+        runtime_loop(backend, &runtime, &metrics);
+    }
     
     // Cleanup
+    runtime_close(&runtime);
+    bool telemetry_ok = disable_telemetry();
     cleanup_game();
-    cleanup_gui();
+    backend->cleanup();
+    
+    if (!threads_ok) {
+        fprintf(stderr, "Cannot start the input and simulation threads\n");
+        return 1;
+    }
+    if (versus && !versus_ok) {
+        fprintf(stderr, "Cannot start the versus match\n");
+        return 1;
+    }
+    if (!telemetry_ok) {
+        fprintf(stderr, "Telemetry file '%s' is incomplete\n", telemetry_path);
+    }
+    if (grid_ok) {
+        grid_print_report(&grid_report);
+    }
+    if (versus_ok) {
+        versus_print_report(&versus_report);
+    }
+    if (measure) {
+        const char *loop = grid ? "grid" : versus ? "versus" : threaded ? "threaded" : "serial";
+        printf("%s loop, %s, %s\n", loop, single ? runtime_game->name : "tetris", backend->name);
+        loop_stats_print(stdout, "input->photon", &metrics.input_latency);
+        loop_stats_print(stdout, "frame time", &metrics.frame_time);
+        if (metrics.frames) {
+            printf("%-14s %llu of %llu frames (%.1f%%)\n", "redrawn",
+                   (unsigned long long)metrics.frames_drawn, (unsigned long long)metrics.frames,
+                   100.0 * metrics.frames_drawn / metrics.frames);
+        }
+    }
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,238 @@
+#define _POSIX_C_SOURCE 200809L
+#include "pipeline.h"
+#include "game_loop.h"
+#include "runtime_loop.h"
+#include <poll.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SNAPSHOT_FRESH 4
+#define INPUT_POLL_MS 20
+#define RENDER_POLL_NS 500000L
+
+void input_queue_init(InputQueue_t *queue) {
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+}
+
+bool input_queue_push(InputQueue_t *queue, const InputEvent_t *event) {
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+    if (tail - head == INPUT_QUEUE_SIZE) return false;  // full, drop the key
+
+    queue->events[tail & (INPUT_QUEUE_SIZE - 1)] = *event;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+bool input_queue_pop(InputQueue_t *queue, InputEvent_t *event) {
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    if (head == tail) return false;
+
+    *event = queue->events[head & (INPUT_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+void snapshot_buffer_init(SnapshotBuffer_t *buffer) {
+    memset(buffer->slots, 0, sizeof(buffer->slots));
+    buffer->back = 0;
+    atomic_init(&buffer->middle, 1);
+    buffer->front = 2;
+}
+
+RenderSnapshot_t *snapshot_back(SnapshotBuffer_t *buffer) {
+    return &buffer->slots[buffer->back];
+}
+
+void snapshot_publish(SnapshotBuffer_t *buffer) {
+    int old = atomic_exchange_explicit(&buffer->middle, buffer->back | SNAPSHOT_FRESH,
+                                       memory_order_acq_rel);
+    buffer->back = old & ~SNAPSHOT_FRESH;
+}
+
+const RenderSnapshot_t *snapshot_acquire(SnapshotBuffer_t *buffer) {
+    if (!(atomic_load_explicit(&buffer->middle, memory_order_relaxed) & SNAPSHOT_FRESH)) {
+        return NULL;
+    }
+
+    int old = atomic_exchange_explicit(&buffer->middle, buffer->front, memory_order_acq_rel);
+    buffer->front = old & ~SNAPSHOT_FRESH;
+    return &buffer->slots[buffer->front];
+}
+
+typedef struct {
+    InputQueue_t queue;
+    SnapshotBuffer_t snapshots;
+    BrickRuntime_t *rt;  // stepped only by the simulation thread
+    uint64_t ticks;  // simulation steps, read once the thread has joined
+} Pipeline_t;
+
+// Reads stdin directly so it never touches ncurses, which the renderer owns
+static void *input_thread(void *arg) {
+    Pipeline_t *pipeline = arg;
+    struct pollfd pfd = {.fd = STDIN_FILENO, .events = POLLIN};
+    unsigned char buf[64];
+    int len = 0;  // bytes of a cut-off escape sequence carried between reads
+    uint64_t read_ns = 0;
+
+    while (game_loop_running()) {
+        // A carried sequence that gets no more bytes within ESC_WAIT_MS
+        // was a lone ESC after all
+        int ready = poll(&pfd, 1, len ? ESC_WAIT_MS : INPUT_POLL_MS);
+        bool final = ready == 0 && len > 0;
+        if (ready > 0) {
+            ssize_t n = read(STDIN_FILENO, buf + len, sizeof(buf) - (size_t)len);
+            if (n <= 0) continue;
+            len += (int)n;
+            read_ns = loop_now_ns();
+        } else if (!final) {
+            continue;
+        }
+
+        int pos = 0;
+        while (pos < len) {
+            int used;
+            int key = decode_key(buf + pos, len - pos, final, &used);
+            if (key == KEY_PARTIAL) break;
+            InputEvent_t event = {map_key(key), read_ns};
+            if ((int)event.action != -1) {
+                input_queue_push(&pipeline->queue, &event);
+            }
+            pos += used;
+        }
+        len -= pos;
+        memmove(buf, buf + pos, (size_t)len);
+    }
+
+    return NULL;
+}
+
+// Fixed-step simulation at exact 60 Hz deadlines
+static void *simulation_thread(void *arg) {
+    Pipeline_t *pipeline = arg;
+    BrickRuntime_t *rt = pipeline->rt;
+    InputState_t input;
+    input_state_init(&input);
+    uint64_t input_seq = 0;
+    uint64_t input_ns = 0;
+    bool published_started = false;
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    while (game_loop_running()) {
+        deadline.tv_nsec += (long)FRAME_NS;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+
+        InputEvent_t event;
+        bool any = false;
+        bool quit = false;
+        while (!quit && input_queue_pop(&pipeline->queue, &event)) {
+            any = true;
+            input_seq++;
+            input_ns = event.read_ns;
+            bool hold = track_input(&input, event.action);
+            quit = event.action == Terminate;
+            if (!quit) {
+                runtime_input(rt, event.action, hold);
+            }
+        }
+        if (!any) {
+            track_input(&input, -1);
+        }
+        if (quit) {
+            stop_game_loop();
+            break;
+        }
+        runtime_step(rt);
+        pipeline->ticks++;
+
+        // The renderer already has this state; keys still get a frame so
+        // their latency is measured
+        bool changed;
+        const GameFrame_t *frame = runtime_frame(rt, &changed);
+        if (!any && !changed && input.game_started == published_started) {
+            continue;
+        }
+
+        RenderSnapshot_t *snapshot = snapshot_back(&pipeline->snapshots);
+        snapshot->frame = *frame;
+        snapshot->game_started = input.game_started;
+        snapshot->input_seq = input_seq;
+        snapshot->input_ns = input_ns;
+        snapshot_publish(&pipeline->snapshots);
+        published_started = input.game_started;
+    }
+
+    return NULL;
+}
+
+bool runtime_loop_threaded(const RenderBackend_t *backend, BrickRuntime_t *rt,
+                           LoopMetrics_t *metrics) {
+    static Pipeline_t pipeline;
+    pipeline.rt = rt;
+    pipeline.ticks = 0;
+    input_queue_init(&pipeline.queue);
+    snapshot_buffer_init(&pipeline.snapshots);
+    set_panel_labels(rt->vt);
+
+    pthread_t input;
+    pthread_t simulation;
+    if (pthread_create(&input, NULL, input_thread, &pipeline) != 0) {
+        return false;
+    }
+    if (pthread_create(&simulation, NULL, simulation_thread, &pipeline) != 0) {
+        stop_game_loop();
+        pthread_join(input, NULL);
+        return false;
+    }
+
+    uint64_t last_input_seq = 0;
+    uint64_t last_frame_ns = 0;
+    const struct timespec render_poll = {0, RENDER_POLL_NS};
+
+    // Render on this thread as soon as a fresh snapshot is published
+    while (game_loop_running()) {
+        const RenderSnapshot_t *snapshot = snapshot_acquire(&pipeline.snapshots);
+        if (!snapshot) {
+            nanosleep(&render_poll, NULL);
+            continue;
+        }
+
+        if (!snapshot->game_started) {
+            backend->show_instructions();
+        } else {
+            const GameFrame_t *frame = &snapshot->frame;
+            GameInfo_t info;
+            runtime_game_info(frame, &info);
+            QueueView_t queue = {frame->preview, frame->preview_count, frame->hold};
+            backend->draw_game(&info, &queue, frame->colors);
+        }
+        metrics->frames_drawn++;
+
+        uint64_t frame_ns = loop_now_ns();
+        if (snapshot->input_seq != last_input_seq) {
+            last_input_seq = snapshot->input_seq;
+            loop_stats_add(&metrics->input_latency, frame_ns - snapshot->input_ns);
+        }
+        if (last_frame_ns) {
+            loop_stats_add(&metrics->frame_time, frame_ns - last_frame_ns);
+        }
+        last_frame_ns = frame_ns;
+    }
+
+    pthread_join(simulation, NULL);
+    pthread_join(input, NULL);
+    metrics->frames = pipeline.ticks;
+    return true;
+}
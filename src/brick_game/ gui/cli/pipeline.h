@@ -0,0 +1,53 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "brick_runtime.h"
+
+#define INPUT_QUEUE_SIZE 256  // power of two
+
+// Key press stamped when it was read from the terminal
+typedef struct {
+    UserAction_t action;
+    uint64_t read_ns;
+} InputEvent_t;
+
+// Lock-free single-producer single-consumer ring
+typedef struct {
+    InputEvent_t events[INPUT_QUEUE_SIZE];
+    alignas(64) atomic_size_t head;  // advanced by the consumer
+    alignas(64) atomic_size_t tail;  // advanced by the producer
+} InputQueue_t;
+
+void input_queue_init(InputQueue_t *queue);
+bool input_queue_push(InputQueue_t *queue, const InputEvent_t *event);
+bool input_queue_pop(InputQueue_t *queue, InputEvent_t *event);
+
+// Everything the renderer needs for one frame
+typedef struct {
+    GameFrame_t frame;
+    bool game_started;
+    uint64_t input_seq;  // inputs applied so far
+    uint64_t input_ns;   // read time of the newest one
+} RenderSnapshot_t;
+
+// Simulation-to-render handoff. The simulation fills its back slot and swaps
+// it with the shared middle slot; the renderer swaps its front slot with the
+// middle one when a fresh frame is there. A third slot means neither side
+// ever waits or reads a slot that is being written.
+typedef struct {
+    RenderSnapshot_t slots[3];
+    atomic_int middle;  // slot index, SNAPSHOT_FRESH when unread
+    int back;
+    int front;
+} SnapshotBuffer_t;
+
+void snapshot_buffer_init(SnapshotBuffer_t *buffer);
+RenderSnapshot_t *snapshot_back(SnapshotBuffer_t *buffer);
+void snapshot_publish(SnapshotBuffer_t *buffer);
+const RenderSnapshot_t *snapshot_acquire(SnapshotBuffer_t *buffer);
+
+#endif  // PIPELINE_H
@@ -0,0 +1,116 @@
+#include "puzzle_cli.h"
+#include "tetris_puzzle.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void print_usage(void) {
+    fprintf(stderr, "usage: tetris solve [-l] [-H ROWS] [-c MB] FILE\n");
+    fprintf(stderr, "  -l       maximise cleared lines instead of searching for a perfect clear\n");
+    fprintf(stderr, "  -H ROWS  never let the stack grow above ROWS (with -l the default is the\n");
+    fprintf(stderr, "           starting stack plus the rows the pieces could fill)\n");
+    fprintf(stderr, "  -c MB    transposition table size\n");
+}
+
+static char *read_file(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    char *text = NULL;
+    size_t length = 0;
+    size_t capacity = 0;
+    size_t n;
+    char chunk[4096];
+
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        if (length + n + 1 > capacity) {
+            capacity = (length + n + 1) * 2;
+            char *grown = realloc(text, capacity);
+            if (!grown) {
+                free(text);
+                fclose(file);
+                return NULL;
+            }
+            text = grown;
+        }
+        memcpy(text + length, chunk, n);
+        length += n;
+    }
+    fclose(file);
+
+    if (text) text[length] = '\0';
+    return text;
+}
+
+static void print_placements(const PuzzleResult_t *result) {
+    static const char letters[PIECE_COUNT] = {'I', 'O', 'T', 'S', 'Z', 'J', 'L'};
+
+    for (int i = 0; i < result->placement_count; i++) {
+        const PuzzlePlacement_t *p = &result->placements[i];
+        printf("%2d. %c rotation %d column %d row %d\n", i + 1, letters[p->type],
+               p->rotation, p->x, p->y - BOARD_EXTRA_HEIGHT);
+    }
+}
+
+int puzzle_command(int argc, char **argv) {
+    PuzzleOptions_t options;
+    puzzle_default_options(&options);
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-l") == 0) {
+            options.perfect_clear = false;
+        } else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) {
+            options.max_height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            options.table_bytes = (size_t)atoi(argv[++i]) << 20;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (!path) {
+        print_usage();
+        return 1;
+    }
+
+    char *text = read_file(path);
+    if (!text) {
+        fprintf(stderr, "Cannot read '%s'\n", path);
+        return 1;
+    }
+
+    Puzzle_t puzzle;
+    bool parsed = puzzle_parse(&puzzle, text);
+    free(text);
+    if (!parsed) {
+        fprintf(stderr, "Invalid puzzle '%s'\n", path);
+        return 1;
+    }
+
+    PuzzleResult_t result;
+    if (!puzzle_solve(&puzzle, &options, &result)) {
+        fprintf(stderr, "Solver ran out of memory\n");
+        puzzle_free(&puzzle);
+        return 1;
+    }
+
+    if (options.perfect_clear) {
+        printf("%s\n", result.solved ? "perfect clear" : "no perfect clear");
+    }
+    printf("lines %d with %d of %d pieces\n", result.lines, result.placement_count,
+           puzzle.piece_count);
+    print_placements(&result);
+
+    double hit_rate = result.table_probes ? 100.0 * result.table_hits / result.table_probes : 0;
+    printf("nodes %llu (%llu pruned) in %.3f s, %.0f nodes/s\n",
+           (unsigned long long)result.nodes, (unsigned long long)result.pruned, result.seconds,
+           result.seconds > 0 ? result.nodes / result.seconds : 0);
+    printf("table %.1f%% hits of %llu probes, memory %.1f MiB\n", hit_rate,
+           (unsigned long long)result.table_probes, result.memory_bytes / (1024.0 * 1024.0));
+
+    puzzle_free(&puzzle);
+    return options.perfect_clear && !result.solved ? 2 : 0;
+}
@@ -0,0 +1,8 @@
+#ifndef PUZZLE_CLI_H
+#define PUZZLE_CLI_H
+
+// "tetris solve [options] FILE": runs the puzzle solver without the GUI.
+// argv[0] is the subcommand name; returns the process exit status.
+int puzzle_command(int argc, char **argv);
+
+#endif  // PUZZLE_CLI_H
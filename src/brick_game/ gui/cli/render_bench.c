@@ -0,0 +1,167 @@
+#define _POSIX_C_SOURCE 200809L
+#include "render_bench.h"
+#include "ansi_view.h"
+#include "gui.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define DEFAULT_FRAMES 5000
+#define BENCH_TERM "xterm-256color"
+
+// One frame as the game loop would hand it to a backend
+typedef struct {
+    GameInfo_t info;
+    uint64_t colors[BOARD_HEIGHT * COLOR_PLANES];
+    uint8_t preview[PREVIEW_MAX];
+    QueueView_t queue;
+} RecordedFrame_t;
+
+typedef struct {
+    double bytes_per_frame;
+    double cpu_us_per_frame;
+    long first_frame_bytes;
+} BackendResult_t;
+
+static uint64_t cpu_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static long file_size(FILE *file) {
+    struct stat st;
+    fflush(file);
+    return fstat(fileno(file), &st) == 0 ? (long)st.st_size : -1;
+}
+
+// A key every frame, restarting whenever the game ends; only frames whose
+// state version moved are kept, as the serial loop would draw them
+static int record_session(RecordedFrame_t *frames, int count) {
+    static const UserAction_t keys[] = {Left, Right, Action, Down, Left, Right, Start};
+    uint64_t rng = 0x2545f4914f6cdd1dull;
+    uint64_t drawn = 0;
+    int recorded = 0;
+
+    init_game();
+    userInput(Start, false);
+    while (recorded < count) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        userInput(keys[rng % (sizeof(keys) / sizeof(keys[0]))], false);
+
+        uint64_t version = tetris_state_version();
+        if (version == drawn) {
+            update_game_timer();
+            continue;
+        }
+        drawn = version;
+
+        RecordedFrame_t *frame = &frames[recorded++];
+        frame->info = updateCurrentState();
+        memcpy(frame->colors, get_field_colors(), sizeof(frame->colors));
+        const uint8_t *types;
+        int preview_count = get_preview_queue(&types);
+        memcpy(frame->preview, types, (size_t)preview_count);
+        frame->queue = (QueueView_t){frame->preview, preview_count, get_hold_piece()};
+    }
+    cleanup_game();
+    return recorded;
+}
+
+typedef void (*DrawFn_t)(const GameInfo_t *info, const QueueView_t *queue,
+                         const uint64_t *colors);
+
+static bool run_backend(const RecordedFrame_t *frames, int count, DrawFn_t draw, FILE *sink,
+                        BackendResult_t *result) {
+    // The first frame paints the static layout; the rest are deltas
+    draw(&frames[0].info, &frames[0].queue, frames[0].colors);
+    long start_bytes = file_size(sink);
+    uint64_t start = cpu_now_ns();
+    for (int i = 1; i < count; i++) {
+        draw(&frames[i].info, &frames[i].queue, frames[i].colors);
+    }
+    uint64_t cpu = cpu_now_ns() - start;
+    long end_bytes = file_size(sink);
+    if (start_bytes < 0 || end_bytes < 0) return false;
+
+    result->first_frame_bytes = start_bytes;
+    result->bytes_per_frame = (double)(end_bytes - start_bytes) / (count - 1);
+    result->cpu_us_per_frame = cpu / 1e3 / (count - 1);
+    return true;
+}
+
+static bool bench_ncurses(const RecordedFrame_t *frames, int count, BackendResult_t *result) {
+    FILE *sink = tmpfile();
+    FILE *keys = fopen("/dev/null", "r");
+    SCREEN *screen = sink && keys ? newterm(BENCH_TERM, sink, keys) : NULL;
+    bool ok = false;
+    if (screen) {
+        configure_gui();
+        long setup_bytes = file_size(sink);
+        ok = run_backend(frames, count, draw_game, sink, result);
+        result->first_frame_bytes -= setup_bytes;
+        cleanup_gui();
+        delscreen(screen);
+    }
+    if (keys) fclose(keys);
+    if (sink) fclose(sink);
+    return ok;
+}
+
+static bool bench_ansi(const RecordedFrame_t *frames, int count, BackendResult_t *result) {
+    FILE *sink = tmpfile();
+    if (!sink) return false;
+
+    ansi_view_open(fileno(sink));
+    long setup_bytes = file_size(sink);
+    bool ok = run_backend(frames, count, ansi_backend.draw_game, sink, result);
+    result->first_frame_bytes -= setup_bytes;
+    ansi_view_close();
+    fclose(sink);
+    return ok;
+}
+
+int render_bench_command(int argc, char **argv) {
+    int count = DEFAULT_FRAMES;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            count = atoi(argv[++i]);
+        } else {
+            count = 0;
+            break;
+        }
+    }
+    if (count < 2) {
+        fprintf(stderr, "usage: tetris render-bench [-f FRAMES]\n");
+        return 1;
+    }
+
+    RecordedFrame_t *frames = calloc((size_t)count, sizeof(RecordedFrame_t));
+    if (!frames) return 1;
+    count = record_session(frames, count);
+
+    BackendResult_t ncurses_result;
+    BackendResult_t ansi_result;
+    bool ok = bench_ncurses(frames, count, &ncurses_result);
+    if (!ok) {
+        fprintf(stderr, "render-bench: cannot open a %s screen\n", BENCH_TERM);
+    } else if ((ok = bench_ansi(frames, count, &ansi_result))) {
+        printf("%d changed frames, a key every frame\n", count);
+        printf("%-8s %12s %14s %12s\n", "backend", "bytes/frame", "cpu us/frame", "first frame");
+        printf("%-8s %12.1f %14.2f %12ld\n", ncurses_backend.name, ncurses_result.bytes_per_frame,
+               ncurses_result.cpu_us_per_frame, ncurses_result.first_frame_bytes);
+        printf("%-8s %12.1f %14.2f %12ld\n", ansi_backend.name, ansi_result.bytes_per_frame,
+               ansi_result.cpu_us_per_frame, ansi_result.first_frame_bytes);
+    }
+
+    for (int i = 0; i < count; i++) {
+        free_field_memory(frames[i].info.field, BOARD_HEIGHT);
+        free_field_memory(frames[i].info.next, PIECE_SIZE);
+    }
+    free(frames);
+    return ok ? 0 : 1;
+}
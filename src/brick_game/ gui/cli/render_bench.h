@@ -0,0 +1,9 @@
+#ifndef RENDER_BENCH_H
+#define RENDER_BENCH_H
+
+// "tetris render-bench [-f FRAMES]": replays one recorded session through
+// each render backend into a file and prints bytes and CPU per frame.
+// argv[0] is the subcommand name; returns the process exit status.
+int render_bench_command(int argc, char **argv);
+
+#endif  // RENDER_BENCH_H
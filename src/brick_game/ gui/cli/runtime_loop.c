@@ -0,0 +1,94 @@
+#define _POSIX_C_SOURCE 200809L
+#include "runtime_loop.h"
+#include "game_loop.h"
+#include <time.h>
+
+static int field_cells[BOARD_HEIGHT][BOARD_WIDTH];
+static int *field_rows[BOARD_HEIGHT];
+static int next_cells[PIECE_SIZE][PIECE_SIZE];
+static int *next_rows[PIECE_SIZE];
+
+void runtime_game_info(const GameFrame_t *frame, GameInfo_t *info) {
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        field_rows[y] = field_cells[y];
+        for (int x = 0; x < BOARD_WIDTH; x++) {
+            field_cells[y][x] = (int)((frame->rows[y] >> x) & 1);
+        }
+    }
+    for (int y = 0; y < PIECE_SIZE; y++) {
+        next_rows[y] = next_cells[y];
+        for (int x = 0; x < PIECE_SIZE; x++) {
+            next_cells[y][x] = (frame->next >> (y * PIECE_SIZE + x)) & 1;
+        }
+    }
+    
+    info->field = field_rows;
+    info->next = next_rows;
+    info->score = frame->score;
+    info->high_score = frame->high_score;
+    info->level = frame->level;
+    info->speed = frame->speed;
+    info->pause = frame->pause;
+}
+
+// A signal cuts the sleep short, which is fine: the loop rechecks running
+static void sleep_until(uint64_t deadline_ns) {
+    struct timespec ts = {(time_t)(deadline_ns / 1000000000ull), (long)(deadline_ns % 1000000000ull)};
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+void runtime_loop(const RenderBackend_t *backend, BrickRuntime_t *rt, LoopMetrics_t *metrics) {
+    InputState_t input;
+    input_state_init(&input);
+    uint64_t last_frame_ns = 0;
+    uint64_t deadline = loop_now_ns();
+    bool drawn_started = false;
+    set_panel_labels(rt->vt);
+    
+    while (game_loop_running()) {
+        UserAction_t action = backend->get_input();
+        uint64_t input_ns = loop_now_ns();
+        
+        bool hold = track_input(&input, action);
+        if (action == Terminate) {
+            break;
+        }
+        if ((int)action != -1) {
+            runtime_input(rt, action, hold);
+        }
+        runtime_step(rt);
+        
+        bool changed;
+        const GameFrame_t *frame = runtime_frame(rt, &changed);
+        if (changed || input.game_started != drawn_started) {
+            if (!input.game_started) {
+                backend->show_instructions();
+            } else {
+                GameInfo_t info;
+                runtime_game_info(frame, &info);
+                QueueView_t queue = {
+                    .types = frame->preview, .count = frame->preview_count, .hold = frame->hold};
+                backend->draw_game(&info, &queue, frame->colors);
+            }
+            drawn_started = input.game_started;
+            metrics->frames_drawn++;
+        }
+        metrics->frames++;
+        
+        uint64_t frame_ns = loop_now_ns();
+        if ((int)action != -1) {
+            loop_stats_add(&metrics->input_latency, frame_ns - input_ns);
+        }
+        if (last_frame_ns) {
+            loop_stats_add(&metrics->frame_time, frame_ns - last_frame_ns);
+        }
+        last_frame_ns = frame_ns;
+        
+        // Next frame on the 60 FPS grid; after a stall, restart it from now
+        deadline += FRAME_NS;
+        if (deadline < frame_ns) {
+            deadline = frame_ns;
+        }
+        sleep_until(deadline);
+    }
+}
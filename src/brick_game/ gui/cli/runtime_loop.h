@@ -0,0 +1,22 @@
+#ifndef RUNTIME_LOOP_H
+#define RUNTIME_LOOP_H
+
+#include "brick_runtime.h"
+#include "gui.h"
+#include "loop_stats.h"
+
+// Shared frontend for every registered game. Each frame polls one key,
+// steps the game once and redraws only when its version moved; frames run
+// on fixed CLOCK_MONOTONIC deadlines, and GameInfo_t is built over buffers
+// the loop owns, so drawing never allocates.
+void runtime_loop(const RenderBackend_t *backend, BrickRuntime_t *rt, LoopMetrics_t *metrics);
+// The same game on three threads: input, the fixed-step simulation, and
+// rendering as soon as a new frame is published (pipeline.c). False if
+// the worker threads could not be started.
+bool runtime_loop_threaded(const RenderBackend_t *backend, BrickRuntime_t *rt,
+                           LoopMetrics_t *metrics);
+
+// Points info at static cells filled from frame; valid until the next call
+void runtime_game_info(const GameFrame_t *frame, GameInfo_t *info);
+
+#endif  // RUNTIME_LOOP_H
@@ -0,0 +1,192 @@
+#define _POSIX_C_SOURCE 200809L
+#include "versus_cli.h"
+#include "game_loop.h"
+#include "gui.h"
+#include "tetris_frame.h"
+#include "tetris_versus.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <time.h>
+
+#define VERSUS_PLAYERS 2
+#define VERSUS_PANEL_WIDTH (BOARD_WIDTH * 2 + 16)
+#define VERSUS_SIDE_X (BOARD_WIDTH * 2 + 3)
+
+typedef struct {
+    int key;
+    int player;
+    UserAction_t action;
+    bool hold;
+} VersusBinding_t;
+
+static const VersusBinding_t versus_bindings[] = {
+    {'a', 0, Left, false},      {'d', 0, Right, false},     {'w', 0, Action, false},
+    {'s', 0, Down, false},      {' ', 0, Down, true},       {'e', 0, Up, false},
+    {KEY_LEFT, 1, Left, false}, {KEY_RIGHT, 1, Right, false}, {KEY_UP, 1, Action, false},
+    {KEY_DOWN, 1, Down, false}, {'\n', 1, Down, true},      {'\r', 1, Down, true},
+    {KEY_ENTER, 1, Down, true}, {'0', 1, Up, false},
+};
+
+static void map_versus_key(int ch, VersusInput_t *inputs) {
+    if (ch < 128) ch = tolower(ch);
+
+    for (size_t i = 0; i < sizeof(versus_bindings) / sizeof(versus_bindings[0]); i++) {
+        if (versus_bindings[i].key == ch) {
+            versus_input_push(&inputs[versus_bindings[i].player], versus_bindings[i].action,
+                              versus_bindings[i].hold);
+            return;
+        }
+    }
+}
+
+static void draw_player(const VersusMatch_t *match, int index, const FrameView_t *view) {
+    const VersusPlayer_t *player = &match->players[index];
+    int left = FIELD_START_X + index * VERSUS_PANEL_WIDTH;
+    int top = FIELD_START_Y;
+
+    attron(COLOR_PAIR(COLOR_BORDER));
+    mvhline(top - 1, left, '-', BOARD_WIDTH * 2);
+    mvhline(top + BOARD_HEIGHT, left, '-', BOARD_WIDTH * 2);
+    mvvline(top, left - 1, '|', BOARD_HEIGHT);
+    mvvline(top, left + BOARD_WIDTH * 2, '|', BOARD_HEIGHT);
+    attroff(COLOR_PAIR(COLOR_BORDER));
+
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        draw_field_row(stdscr, top + y, left, BOARD_WIDTH, view->rows[y],
+                       view->colors + (size_t)y * COLOR_PLANES);
+    }
+
+    // Incoming garbage as a bar along the bottom of the right border
+    int pending = versus_pending_lines(player);
+    attron(COLOR_PAIR(COLOR_TEXT) | A_BOLD);
+    for (int i = 0; i < pending && i < BOARD_HEIGHT; i++) {
+        mvaddch(top + BOARD_HEIGHT - 1 - i, left + BOARD_WIDTH * 2, '#');
+    }
+    attroff(COLOR_PAIR(COLOR_TEXT) | A_BOLD);
+
+    int side = left + VERSUS_SIDE_X;
+    attron(COLOR_PAIR(COLOR_TEXT));
+    mvprintw(top, side, "P%d", index + 1);
+    mvprintw(top + 2, side, "Score %d", view->score);
+    mvprintw(top + 3, side, "Sent  %d", player->lines_sent);
+    mvprintw(top + 4, side, "Got   %d", player->lines_received);
+    mvprintw(top + 6, side, "Next:");
+    mvprintw(top + 11, side, "Hold:");
+    if (!player->alive) mvprintw(top + 16, side, "TOPPED OUT");
+    attroff(COLOR_PAIR(COLOR_TEXT));
+
+    if (view->preview_count) draw_piece_preview(stdscr, top + 8, side, view->preview[0]);
+    if (view->hold >= 0) draw_piece_preview(stdscr, top + 13, side, view->hold);
+}
+
+static void draw_status(const VersusMatch_t *match, bool paused) {
+    attron(COLOR_PAIR(COLOR_TEXT) | A_BOLD);
+    int y = FIELD_START_Y + BOARD_HEIGHT + 2;
+    if (match->over) {
+        if (match->winner >= 0) {
+            mvprintw(y, FIELD_START_X, "P%d wins!  R - rematch  Q - quit", match->winner + 1);
+        } else {
+            mvprintw(y, FIELD_START_X, "Draw!  R - rematch  Q - quit");
+        }
+    } else if (paused) {
+        mvprintw(y, FIELD_START_X, "PAUSED  P - continue");
+    } else {
+        mvprintw(y, FIELD_START_X, "P1: WASD Space E   P2: arrows Enter 0   P - pause  Q - quit");
+    }
+    attroff(COLOR_PAIR(COLOR_TEXT) | A_BOLD);
+}
+
+static void sleep_until(struct timespec *deadline) {
+    deadline->tv_nsec += (long)FRAME_NS;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_nsec -= 1000000000L;
+        deadline->tv_sec++;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL);
+}
+
+static void fill_report(const VersusMatch_t *match, int matches, VersusReport_t *report) {
+    report->matches = matches;
+    report->winner = match->over ? match->winner : -1;
+    report->ticks = match->tick;
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        report->lines_sent[p] = match->players[p].lines_sent;
+    }
+}
+
+bool versus_loop(LoopMetrics_t *metrics, VersusReport_t *report) {
+    static VersusMatch_t match;
+    FrameExport_t frames[VERSUS_PLAYERS];
+    uint64_t seed = (uint64_t)time(NULL);
+
+    if (!versus_init(&match, VERSUS_PLAYERS, BOARD_WIDTH, BOARD_HEIGHT, seed)) return false;
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        if (!frame_export_init(&frames[p], BOARD_WIDTH, BOARD_HEIGHT)) {
+            while (p-- > 0) {
+                frame_export_free(&frames[p]);
+            }
+            versus_free(&match);
+            return false;
+        }
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    uint64_t last_frame_ns = loop_now_ns();
+    bool paused = false;
+    int matches = 1;
+
+    while (game_loop_running()) {
+        // Every key since the last frame, in order, so a quick Left then
+        // Rotate inside one frame does both
+        VersusInput_t inputs[VERSUS_PLAYERS] = {0};
+        bool quit = false;
+
+        for (int ch = getch(); ch != ERR; ch = getch()) {
+            if (ch == 'q' || ch == 'Q' || ch == 27) {
+                quit = true;
+            } else if (ch == 'p' || ch == 'P') {
+                paused = !paused && !match.over;
+            } else if ((ch == 'r' || ch == 'R') && match.over) {
+                versus_restart(&match, ++seed);
+                matches++;
+            } else {
+                map_versus_key(ch, inputs);
+            }
+        }
+        if (quit) break;
+
+        // One tick for both boards keeps the players in lockstep
+        if (!paused) versus_tick(&match, inputs);
+
+        erase();
+        for (int p = 0; p < VERSUS_PLAYERS; p++) {
+            draw_player(&match, p, frame_export(&frames[p], &match.players[p].game));
+        }
+        draw_status(&match, paused);
+        refresh();
+
+        uint64_t frame_ns = loop_now_ns();
+        loop_stats_add(&metrics->frame_time, frame_ns - last_frame_ns);
+        last_frame_ns = frame_ns;
+        sleep_until(&deadline);
+    }
+
+    fill_report(&match, matches, report);
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        frame_export_free(&frames[p]);
+    }
+    versus_free(&match);
+    return true;
+}
+
+void versus_print_report(const VersusReport_t *report) {
+    if (report->winner >= 0) {
+        printf("versus: P%d won match %d after %llu ticks", report->winner + 1, report->matches,
+               (unsigned long long)report->ticks);
+    } else {
+        printf("versus: match %d unfinished or drawn after %llu ticks", report->matches,
+               (unsigned long long)report->ticks);
+    }
+    printf(", lines sent %d / %d\n", report->lines_sent[0], report->lines_sent[1]);
+}
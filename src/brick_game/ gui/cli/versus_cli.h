@@ -0,0 +1,21 @@
+#ifndef VERSUS_CLI_H
+#define VERSUS_CLI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "loop_stats.h"
+
+// Outcome of the last match played in the split-screen versus mode
+typedef struct {
+    int matches;
+    int winner;  // -1 for a draw or an unfinished match
+    uint64_t ticks;
+    int lines_sent[2];
+} VersusReport_t;
+
+// Two players on one keyboard: WASD, Space to drop and E to hold against
+// the arrows, Enter to drop and 0 to hold
+bool versus_loop(LoopMetrics_t *metrics, VersusReport_t *report);
+void versus_print_report(const VersusReport_t *report);
+
+#endif  // VERSUS_CLI_H
@@ -0,0 +1,63 @@
+#include "brick_runtime.h"
+#include <string.h>
+
+static const GameVtable_t *registry[GAME_REGISTRY_MAX];
+static int registry_size = 0;
+
+bool game_registry_add(const GameVtable_t *vt) {
+    if (!vt || !vt->name || registry_size == GAME_REGISTRY_MAX) return false;
+    if (game_registry_find(vt->name)) return false;
+
+    registry[registry_size++] = vt;
+    return true;
+}
+
+const GameVtable_t *game_registry_get(int index) {
+    return index >= 0 && index < registry_size ? registry[index] : NULL;
+}
+
+const GameVtable_t *game_registry_find(const char *name) {
+    if (!name) return NULL;
+
+    for (int i = 0; i < registry_size; i++) {
+        if (strcmp(registry[i]->name, name) == 0) return registry[i];
+    }
+    return NULL;
+}
+
+bool runtime_open(BrickRuntime_t *rt, const GameVtable_t *vt, uint64_t seed) {
+    if (!rt || !vt) return false;
+
+    memset(rt, 0, sizeof(*rt));
+    rt->game = vt->create(seed);
+    if (!rt->game) return false;
+    rt->vt = vt;
+    return true;
+}
+
+void runtime_close(BrickRuntime_t *rt) {
+    if (!rt || !rt->vt) return;
+
+    rt->vt->destroy(rt->game);
+    rt->vt = NULL;
+    rt->game = NULL;
+}
+
+void runtime_input(BrickRuntime_t *rt, UserAction_t action, bool hold) {
+    rt->vt->input(rt->game, action, hold);
+}
+
+void runtime_step(BrickRuntime_t *rt) {
+    rt->vt->step(rt->game);
+}
+
+const GameFrame_t *runtime_frame(BrickRuntime_t *rt, bool *changed) {
+    uint64_t version = rt->vt->version(rt->game);
+    bool stale = version != rt->exported;
+    if (stale) {
+        rt->vt->export_frame(rt->game, &rt->frame);
+        rt->exported = version;
+    }
+    if (changed) *changed = stale;
+    return &rt->frame;
+}
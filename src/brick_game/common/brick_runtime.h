@@ -0,0 +1,77 @@
+#ifndef BRICK_RUNTIME_H
+#define BRICK_RUNTIME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tetris_types.h"
+
+// Everything a frontend draws for one game, in buffers the frame owns and
+// sized for the classic field, so exporting never allocates. Rows and
+// colours are laid out as in FrameView_t.
+typedef struct {
+    int width;
+    int height;
+    uint64_t rows[BOARD_HEIGHT];
+    uint64_t colors[BOARD_HEIGHT * COLOR_PLANES];
+    uint16_t next;    // 4x4 next piece, bit (y * PIECE_SIZE + x); 0 for none
+    int next_color;   // colour of next, -1 when the game has no preview
+    uint8_t preview[PREVIEW_MAX];  // upcoming PieceType_t values, next first
+    int preview_count;
+    int hold;  // held PieceType_t, -1 when empty or not a Tetris game
+    int score;
+    int high_score;
+    int level;
+    int speed;
+    int pause;
+} GameFrame_t;
+
+// One game as the runtime sees it. create returns NULL on failure. step
+// advances one 60 Hz frame with no key, so a game's own timing lives here
+// and never in a frontend loop. version follows the rules of
+// tetris_state_version(): bumped on every visible change, never 0.
+// title heads the info panel and speed_label names what the frame's speed
+// slot holds. controls are the side panel's key lines and help the lines
+// of the screen shown before a game starts, both NULL-terminated.
+typedef struct {
+    const char *name;
+    const char *title;
+    const char *speed_label;
+    const char *const *controls;
+    const char *const *help;
+    void *(*create)(uint64_t seed);
+    void (*destroy)(void *game);
+    void (*input)(void *game, UserAction_t action, bool hold);
+    void (*step)(void *game);
+    uint64_t (*version)(const void *game);
+    void (*export_frame)(void *game, GameFrame_t *frame);
+} GameVtable_t;
+
+#define GAME_REGISTRY_MAX 8
+
+// Games are registered by whoever links them, once at startup and before
+// any lookup; the runtime itself knows none of them. A name can only be
+// registered once. False when the registry is full or the name is taken.
+bool game_registry_add(const GameVtable_t *vt);
+// Registered games in registration order; NULL past the end or for an
+// unknown name
+const GameVtable_t *game_registry_get(int index);
+const GameVtable_t *game_registry_find(const char *name);
+
+// A running game plus the frame last exported from it
+typedef struct {
+    const GameVtable_t *vt;
+    void *game;
+    GameFrame_t frame;
+    uint64_t exported;  // version frame holds, 0 before the first export
+} BrickRuntime_t;
+
+bool runtime_open(BrickRuntime_t *rt, const GameVtable_t *vt, uint64_t seed);
+void runtime_close(BrickRuntime_t *rt);
+void runtime_input(BrickRuntime_t *rt, UserAction_t action, bool hold);
+void runtime_step(BrickRuntime_t *rt);
+// Re-exports only when the game's version moved; changed reports whether
+// it did. The frame stays valid until the runtime is closed.
+const GameFrame_t *runtime_frame(BrickRuntime_t *rt, bool *changed);
+
+#endif  // BRICK_RUNTIME_H
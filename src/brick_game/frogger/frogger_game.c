@@ -0,0 +1,251 @@
+#include "frogger_game.h"
+#include "tetris_board.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ROW_MASK ((UINT64_C(1) << BOARD_WIDTH) - 1)
+#define FROG_START_X (BOARD_WIDTH / 2)
+#define FROG_START_Y (BOARD_HEIGHT - 1)
+#define CAR_COLOR PIECE_Z
+#define FROG_COLOR PIECE_S
+
+static uint64_t frogger_rand(FroggerGame_t *game) {
+    uint64_t x = game->rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    game->rng_state = x;
+    return x * 0x2545f4914f6cdd1dull;
+}
+
+uint64_t frogger_lane_row(const FroggerLane_t *lane) {
+    int r = lane->offset & (FROGGER_RING - 1);
+    uint64_t ring = r ? (lane->cars << r) | (lane->cars >> (FROGGER_RING - r)) : lane->cars;
+    return ring & ROW_MASK;
+}
+
+// Roads get denser and faster with the level; neighbours run opposite ways
+static void build_lanes(FroggerGame_t *game) {
+    memset(game->lanes, 0, sizeof(game->lanes));
+
+    for (int y = 1; y < BOARD_HEIGHT - 1; y += 2) {
+        FroggerLane_t *lane = &game->lanes[y];
+        int density = 20 + 3 * game->level;  // percent of the loop covered
+        int x = 0;
+        while (x < FROGGER_RING) {
+            int length = 1 + (int)(frogger_rand(game) % 3);
+            if ((int)(frogger_rand(game) % 100) < density) {
+                for (int i = 0; i < length && x + i < FROGGER_RING; i++) {
+                    lane->cars |= UINT64_C(1) << (x + i);
+                }
+                length++;  // a gap after every car
+            }
+            x += length;
+        }
+        lane->step = (y / 2) % 2 ? -1 : 1;
+        int slowest = 30 - 2 * game->level;
+        lane->period = 4 + (int)(frogger_rand(game) % (uint64_t)slowest);
+        lane->offset = (int)(frogger_rand(game) % FROGGER_RING);
+    }
+}
+
+static bool frog_hit(const FroggerGame_t *game) {
+    return (frogger_lane_row(&game->lanes[game->frog_y]) >> game->frog_x) & 1;
+}
+
+static void reset_frog(FroggerGame_t *game) {
+    game->frog_x = FROG_START_X;
+    game->frog_y = FROG_START_Y;
+}
+
+static void start_game(FroggerGame_t *game) {
+    game->lives = FROGGER_LIVES;
+    game->crossings = 0;
+    game->score = 0;
+    game->level = 1;
+    game->started = true;
+    game->paused = false;
+    game->game_over = false;
+    build_lanes(game);
+    reset_frog(game);
+}
+
+static void lose_life(FroggerGame_t *game) {
+    if (--game->lives > 0) {
+        reset_frog(game);
+        return;
+    }
+    game->game_over = true;
+    if (game->score > game->high_score) {
+        game->high_score = game->score;
+    }
+}
+
+// Checks where a move or a lane left the frog
+static void settle_frog(FroggerGame_t *game) {
+    if (frog_hit(game)) {
+        lose_life(game);
+    } else if (game->frog_y == 0) {
+        game->score += game->level;
+        if (game->score > game->high_score) {
+            game->high_score = game->score;
+        }
+        if (++game->crossings == FROGGER_CROSSINGS) {
+            game->crossings = 0;
+            if (game->level < FROGGER_MAX_LEVEL) game->level++;
+            build_lanes(game);
+        }
+        reset_frog(game);
+    }
+}
+
+void frogger_init(FroggerGame_t *game, uint64_t seed) {
+    memset(game, 0, sizeof(*game));
+    // xorshift must never hold zero
+    game->rng_state = seed ? seed : 0x9e3779b97f4a7c15ull;
+    game->level = 1;
+    game->lives = FROGGER_LIVES;
+    game->version = 1;
+    reset_frog(game);
+}
+
+void frogger_input(FroggerGame_t *game, UserAction_t action) {
+    if (!game->started || game->game_over) {
+        if (action == Start) {
+            start_game(game);
+            game->version++;
+        }
+        return;
+    }
+    if (action == Pause) {
+        game->paused = !game->paused;
+        game->version++;
+        return;
+    }
+    if (game->paused) return;
+
+    int x = game->frog_x;
+    int y = game->frog_y;
+    switch (action) {
+        case Left: x--; break;
+        case Right: x++; break;
+        case Action:  // the frontends' forward key (W, Up arrow, Space)
+        case Up: y--; break;
+        case Down: y++; break;
+        case Terminate:
+            game->game_over = true;
+            game->version++;
+            return;
+        default: return;
+    }
+    if (x >= 0 && x < BOARD_WIDTH && y >= 0 && y < BOARD_HEIGHT) {
+        game->frog_x = x;
+        game->frog_y = y;
+        settle_frog(game);
+        game->version++;
+    }
+}
+
+void frogger_step(FroggerGame_t *game) {
+    if (!game->started || game->paused || game->game_over) return;
+
+    bool moved = false;
+    for (int y = 1; y < BOARD_HEIGHT - 1; y += 2) {
+        FroggerLane_t *lane = &game->lanes[y];
+        if (++lane->timer < lane->period) continue;
+        lane->timer = 0;
+        lane->offset = (lane->offset + lane->step) & (FROGGER_RING - 1);
+        moved = true;
+    }
+    if (moved) {
+        if (frog_hit(game)) lose_life(game);
+        game->version++;
+    }
+}
+
+static void *frogger_create(uint64_t seed) {
+    FroggerGame_t *game = malloc(sizeof(*game));
+    if (game) frogger_init(game, seed);
+    return game;
+}
+
+static void frogger_input_hook(void *game, UserAction_t action, bool hold) {
+    (void)hold;
+    frogger_input(game, action);
+}
+
+static void frogger_step_hook(void *game) {
+    frogger_step(game);
+}
+
+static uint64_t frogger_version(const void *game) {
+    return ((const FroggerGame_t *)game)->version;
+}
+
+static void frogger_export(void *game, GameFrame_t *frame) {
+    const FroggerGame_t *g = game;
+
+    frame->width = BOARD_WIDTH;
+    frame->height = BOARD_HEIGHT;
+    memset(frame->colors, 0, sizeof(frame->colors));
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        uint64_t cars = g->started ? frogger_lane_row(&g->lanes[y]) : 0;
+        uint64_t *planes = frame->colors + (size_t)y * COLOR_PLANES;
+        color_planes_set(planes, cars, CAR_COLOR);
+        frame->rows[y] = cars;
+        if (g->started && y == g->frog_y) {
+            uint64_t frog = UINT64_C(1) << g->frog_x;
+            color_planes_set(planes, frog, FROG_COLOR);
+            frame->rows[y] |= frog;
+        }
+    }
+    frame->next = 0;
+    frame->next_color = -1;
+    frame->preview_count = 0;
+    frame->hold = -1;
+    frame->score = g->score;
+    frame->high_score = g->high_score;
+    frame->level = g->level;
+    frame->speed = g->lives;
+    frame->pause = g->paused ? 1 : 0;
+}
+
+static const char *const frogger_controls[] = {
+    "Controls:", "A/D - Sideways", "W - Forward", "S - Back", "P - Pause", "Q - Quit",
+    "R - Restart", NULL,
+};
+
+static const char *const frogger_help[] = {
+    "FROGGER - Instructions",
+    "",
+    "Hop the frog from the bottom row to the top one.",
+    "Cars drive along every other row; getting hit costs a life.",
+    "Each crossing scores the level; every 5 crossings the level rises.",
+    "Game ends when the last life is lost.",
+    "",
+    "Controls:",
+    "  A/Left - Hop left",
+    "  D/Right - Hop right",
+    "  W/Up/Space - Hop forward",
+    "  S/Down - Hop back",
+    "  P - Pause/Resume",
+    "  R - Restart game",
+    "  Q/ESC - Quit",
+    "",
+    "Press R to start playing!",
+    NULL,
+};
+
+const GameVtable_t frogger_game_vtable = {
+    .name = "frogger",
+    .title = "FROGGER",
+    .speed_label = "Lives",
+    .controls = frogger_controls,
+    .help = frogger_help,
+    .create = frogger_create,
+    .destroy = free,
+    .input = frogger_input_hook,
+    .step = frogger_step_hook,
+    .version = frogger_version,
+    .export_frame = frogger_export,
+};
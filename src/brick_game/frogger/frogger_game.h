@@ -0,0 +1,53 @@
+#ifndef FROGGER_GAME_H
+#define FROGGER_GAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "brick_runtime.h"
+#include "tetris_types.h"
+
+// Frogger on the classic field: the frog starts on the bottom row and
+// crosses to row 0. Odd rows are roads and even rows are safe.
+#define FROGGER_LIVES 3
+#define FROGGER_CROSSINGS 5  // crossings per level
+#define FROGGER_MAX_LEVEL 10
+#define FROGGER_RING 64      // cells in a lane's loop
+
+// A road is a loop of FROGGER_RING cells with a car wherever a bit is set.
+// Moving it only turns offset, so cell x shows bit (x - offset) mod
+// FROGGER_RING; see frogger_lane_row().
+typedef struct {
+    uint64_t cars;
+    int offset;
+    int step;    // +1 right, -1 left, 0 for safe rows
+    int period;  // frames between moves
+    int timer;
+} FroggerLane_t;
+
+typedef struct {
+    FroggerLane_t lanes[BOARD_HEIGHT];
+    int frog_x;
+    int frog_y;
+    int lives;
+    int crossings;
+    int score;
+    int high_score;
+    int level;
+    bool started;
+    bool paused;
+    bool game_over;
+    uint64_t rng_state;
+    uint64_t version;  // as TetrisGame_t.version
+} FroggerGame_t;
+
+void frogger_init(FroggerGame_t *game, uint64_t seed);
+void frogger_input(FroggerGame_t *game, UserAction_t action);
+// One frame: lanes due to move move, and a car reaching the frog kills it
+void frogger_step(FroggerGame_t *game);
+// Visible cells of a lane, bit x for column x
+uint64_t frogger_lane_row(const FroggerLane_t *lane);
+
+// Registered as "frogger"; the panel shows lives in the speed slot
+extern const GameVtable_t frogger_game_vtable;
+
+#endif  // FROGGER_GAME_H
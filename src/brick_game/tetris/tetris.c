@@ -1,6 +1,13 @@
 #include "tetris.h"
+#include "tetris_game.h"
 #include "tetris_fsm.h"
 #include "tetris_pieces.h"
+#include "tetris_board.h"
+#include "tetris_frame.h"
+#include "tetris_hash.h"
+#include "tetris_piece_tables.h"
+#include "tetris_spectator.h"
+#include "tetris_telemetry.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,10 +16,17 @@
 // Global game state
 static TetrisGame_t g_game = {0};
 static bool g_initialized = false;
+static FrameExport_t g_frames = {0};
+static SpectatorFeed_t g_feed = {0};
+static FrameExport_t g_feed_frames = {0};
+static uint64_t *g_colors = NULL;
+static bool g_runtime_open = false;  // tetris_game_vtable holds g_game
+static bool g_runtime_owned = false;  // and initialised it
 
 // Function declarations
 void prepare_game_info(GameInfo_t *info);
 void allocate_field_memory(int ***field, int height, int width);
+static void publish_spectator_frame(void);
 
 // Main API implementation
 void userInput(UserAction_t action, bool hold) {
@@ -31,63 +45,203 @@ GameInfo_t updateCurrentState(void) {
     
     GameInfo_t info = {0};
     prepare_game_info(&info);
+    publish_spectator_frame();
     
     return info;
 }
 
+void update_game_timer(void) {
+    if (!g_initialized) {
+        init_game();
+    }
+    
+    fsm_update_timer(&g_game);
+}
+
+uint64_t tetris_state_version(void) {
+    return g_initialized ? g_game.version : 0;
+}
+
+const FrameView_t *updateCurrentFrame(void) {
+    if (!g_initialized) {
+        init_game();
+    }
+    
+    fsm_update_timer(&g_game);
+    
+    if (g_frames.width != g_game.board.width || g_frames.height != g_game.board.height) {
+        frame_export_free(&g_frames);
+        if (!frame_export_init(&g_frames, g_game.board.width, g_game.board.height)) {
+            return NULL;
+        }
+    }
+    
+    const FrameView_t *view = frame_export(&g_frames, &g_game);
+    publish_spectator_frame();
+    
+    return view;
+}
+
+bool enable_spectator_feed(const char *name) {
+    if (!g_initialized) {
+        init_game();
+    }
+    
+    disable_spectator_feed();
+    if (!frame_export_init(&g_feed_frames, g_game.board.width, g_game.board.height)) {
+        return false;
+    }
+    if (!spectator_open_writer(&g_feed, name, g_game.board.width, g_game.board.height)) {
+        frame_export_free(&g_feed_frames);
+        return false;
+    }
+    
+    return true;
+}
+
+bool enable_telemetry(const char *path) {
+    if (!g_initialized) {
+        init_game();
+    }
+    disable_telemetry();
+    
+    g_game.telemetry = telemetry_open(path);
+    return g_game.telemetry != NULL;
+}
+
+bool disable_telemetry(void) {
+    bool ok = telemetry_close(g_game.telemetry);
+    g_game.telemetry = NULL;
+    return ok;
+}
+
+void disable_spectator_feed(void) {
+    spectator_close(&g_feed);
+    frame_export_free(&g_feed_frames);
+}
+
+static void publish_spectator_frame(void) {
+    if (!g_feed.base) return;
+    
+    spectator_publish(&g_feed, frame_export(&g_feed_frames, &g_game));
+}
+
 void init_game(void) {
     if (g_initialized) return;
     
-    memset(&g_game, 0, sizeof(TetrisGame_t));
-    g_game.state = STATE_START;
+    init_game_with_geometry(BOARD_WIDTH, BOARD_HEIGHT);
+}
+
+bool init_game_with_geometry(int width, int height) {
+    if (g_initialized) {
+        if (g_game.board.width == width && g_game.board.height == height) {
+            return true;
+        }
+        cleanup_game();
+    }
+    
+    if (!game_init(&g_game, width, height)) {
+        return false;
+    }
+    g_colors = calloc((size_t)height * COLOR_PLANES, sizeof(uint64_t));
+    if (!g_colors) {
+        game_destroy(&g_game);
+        return false;
+    }
     g_game.high_score = load_high_score();
-    g_game.speed = 48;
-    g_game.level = 1;
     
     g_initialized = true;
+    return true;
 }
 
 void cleanup_game(void) {
     if (g_game.score > 0) {
         save_high_score(g_game.high_score);
     }
+    game_destroy(&g_game);
+    free(g_colors);
+    g_colors = NULL;
+    frame_export_free(&g_frames);
+    disable_spectator_feed();
+    disable_telemetry();
     g_initialized = false;
 }
 
+int get_board_width(void) {
+    return g_initialized ? g_game.board.width : BOARD_WIDTH;
+}
+
+int get_board_height(void) {
+    return g_initialized ? g_game.board.height : BOARD_HEIGHT;
+}
+
+int get_preview_queue(const uint8_t **types) {
+    int count = 0;
+    const uint8_t *view = g_initialized ? piece_queue_view(&g_game, &count) : NULL;
+    if (types) *types = view;
+    return count;
+}
+
+int get_hold_piece(void) {
+    return g_initialized ? g_game.hold_piece : -1;
+}
+
+bool set_preview_count(int count) {
+    if (!g_initialized) {
+        init_game();
+    }
+    return piece_queue_set_preview(&g_game, count);
+}
+
+const uint64_t *get_field_colors(void) {
+    if (!g_initialized) return NULL;
+    
+    frame_compose_colors(&g_game, g_colors);
+    return g_colors;
+}
+
+uint64_t get_state_hash(void) {
+    return g_initialized ? game_hash(&g_game) : 0;
+}
+
 void prepare_game_info(GameInfo_t *info) {
     if (!info) return;
     
-    allocate_field_memory(&info->field, BOARD_HEIGHT, BOARD_WIDTH);
+    const Board_t *board = &g_game.board;
+    
+    allocate_field_memory(&info->field, board->height, board->width);
     allocate_field_memory(&info->next, PIECE_SIZE, PIECE_SIZE);
     
     // Copy visible game field (excluding spawn area)
-    for (int y = 0; y < BOARD_HEIGHT; y++) {
-        for (int x = 0; x < BOARD_WIDTH; x++) {
-            info->field[y][x] = g_game.board[y + BOARD_EXTRA_HEIGHT][x];
+    for (int y = 0; y < board->height; y++) {
+        uint64_t row = board->kernels->get_row(board, y + BOARD_EXTRA_HEIGHT);
+        for (int x = 0; x < board->width; x++) {
+            info->field[y][x] = (row >> x) & 1;
         }
     }
     
     // Draw current piece on field if it's visible
     if (g_game.state == STATE_MOVING || g_game.state == STATE_SHIFTING) {
-        for (int i = 0; i < PIECE_SIZE; i++) {
-            for (int j = 0; j < PIECE_SIZE; j++) {
-                if (g_game.current_piece.shape[i][j]) {
-                    int board_x = g_game.current_piece.x + j;
-                    int board_y = g_game.current_piece.y + i - BOARD_EXTRA_HEIGHT;
-                    
-                    if (board_x >= 0 && board_x < BOARD_WIDTH && 
-                        board_y >= 0 && board_y < BOARD_HEIGHT) {
-                        info->field[board_y][board_x] = 1;
-                    }
-                }
+        const Piece_t *piece = &g_game.current_piece;
+        const PieceCell_t *cells = piece_cells[piece->type][piece->rotation & 3];
+
+        for (int i = 0; i < PIECE_CELLS; i++) {
+            int board_x = piece->x + cells[i].x;
+            int board_y = piece->y + cells[i].y - BOARD_EXTRA_HEIGHT;
+
+            if (board_x >= 0 && board_x < board->width &&
+                board_y >= 0 && board_y < board->height) {
+                info->field[board_y][board_x] = 1;
             }
         }
     }
     
     // Copy next piece
+    int preview_count;
+    const uint8_t *preview = piece_queue_view(&g_game, &preview_count);
     for (int i = 0; i < PIECE_SIZE; i++) {
         for (int j = 0; j < PIECE_SIZE; j++) {
-            info->next[i][j] = g_game.next_piece.shape[i][j];
+            info->next[i][j] = preview_count ? piece_templates[preview[0]][0][i][j] : 0;
         }
     }
     
@@ -139,4 +293,117 @@ int load_high_score(void) {
     }
     
     return score;
-}
\ No newline at end of file
+}
+
+// Runtime adapter over g_game; see tetris_game_vtable in tetris_game.h
+static void *tetris_create(uint64_t seed) {
+    if (g_runtime_open) return NULL;
+    
+    // Frames are sized for the classic field; a game someone else set up
+    // with another geometry is theirs and is never reinitialised here
+    bool owned = !g_initialized;
+    if (!owned && (g_game.board.width != BOARD_WIDTH || g_game.board.height != BOARD_HEIGHT)) {
+        return NULL;
+    }
+    if (owned && !init_game_with_geometry(BOARD_WIDTH, BOARD_HEIGHT)) {
+        return NULL;
+    }
+    if (g_frames.width != BOARD_WIDTH || g_frames.height != BOARD_HEIGHT) {
+        frame_export_free(&g_frames);
+        if (!frame_export_init(&g_frames, BOARD_WIDTH, BOARD_HEIGHT)) {
+            if (owned) cleanup_game();
+            return NULL;
+        }
+    }
+    seed_piece_generator(&g_game, seed);
+    g_runtime_open = true;
+    g_runtime_owned = owned;
+    return &g_game;
+}
+
+static void tetris_destroy(void *game) {
+    (void)game;
+    if (g_runtime_owned) {
+        cleanup_game();
+    }
+    g_runtime_open = false;
+    g_runtime_owned = false;
+}
+
+static void tetris_input(void *game, UserAction_t action, bool hold) {
+    fsm_process_action(game, action, hold);
+}
+
+static void tetris_step(void *game) {
+    fsm_tick(game, FSM_IDLE, false);
+}
+
+static uint64_t tetris_version(const void *game) {
+    return ((const TetrisGame_t *)game)->version;
+}
+
+// Called only when the version moved, which is also when spectators need a frame
+static void tetris_export(void *game, GameFrame_t *frame) {
+    const FrameView_t *view = frame_export(&g_frames, game);
+
+    frame->width = view->width;
+    frame->height = view->height;
+    memcpy(frame->rows, view->rows, (size_t)view->height * sizeof(uint64_t));
+    memcpy(frame->colors, view->colors, (size_t)view->height * COLOR_PLANES * sizeof(uint64_t));
+    frame->next = view->next;
+    frame->next_color = view->preview_count ? view->preview[0] : -1;
+    frame->preview_count = view->preview_count;
+    memcpy(frame->preview, view->preview, (size_t)view->preview_count);
+    frame->hold = view->hold;
+    frame->score = view->score;
+    frame->high_score = view->high_score;
+    frame->level = view->level;
+    frame->speed = view->speed;
+    frame->pause = view->pause;
+    publish_spectator_frame();
+}
+
+static const char *const tetris_controls[] = {
+    "Controls:", "A/D - Move", "S - Drop", "W - Rotate", "P - Pause", "Q - Quit",
+    "R - Restart", "C - Hold", NULL,
+};
+
+static const char *const tetris_help[] = {
+    "TETRIS - Instructions",
+    "",
+    "Arrange falling pieces to form complete horizontal lines.",
+    "Complete lines will disappear and award points.",
+    "Game ends when pieces reach the top.",
+    "",
+    "Controls:",
+    "  A/Left - Move left",
+    "  D/Right - Move right",
+    "  S/Down - Soft drop",
+    "  W/Up/Space - Rotate piece",
+    "  P - Pause/Resume",
+    "  R - Restart game",
+    "  Q/ESC - Quit",
+    "  C - Hold piece",
+    "Scoring:",
+    "  1 line  = 100 points",
+    "  2 lines = 300 points",
+    "  3 lines = 700 points",
+    "  4 lines = 1500 points",
+    "",
+    "Press R to start playing!",
+    NULL,
+};
+
+const GameVtable_t tetris_game_vtable = {
+    .name = "tetris",
+    .title = "TETRIS",
+    .speed_label = "Speed",
+    .controls = tetris_controls,
+    .help = tetris_help,
+    .create = tetris_create,
+    .destroy = tetris_destroy,
+    .input = tetris_input,
+    .step = tetris_step,
+    .version = tetris_version,
+    .export_frame = tetris_export,
+};
@@ -2,17 +2,56 @@
 #define TETRIS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "tetris_types.h"
+#include "tetris_frame.h"
 
 // Main API functions as specified in requirements
 void userInput(UserAction_t action, bool hold);
 GameInfo_t updateCurrentState(void);
 
+// Packed alternative to updateCurrentState() with deltas since the last call
+const FrameView_t *updateCurrentFrame(void);
+
+// Bumped whenever the board, falling piece, queue, score, level or pause
+// flag change, and never 0. A frontend that already drew this version can
+// call update_game_timer() instead of updateCurrentState() and skip both
+// building the GameInfo_t and its draw.
+uint64_t tetris_state_version(void);
+// Advances gravity like updateCurrentState() does, without building anything
+void update_game_timer(void);
+
 // Additional helper functions
 void init_game(void);
+bool init_game_with_geometry(int width, int height);
+int get_board_width(void);
+int get_board_height(void);
+
+// Upcoming piece types (PieceType_t values, next first) as a read-only view
+// into the game's queue, valid until the next userInput(); hold is -1 when
+// the slot is empty
+int get_preview_queue(const uint8_t **types);
+int get_hold_piece(void);
+bool set_preview_count(int count);
+
+// Colour planes of the visible field, falling piece included, laid out as
+// FrameView_t.colors; valid until the next call
+const uint64_t *get_field_colors(void);
+
+// Hash of the board and falling piece; equal states hash equal
+uint64_t get_state_hash(void);
 void cleanup_game(void);
 void save_high_score(int score);
 int load_high_score(void);
 void free_field_memory(int **field, int height);
 
+// Publishes every state update to a POSIX shared-memory spectator feed
+bool enable_spectator_feed(const char *name);
+void disable_spectator_feed(void);
+
+// Writes a record per locked piece to path (see tetris_telemetry.h) until
+// disabled or cleanup_game(); disabling reports whether every write landed
+bool enable_telemetry(const char *path);
+bool disable_telemetry(void);
+
 #endif  // TETRIS_H
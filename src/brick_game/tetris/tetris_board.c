@@ -0,0 +1,250 @@
+#include "tetris_board.h"
+#include "tetris_piece_tables.h"
+#include "tetris_rowscan.h"
+#include <stdlib.h>
+#include <string.h>
+
+unsigned piece_row_mask(const Piece_t *piece, int row) {
+    return piece_row_masks[piece->type][piece->rotation & 3][row];
+}
+
+// Move a piece row to column x; false if any cell would leave the board
+static inline bool shift_row_mask(const Board_t *board, uint64_t *bits, int x) {
+    if (x < 0) {
+        if (x <= -PIECE_SIZE || (*bits & ((1u << -x) - 1))) return false;
+        *bits >>= -x;
+    } else {
+        if (x >= board->width) return false;
+        uint64_t shifted = *bits << x;
+        if ((shifted >> x) != *bits) return false;
+        *bits = shifted;
+    }
+
+    return (*bits & ~board->full_row) == 0;
+}
+
+// Same as shift_row_mask() but drops cells outside the board
+static inline uint64_t clip_row_mask(uint64_t bits, int x) {
+    if (x <= -PIECE_SIZE || x >= 64) return 0;
+    return x < 0 ? bits >> -x : bits << x;
+}
+
+#define KERNEL_CAT_(name, bits) name##_##bits
+#define KERNEL_CAT(name, bits) KERNEL_CAT_(name, bits)
+#define KERNEL(name) KERNEL_CAT(name, ROW_BITS)
+#define ROWS_CLEAR_FN_(bits, isa) rows_clear_full_##bits##_##isa
+#define ROWS_CLEAR_FN(bits, isa) ROWS_CLEAR_FN_(bits, isa)
+
+#define ROW_BITS 16
+#define ROW_T uint16_t
+#include "tetris_board_kernels.h"
+#undef ROW_T
+#undef ROW_BITS
+
+#define ROW_BITS 32
+#define ROW_T uint32_t
+#include "tetris_board_kernels.h"
+#undef ROW_T
+#undef ROW_BITS
+
+#define ROW_BITS 64
+#define ROW_T uint64_t
+#include "tetris_board_kernels.h"
+#undef ROW_T
+#undef ROW_BITS
+
+// Dispatch table indexed by row width class, then by instruction set level
+static const BoardKernels_t *const board_kernel_table[] = {
+    board_kernels_16,
+    board_kernels_32,
+    board_kernels_64,
+};
+
+static const BoardKernels_t *select_kernels(int width) {
+    RowScanLevel_t level = rowscan_best_level();
+    
+    if (width <= 16) return &board_kernel_table[0][level];
+    if (width <= 32) return &board_kernel_table[1][level];
+    return &board_kernel_table[2][level];
+}
+
+bool board_init(Board_t *board, int width, int height) {
+    if (!board) return false;
+    if (width < BOARD_MIN_WIDTH || width > BOARD_MAX_WIDTH ||
+        height < BOARD_MIN_HEIGHT || height > BOARD_MAX_HEIGHT) {
+        return false;
+    }
+
+    const BoardKernels_t *kernels = select_kernels(width);
+    void *rows = calloc(height + BOARD_EXTRA_HEIGHT, kernels->row_bits / 8);
+    if (!rows) return false;
+
+    board->width = width;
+    board->height = height;
+    board->total_height = height + BOARD_EXTRA_HEIGHT;
+    board->full_row = width == 64 ? UINT64_MAX : (UINT64_C(1) << width) - 1;
+    board->rows = rows;
+    board->colors = NULL;
+    board->kernels = kernels;
+
+    return true;
+}
+
+bool board_enable_colors(Board_t *board) {
+    if (!board || !board->rows) return false;
+    if (board->colors) return true;
+
+    board->colors = calloc((size_t)board->total_height * COLOR_PLANES, sizeof(uint64_t));
+    return board->colors != NULL;
+}
+
+void board_free(Board_t *board) {
+    if (!board) return;
+
+    free(board->rows);
+    free(board->colors);
+    board->rows = NULL;
+    board->colors = NULL;
+    board->kernels = NULL;
+}
+
+void board_clear(Board_t *board) {
+    if (!board || !board->rows) return;
+
+    memset(board->rows, 0, (size_t)board->total_height * board_row_bytes(board));
+    if (board->colors) {
+        memset(board->colors, 0, (size_t)board->total_height * COLOR_PLANES * sizeof(uint64_t));
+    }
+}
+
+bool board_copy(Board_t *dst, const Board_t *src) {
+    if (!dst || !src || dst->width != src->width || dst->total_height != src->total_height) {
+        return false;
+    }
+
+    memcpy(dst->rows, src->rows, (size_t)src->total_height * board_row_bytes(src));
+    if (dst->colors && src->colors) {
+        memcpy(dst->colors, src->colors,
+               (size_t)src->total_height * COLOR_PLANES * sizeof(uint64_t));
+    }
+    return true;
+}
+
+int board_row_bytes(const Board_t *board) {
+    return board->kernels->row_bits / 8;
+}
+
+bool board_get_cell(const Board_t *board, int x, int y) {
+    return (board->kernels->get_row(board, y) >> x) & 1;
+}
+
+void board_set_cell(Board_t *board, int x, int y, bool filled) {
+    uint64_t row = board->kernels->get_row(board, y);
+    uint64_t bit = UINT64_C(1) << x;
+
+    board->kernels->set_row(board, y, filled ? row | bit : row & ~bit);
+    if (board->colors) {
+        color_planes_set(board->colors + (size_t)y * COLOR_PLANES, bit, filled ? CELL_GARBAGE : 0);
+    }
+}
+
+int board_get_color(const Board_t *board, int x, int y) {
+    if (!board->colors) return CELL_GARBAGE;
+
+    const uint64_t *planes = board->colors + (size_t)y * COLOR_PLANES;
+    int color = 0;
+    for (int k = 0; k < COLOR_PLANES; k++) {
+        color |= (int)((planes[k] >> x) & 1) << k;
+    }
+    return color;
+}
+
+void board_color_piece(Board_t *board, const Piece_t *piece) {
+    if (!board->colors) return;
+
+    for (int i = 0; i < PIECE_SIZE; i++) {
+        uint64_t bits = piece_row_mask(piece, i);
+        int y = piece->y + i;
+
+        if (bits && y >= 0 && y < board->total_height) {
+            bits = clip_row_mask(bits, piece->x) & board->full_row;
+            color_planes_set(board->colors + (size_t)y * COLOR_PLANES, bits, piece->type);
+        }
+    }
+}
+
+void board_color_clear_lines(Board_t *board, int first, int last) {
+    if (!board->colors) return;
+    // The row kernels never clear the spawn area
+    if (first < BOARD_EXTRA_HEIGHT) first = BOARD_EXTRA_HEIGHT;
+    if (last >= board->total_height) last = board->total_height - 1;
+
+    int full = 0;
+    for (int y = first; y <= last; y++) {
+        full += board->kernels->get_row(board, y) == board->full_row;
+    }
+    if (!full) return;
+
+    // Same compaction as the row kernels: keep the rows that are not full,
+    // bottom first, and open empty rows at the top
+    uint64_t *colors = board->colors;
+    int dst = last;
+    for (int src = last; src >= 0; src--) {
+        if (src >= first && board->kernels->get_row(board, src) == board->full_row) continue;
+        if (dst != src) {
+            memcpy(colors + (size_t)dst * COLOR_PLANES, colors + (size_t)src * COLOR_PLANES,
+                   COLOR_PLANES * sizeof(uint64_t));
+        }
+        dst--;
+    }
+    memset(colors, 0, (size_t)(dst + 1) * COLOR_PLANES * sizeof(uint64_t));
+}
+
+bool board_push_garbage(Board_t *board, int rows, uint64_t garbage) {
+    if (rows > board->total_height) rows = board->total_height;
+
+    bool kept = true;
+    for (int y = 0; y < rows; y++) {
+        kept &= board->kernels->get_row(board, y) == 0;
+    }
+
+    // Rows are contiguous words, so the shift is one overlapping move
+    int row_bytes = board_row_bytes(board);
+    char *base = board->rows;
+    memmove(base, base + (size_t)rows * row_bytes,
+            (size_t)(board->total_height - rows) * row_bytes);
+    for (int y = board->total_height - rows; y < board->total_height; y++) {
+        board->kernels->set_row(board, y, garbage);
+    }
+
+    if (board->colors) {
+        uint64_t *colors = board->colors;
+        size_t row_words = COLOR_PLANES;
+        memmove(colors, colors + (size_t)rows * row_words,
+                (size_t)(board->total_height - rows) * row_words * sizeof(uint64_t));
+        for (int y = board->total_height - rows; y < board->total_height; y++) {
+            memset(colors + (size_t)y * row_words, 0, row_words * sizeof(uint64_t));
+            color_planes_set(colors + (size_t)y * row_words, garbage & board->full_row,
+                             CELL_GARBAGE);
+        }
+    }
+    return kept;
+}
+
+int board_stack_height(const Board_t *board) {
+    for (int y = 0; y < board->total_height; y++) {
+        if (board->kernels->get_row(board, y)) {
+            return board->total_height - y;
+        }
+    }
+    return 0;
+}
+
+bool board_spawn_area_occupied(const Board_t *board) {
+    for (int y = 0; y < BOARD_EXTRA_HEIGHT; y++) {
+        if (board->kernels->get_row(board, y)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,55 @@
+#ifndef TETRIS_BOARD_H
+#define TETRIS_BOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_types.h"
+
+// Kernels specialised for one row word size, selected once in board_init()
+typedef struct BoardKernels_s {
+    int row_bits;
+    uint64_t (*get_row)(const Board_t *board, int y);
+    void (*set_row)(Board_t *board, int y, uint64_t bits);
+    bool (*fits)(const Board_t *board, const Piece_t *piece);
+    void (*place)(Board_t *board, const Piece_t *piece);
+    int (*clear_lines)(Board_t *board);
+} BoardKernels_t;
+
+// Board lifecycle
+bool board_init(Board_t *board, int width, int height);
+void board_free(Board_t *board);
+void board_clear(Board_t *board);
+bool board_copy(Board_t *dst, const Board_t *src);
+
+// Helpers shared by all row widths
+int board_row_bytes(const Board_t *board);
+bool board_get_cell(const Board_t *board, int x, int y);
+void board_set_cell(Board_t *board, int x, int y, bool filled);
+bool board_spawn_area_occupied(const Board_t *board);
+// Rows from the highest filled one down to the floor; 0 for an empty board
+int board_stack_height(const Board_t *board);
+// Pushes the stack up and fills the bottom rows with garbage; false when
+// filled rows were pushed off the top
+bool board_push_garbage(Board_t *board, int rows, uint64_t garbage);
+unsigned piece_row_mask(const Piece_t *piece, int row);
+
+// Cell colours live in bit-planes beside the occupancy rows, so collision
+// tests never touch them: bit x of colors[y * COLOR_PLANES + k] is bit k of
+// cell (x, y)'s colour. Only boards that enable them keep colours, and only
+// the game-level place, clear and garbage paths update them.
+bool board_enable_colors(Board_t *board);
+int board_get_color(const Board_t *board, int x, int y);
+// Colours the cells piece covers
+void board_color_piece(Board_t *board, const Piece_t *piece);
+// Moves colours the way clear_lines() will move rows in [first, last];
+// call before clearing
+void board_color_clear_lines(Board_t *board, int first, int last);
+
+// Sets the colour of the cells in mask within one row's planes
+static inline void color_planes_set(uint64_t *planes, uint64_t mask, int color) {
+    for (int k = 0; k < COLOR_PLANES; k++) {
+        planes[k] = (color >> k) & 1 ? planes[k] | mask : planes[k] & ~mask;
+    }
+}
+
+#endif  // TETRIS_BOARD_H
@@ -0,0 +1,81 @@
+// Row kernel template, included by tetris_board.c once per row width.
+// Expects ROW_BITS (16, 32 or 64) and ROW_T to be defined, so there is
+// deliberately no include guard.
+
+static uint64_t KERNEL(get_row)(const Board_t *board, int y) {
+    return ((const ROW_T *)board->rows)[y];
+}
+
+static void KERNEL(set_row)(Board_t *board, int y, uint64_t bits) {
+    ((ROW_T *)board->rows)[y] = (ROW_T)(bits & board->full_row);
+}
+
+static bool KERNEL(fits)(const Board_t *board, const Piece_t *piece) {
+    const ROW_T *rows = board->rows;
+    const uint8_t *masks = piece_row_masks[piece->type][piece->rotation & 3];
+    const PieceExtent_t *extent = &piece_extents[piece->type][piece->rotation & 3];
+
+    for (int i = extent->top; i <= extent->bottom; i++) {
+        uint64_t bits = masks[i];
+
+        int y = piece->y + i;
+        if (y >= board->total_height || !shift_row_mask(board, &bits, piece->x)) {
+            return false;
+        }
+
+        // Rows above the board are always free
+        if (y >= 0 && (rows[y] & (ROW_T)bits)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void KERNEL(place)(Board_t *board, const Piece_t *piece) {
+    ROW_T *rows = board->rows;
+    const uint8_t *masks = piece_row_masks[piece->type][piece->rotation & 3];
+    const PieceExtent_t *extent = &piece_extents[piece->type][piece->rotation & 3];
+
+    for (int i = extent->top; i <= extent->bottom; i++) {
+        uint64_t bits = masks[i];
+        int y = piece->y + i;
+
+        if (y >= 0 && y < board->total_height) {
+            rows[y] |= (ROW_T)(clip_row_mask(bits, piece->x) & board->full_row);
+        }
+    }
+}
+
+// Line clear entry points, one per instruction set level
+static int KERNEL(clear_lines_scalar)(Board_t *board) {
+    return ROWS_CLEAR_FN(ROW_BITS, scalar)(board->rows, board->total_height,
+                                           BOARD_EXTRA_HEIGHT, (ROW_T)board->full_row);
+}
+
+static int KERNEL(clear_lines_sse2)(Board_t *board) {
+    return ROWS_CLEAR_FN(ROW_BITS, sse2)(board->rows, board->total_height,
+                                         BOARD_EXTRA_HEIGHT, (ROW_T)board->full_row);
+}
+
+static int KERNEL(clear_lines_avx2)(Board_t *board) {
+    return ROWS_CLEAR_FN(ROW_BITS, avx2)(board->rows, board->total_height,
+                                         BOARD_EXTRA_HEIGHT, (ROW_T)board->full_row);
+}
+
+#define BOARD_KERNELS_FOR(clear) { \
+    .row_bits = ROW_BITS, \
+    .get_row = KERNEL(get_row), \
+    .set_row = KERNEL(set_row), \
+    .fits = KERNEL(fits), \
+    .place = KERNEL(place), \
+    .clear_lines = KERNEL(clear), \
+}
+
+static const BoardKernels_t KERNEL(board_kernels)[ROWSCAN_LEVEL_COUNT] = {
+    [ROWSCAN_SCALAR] = BOARD_KERNELS_FOR(clear_lines_scalar),
+    [ROWSCAN_SSE2] = BOARD_KERNELS_FOR(clear_lines_sse2),
+    [ROWSCAN_AVX2] = BOARD_KERNELS_FOR(clear_lines_avx2),
+};
+
+#undef BOARD_KERNELS_FOR
@@ -0,0 +1,191 @@
+#include "tetris_bot.h"
+#include "tetris_board.h"
+#include "tetris_fsm.h"
+#include "tetris_piece_tables.h"
+#include "tetris_pieces.h"
+#include <float.h>
+#include <string.h>
+
+// Give up steering and hard drop after this many actions on one piece
+#define BOT_MAX_STEPS 32
+
+void bot_default_weights(BotWeights_t *weights) {
+    weights->lines = 0.76;
+    weights->holes = 0.36;
+    weights->height = 0.51;
+    weights->bumpiness = 0.18;
+    weights->wells = 0.05;
+    weights->row_transitions = 0.05;
+    weights->column_transitions = 0.05;
+}
+
+bool bot_init(Bot_t *bot, const TetrisGame_t *game, const BotWeights_t *weights) {
+    if (!bot || !game) return false;
+
+    memset(bot, 0, sizeof(Bot_t));
+    if (weights) {
+        bot->weights = *weights;
+    } else {
+        bot_default_weights(&bot->weights);
+    }
+    bot->planned_piece = -1;
+
+    return board_init(&bot->scratch, game->board.width, game->board.height);
+}
+
+void bot_free(Bot_t *bot) {
+    if (!bot) return;
+
+    board_free(&bot->scratch);
+}
+
+void bot_features(const Board_t *board, int lines, BotFeatures_t *features) {
+    const uint64_t full = board->full_row;
+    const int width = board->width;
+    const uint64_t right_wall = UINT64_C(1) << (width - 1);
+    int heights[BOARD_MAX_WIDTH] = {0};
+    uint64_t seen = 0;
+    uint64_t above = 0;
+
+    memset(features, 0, sizeof(BotFeatures_t));
+    features->lines = lines;
+
+    // Rows above the stack add nothing to any feature
+    for (int y = board->total_height - board_stack_height(board); y < board->total_height; y++) {
+        uint64_t row = board->kernels->get_row(board, y);
+
+        // First filled cell from the top fixes a column's height
+        for (uint64_t fresh = row & ~seen; fresh; fresh &= fresh - 1) {
+            heights[__builtin_ctzll(fresh)] = board->total_height - y;
+        }
+        seen |= row;
+        features->holes += __builtin_popcountll(~row & seen & full);
+
+        // Transitions only count from the top of the stack down
+        if (seen) {
+            features->row_transitions += __builtin_popcountll((row ^ (row >> 1)) & (full >> 1)) +
+                                         !(row & 1) + !(row & right_wall);
+            features->column_transitions += __builtin_popcountll((row ^ above) & full);
+        }
+
+        // Empty cells with both neighbours filled; walls count as filled
+        uint64_t left = (row << 1) | 1;
+        uint64_t right = (row >> 1) | right_wall;
+        features->wells += __builtin_popcountll(~row & left & right & full);
+
+        above = row;
+    }
+    features->column_transitions += __builtin_popcountll(~above & full);
+
+    for (int x = 0; x < width; x++) {
+        features->aggregate_height += heights[x];
+        if (x + 1 < width) {
+            int diff = heights[x] - heights[x + 1];
+            features->bumpiness += diff < 0 ? -diff : diff;
+        }
+    }
+}
+
+double bot_score(const BotFeatures_t *features, const BotWeights_t *weights) {
+    return weights->lines * features->lines -
+           weights->holes * features->holes -
+           weights->height * features->aggregate_height -
+           weights->bumpiness * features->bumpiness -
+           weights->wells * features->wells -
+           weights->row_transitions * features->row_transitions -
+           weights->column_transitions * features->column_transitions;
+}
+
+BotMove_t bot_best_move(Bot_t *bot, const TetrisGame_t *game) {
+    const Board_t *board = &game->board;
+    BotMove_t best = {0, 0, -DBL_MAX, false};
+
+    Piece_t piece;
+    init_piece(&piece, game->current_piece.type);
+
+    for (int rotation = 0; rotation < 4; rotation++) {
+        if (rotation > 0) rotate_piece(&piece);
+
+        // Symmetric pieces repeat shapes up to a shift, and every column is
+        // tried anyway; score each distinct shape once
+        if (piece_canonical_rotation[piece.type][rotation] != rotation) continue;
+
+        for (int x = 1 - PIECE_SIZE; x < board->width; x++) {
+            piece.x = x;
+            piece.y = game->current_piece.y;
+            if (!board->kernels->fits(board, &piece)) continue;
+
+            while (board->kernels->fits(board, &piece)) {
+                piece.y++;
+            }
+            piece.y--;
+
+            board_copy(&bot->scratch, board);
+            bot->scratch.kernels->place(&bot->scratch, &piece);
+            int lines = bot->scratch.kernels->clear_lines(&bot->scratch);
+
+            BotFeatures_t features;
+            bot_features(&bot->scratch, lines, &features);
+            double score = bot_score(&features, &bot->weights);
+
+            if (score > best.score) {
+                best.rotation = rotation;
+                best.x = x;
+                best.score = score;
+                best.valid = true;
+            }
+        }
+    }
+
+    return best;
+}
+
+bool bot_next_input(Bot_t *bot, const TetrisGame_t *game, UserAction_t *action, bool *hold) {
+    *hold = false;
+    switch (game->state) {
+        case STATE_GAME_OVER:
+            return false;
+        case STATE_START:
+            *action = Start;
+            return true;
+        case STATE_MOVING:
+            break;
+        default:
+            // Spawn, shift and attach ignore the action (Up only holds while moving)
+            *action = Up;
+            return true;
+    }
+
+    if (bot->planned_piece != game->pieces_spawned) {
+        bot->target = bot_best_move(bot, game);
+        bot->planned_piece = game->pieces_spawned;
+        bot->steps = 0;
+    }
+
+    const Piece_t *piece = &game->current_piece;
+    *action = Down;
+    *hold = true;
+
+    if (bot->target.valid && bot->steps++ < BOT_MAX_STEPS) {
+        if (piece->rotation != bot->target.rotation) {
+            *action = Action;
+            *hold = false;
+        } else if (piece->x < bot->target.x) {
+            *action = Right;
+            *hold = false;
+        } else if (piece->x > bot->target.x) {
+            *action = Left;
+            *hold = false;
+        }
+    }
+    return true;
+}
+
+bool bot_play(Bot_t *bot, TetrisGame_t *game) {
+    UserAction_t action;
+    bool hold;
+    if (!bot_next_input(bot, game, &action, &hold)) return false;
+
+    fsm_process_action(game, action, hold);
+    return true;
+}
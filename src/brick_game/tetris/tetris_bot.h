@@ -0,0 +1,60 @@
+#ifndef TETRIS_BOT_H
+#define TETRIS_BOT_H
+
+#include <stdbool.h>
+#include "tetris_types.h"
+
+// Board features scored by the bot; all are "lower is better" except lines
+typedef struct {
+    int lines;
+    int holes;
+    int aggregate_height;
+    int bumpiness;
+    int wells;
+    int row_transitions;
+    int column_transitions;
+} BotFeatures_t;
+
+// Linear evaluation weights, one per feature
+typedef struct {
+    double lines;
+    double holes;
+    double height;
+    double bumpiness;
+    double wells;
+    double row_transitions;
+    double column_transitions;
+} BotWeights_t;
+
+// A final placement: rotate to rotation, shift to x, hard drop
+typedef struct {
+    int rotation;
+    int x;
+    double score;
+    bool valid;
+} BotMove_t;
+
+// Per-game bot state; owns its scratch board so bots are reentrant
+typedef struct {
+    BotWeights_t weights;
+    Board_t scratch;
+    BotMove_t target;
+    int planned_piece;
+    int steps;
+} Bot_t;
+
+void bot_default_weights(BotWeights_t *weights);
+bool bot_init(Bot_t *bot, const TetrisGame_t *game, const BotWeights_t *weights);
+void bot_free(Bot_t *bot);
+
+void bot_features(const Board_t *board, int lines, BotFeatures_t *features);
+double bot_score(const BotFeatures_t *features, const BotWeights_t *weights);
+BotMove_t bot_best_move(Bot_t *bot, const TetrisGame_t *game);
+
+// Next input for the game without applying it; false once the game is over
+bool bot_next_input(Bot_t *bot, const TetrisGame_t *game, UserAction_t *action, bool *hold);
+
+// Feeds one action into the game; false once the game is over
+bool bot_play(Bot_t *bot, TetrisGame_t *game);
+
+#endif  // TETRIS_BOT_H
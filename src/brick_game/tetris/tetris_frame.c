@@ -0,0 +1,182 @@
+#include "tetris_frame.h"
+#include "tetris_board.h"
+#include "tetris_piece_tables.h"
+#include "tetris_pieces.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int dirty_words(int height) {
+    return (height + 63) / 64;
+}
+
+bool frame_export_init(FrameExport_t *fx, int width, int height) {
+    if (!fx) return false;
+
+    memset(fx, 0, sizeof(FrameExport_t));
+    fx->width = width;
+    fx->height = height;
+    fx->rows = calloc(height, sizeof(uint64_t));
+    fx->prev_rows = calloc(height, sizeof(uint64_t));
+    fx->colors = calloc((size_t)height * COLOR_PLANES, sizeof(uint64_t));
+    fx->prev_colors = calloc((size_t)height * COLOR_PLANES, sizeof(uint64_t));
+    fx->dirty_rows = calloc(dirty_words(height), sizeof(uint64_t));
+    fx->changes = malloc((size_t)width * height * sizeof(CellChange_t));
+
+    if (!fx->rows || !fx->prev_rows || !fx->colors || !fx->prev_colors || !fx->dirty_rows ||
+        !fx->changes) {
+        frame_export_free(fx);
+        return false;
+    }
+
+    return true;
+}
+
+void frame_export_free(FrameExport_t *fx) {
+    if (!fx) return;
+
+    free(fx->rows);
+    free(fx->prev_rows);
+    free(fx->colors);
+    free(fx->prev_colors);
+    free(fx->dirty_rows);
+    free(fx->changes);
+    memset(fx, 0, sizeof(FrameExport_t));
+}
+
+// Visible board rows with the falling piece drawn in
+static void compose_rows(const TetrisGame_t *game, uint64_t *rows) {
+    const Board_t *board = &game->board;
+
+    for (int y = 0; y < board->height; y++) {
+        rows[y] = board->kernels->get_row(board, y + BOARD_EXTRA_HEIGHT);
+    }
+
+    if (game->state == STATE_MOVING || game->state == STATE_SHIFTING) {
+        const Piece_t *piece = &game->current_piece;
+
+        for (int i = 0; i < PIECE_SIZE; i++) {
+            uint64_t bits = piece_row_mask(piece, i);
+            int y = piece->y + i - BOARD_EXTRA_HEIGHT;
+
+            if (!bits || y < 0 || y >= board->height) continue;
+            bits = piece->x < 0 ? bits >> -piece->x : bits << piece->x;
+            rows[y] |= bits & board->full_row;
+        }
+    }
+}
+
+void frame_compose_colors(const TetrisGame_t *game, uint64_t *planes) {
+    const Board_t *board = &game->board;
+
+    // Empty cells are 0 whatever the board's planes hold there
+    for (int y = 0; y < board->height; y++) {
+        uint64_t occupied = board->kernels->get_row(board, y + BOARD_EXTRA_HEIGHT);
+        uint64_t *row = planes + (size_t)y * COLOR_PLANES;
+        if (board->colors) {
+            const uint64_t *src = board->colors + (size_t)(y + BOARD_EXTRA_HEIGHT) * COLOR_PLANES;
+            for (int k = 0; k < COLOR_PLANES; k++) {
+                row[k] = src[k] & occupied;
+            }
+        } else {
+            for (int k = 0; k < COLOR_PLANES; k++) {
+                row[k] = (CELL_GARBAGE >> k) & 1 ? occupied : 0;
+            }
+        }
+    }
+
+    if (game->state == STATE_MOVING || game->state == STATE_SHIFTING) {
+        const Piece_t *piece = &game->current_piece;
+
+        for (int i = 0; i < PIECE_SIZE; i++) {
+            uint64_t bits = piece_row_mask(piece, i);
+            int y = piece->y + i - BOARD_EXTRA_HEIGHT;
+
+            if (!bits || y < 0 || y >= board->height) continue;
+            bits = piece->x < 0 ? bits >> -piece->x : bits << piece->x;
+            color_planes_set(planes + (size_t)y * COLOR_PLANES, bits & board->full_row,
+                             piece->type);
+        }
+    }
+}
+
+int frame_cell_color(const uint64_t *colors, int x, int y) {
+    const uint64_t *planes = colors + (size_t)y * COLOR_PLANES;
+    int color = 0;
+    for (int k = 0; k < COLOR_PLANES; k++) {
+        color |= (int)((planes[k] >> x) & 1) << k;
+    }
+    return color;
+}
+
+const FrameView_t *frame_export(FrameExport_t *fx, const TetrisGame_t *game) {
+    if (!fx || !game || !fx->rows) return NULL;
+    if (fx->width != game->board.width || fx->height != game->board.height) return NULL;
+
+    // The previous frame becomes the reference for the delta
+    uint64_t *prev = fx->rows;
+    fx->rows = fx->prev_rows;
+    fx->prev_rows = prev;
+    prev = fx->colors;
+    fx->colors = fx->prev_colors;
+    fx->prev_colors = prev;
+
+    compose_rows(game, fx->rows);
+    frame_compose_colors(game, fx->colors);
+    memset(fx->dirty_rows, 0, dirty_words(fx->height) * sizeof(uint64_t));
+
+    int dirty_count = 0;
+    int change_count = 0;
+
+    for (int y = 0; y < fx->height; y++) {
+        const uint64_t *colors = fx->colors + (size_t)y * COLOR_PLANES;
+        const uint64_t *prev_colors = fx->prev_colors + (size_t)y * COLOR_PLANES;
+        uint64_t diff = fx->rows[y] ^ fx->prev_rows[y];
+        for (int k = 0; k < COLOR_PLANES; k++) {
+            diff |= colors[k] ^ prev_colors[k];
+        }
+        if (!diff) continue;
+
+        fx->dirty_rows[y / 64] |= UINT64_C(1) << (y % 64);
+        dirty_count++;
+
+        while (diff) {
+            int x = __builtin_ctzll(diff);
+            CellChange_t *change = &fx->changes[change_count++];
+            change->x = (uint16_t)x;
+            change->y = (uint16_t)y;
+            change->filled = (fx->rows[y] >> x) & 1;
+            change->color = (uint8_t)frame_cell_color(fx->colors, x, y);
+            diff &= diff - 1;
+        }
+    }
+
+    int preview_count;
+    const uint8_t *preview = piece_queue_view(game, &preview_count);
+    uint16_t next = preview_count ? piece_shape_masks[preview[0]][0] : 0;
+
+    FrameView_t *view = &fx->view;
+    view->generation++;
+    view->width = fx->width;
+    view->height = fx->height;
+    view->rows = fx->rows;
+    view->colors = fx->colors;
+    view->dirty_rows = fx->dirty_rows;
+    view->dirty_count = dirty_count;
+    view->changes = fx->changes;
+    view->change_count = change_count;
+    view->next = next;
+    view->preview = preview;
+    view->preview_count = preview_count;
+    view->hold = game->hold_piece;
+    view->score = game->score;
+    view->high_score = game->high_score;
+    view->level = game->level;
+    view->speed = game->speed;
+    view->pause = game->paused ? 1 : 0;
+
+    return view;
+}
+
+bool frame_row_dirty(const FrameView_t *view, int y) {
+    return (view->dirty_rows[y / 64] >> (y % 64)) & 1;
+}
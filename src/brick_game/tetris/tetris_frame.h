@@ -0,0 +1,68 @@
+#ifndef TETRIS_FRAME_H
+#define TETRIS_FRAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_types.h"
+
+// One cell that differs from the previous export
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint8_t filled;
+    uint8_t color;  // PieceType_t or CELL_GARBAGE when filled, else 0
+} CellChange_t;
+
+// Packed view of the visible field. Row y is rows[y] with bit x set when
+// column x is filled (active piece included); its colours are the
+// COLOR_PLANES words from colors[y * COLOR_PLANES], with bit x of word k
+// holding bit k of the cell's colour and empty cells 0. A cell whose colour
+// changes counts as changed. Buffers are owned by the exporter and stay
+// valid until the next export.
+typedef struct {
+    uint64_t generation;
+    int width;
+    int height;
+    const uint64_t *rows;
+    const uint64_t *colors;
+    const uint64_t *dirty_rows;  // bit y % 64 of word y / 64
+    int dirty_count;
+    const CellChange_t *changes;
+    int change_count;
+    uint16_t next;  // 4x4 next piece, bit (y * PIECE_SIZE + x)
+    const uint8_t *preview;  // upcoming PieceType_t values, next first
+    int preview_count;
+    int hold;  // held PieceType_t, -1 when empty
+    int score;
+    int high_score;
+    int level;
+    int speed;
+    int pause;
+} FrameView_t;
+
+// Exporter state: double-buffered rows plus the delta scratch space
+typedef struct {
+    FrameView_t view;
+    int width;
+    int height;
+    uint64_t *rows;
+    uint64_t *prev_rows;
+    uint64_t *colors;
+    uint64_t *prev_colors;
+    uint64_t *dirty_rows;
+    CellChange_t *changes;
+} FrameExport_t;
+
+bool frame_export_init(FrameExport_t *fx, int width, int height);
+void frame_export_free(FrameExport_t *fx);
+const FrameView_t *frame_export(FrameExport_t *fx, const TetrisGame_t *game);
+bool frame_row_dirty(const FrameView_t *view, int y);
+
+// Colour of cell (x, y) in a view's planes
+int frame_cell_color(const uint64_t *colors, int x, int y);
+
+// Fills planes (COLOR_PLANES words per visible row) the way frame_export()
+// fills FrameView_t.colors
+void frame_compose_colors(const TetrisGame_t *game, uint64_t *planes);
+
+#endif  // TETRIS_FRAME_H
@@ -1,11 +1,84 @@
 #include "tetris_fsm.h"
 #include "tetris_pieces.h"
+#include "tetris_board.h"
+#include "tetris_hash.h"
+#include "tetris_telemetry.h"
 #include <string.h>
+#include <time.h>
 #include <stdbool.h>
 
+bool game_init(TetrisGame_t *game, int width, int height) {
+    if (!game) return false;
+    
+    memset(game, 0, sizeof(TetrisGame_t));
+    if (!board_init(&game->board, width, height)) {
+        return false;
+    }
+    if (!board_enable_colors(&game->board)) {
+        board_free(&game->board);
+        return false;
+    }
+    
+    game->state = STATE_START;
+    game->speed = 48;
+    game->level = 1;
+    game->queue.preview = PREVIEW_MIN;
+    game->hold_piece = -1;
+    game->version = 1;
+    seed_piece_generator(game, ((uint64_t)time(NULL) << 20) ^ (uint64_t)(uintptr_t)game);
+    
+    return true;
+}
+
+void game_destroy(TetrisGame_t *game) {
+    if (!game) return;
+    
+    board_free(&game->board);
+}
+
+// Everything a frontend draws from a game, compared around each action
+typedef struct {
+    uint64_t board_hash;
+    int piece_type;
+    int piece_x;
+    int piece_y;
+    int piece_rotation;
+    int score;
+    int high_score;
+    int level;
+    int hold_piece;
+    int next_piece;
+    bool piece_shown;
+    bool paused;
+    bool game_over;
+} VisibleState_t;
+
+static void capture_visible(const TetrisGame_t *game, VisibleState_t *visible) {
+    // Zeroed first so padding compares equal too
+    memset(visible, 0, sizeof(VisibleState_t));
+    visible->board_hash = game->board_hash;
+    visible->piece_shown = game->state == STATE_MOVING || game->state == STATE_SHIFTING;
+    if (visible->piece_shown) {
+        visible->piece_type = game->current_piece.type;
+        visible->piece_x = game->current_piece.x;
+        visible->piece_y = game->current_piece.y;
+        visible->piece_rotation = game->current_piece.rotation;
+    }
+    visible->score = game->score;
+    visible->high_score = game->high_score;
+    visible->level = game->level;
+    visible->hold_piece = game->hold_piece;
+    visible->next_piece = game->queue.count ? game->queue.types[game->queue.head] : -1;
+    visible->paused = game->paused;
+    visible->game_over = game->game_over;
+}
+
 void fsm_process_action(TetrisGame_t *game, UserAction_t action, bool hold) {
     if (!game) return;
     
+    VisibleState_t before;
+    capture_visible(game, &before);
+    
     switch (game->state) {
         case STATE_START:
             handle_start_state(game, action);
@@ -29,11 +102,34 @@ void fsm_process_action(TetrisGame_t *game, UserAction_t action, bool hold) {
             handle_pause_state(game, action);
             break;
     }
+    
+    VisibleState_t after;
+    capture_visible(game, &after);
+    if (memcmp(&before, &after, sizeof(VisibleState_t)) != 0) {
+        game->version++;
+    }
+}
+
+bool fsm_takes_input(const TetrisGame_t *game) {
+    GameState_t state = game->state;
+    return state != STATE_SPAWN && state != STATE_SHIFTING && state != STATE_ATTACHING;
+}
+
+void fsm_tick(TetrisGame_t *game, UserAction_t action, bool hold) {
+    if (!game) return;
+    
+    if (!fsm_takes_input(game)) {
+        fsm_process_action(game, FSM_IDLE, false);
+    } else if (action != FSM_IDLE) {
+        fsm_process_action(game, action, hold);
+    }
+    fsm_update_timer(game);
 }
 
 void fsm_update_timer(TetrisGame_t *game) {
     if (!game || game->paused) return;
     
+    game->frame++;
     if (game->state == STATE_MOVING) {
         game->timer++;
         if (game->timer >= game->speed) {
@@ -46,18 +142,22 @@ void fsm_update_timer(TetrisGame_t *game) {
 void handle_start_state(TetrisGame_t *game, UserAction_t action) {
     if (action == Start) {
         // Initialize new game
-        memset(game->board, 0, sizeof(game->board));
+        board_clear(&game->board);
+        game->board_hash = 0;
         game->score = 0;
         game->level = 1;
         game->speed = 48;  // Initial speed (frames)
         game->lines_cleared = 0;
         game->timer = 0;
         game->drop_timer = 0;
+        game->pieces_spawned = 0;
+        game->frame = 0;
         game->paused = false;
         game->game_over = false;
+        game->hold_piece = -1;
         
-        // Generate first piece
-        init_piece(&game->next_piece, get_random_piece_type());
+        // Generate the first batch of pieces
+        piece_queue_reset(game);
         game->state = STATE_SPAWN;
     }
     else if (action == Terminate) {
@@ -65,10 +165,11 @@ void handle_start_state(TetrisGame_t *game, UserAction_t action) {
     }
 }
 
-void handle_spawn_state(TetrisGame_t *game) {
-    // Move next piece to current and generate new next piece
-    copy_piece(&game->next_piece, &game->current_piece);
-    init_piece(&game->next_piece, get_random_piece_type());
+// Puts a fresh piece of type at the top; the game ends if it does not fit
+static void spawn_piece(TetrisGame_t *game, PieceType_t type) {
+    init_piece(&game->current_piece, type);
+    game->current_piece.x = game->board.width / 2 - 2;
+    game->pieces_spawned++;
     
     // Check if spawn position is valid
     if (!is_valid_position(game, &game->current_piece)) {
@@ -80,6 +181,22 @@ void handle_spawn_state(TetrisGame_t *game) {
     }
 }
 
+void handle_spawn_state(TetrisGame_t *game) {
+    game->hold_used = false;
+    spawn_piece(game, piece_queue_pop(game));
+}
+
+void handle_hold(TetrisGame_t *game) {
+    if (game->hold_used) return;
+    
+    // Swap with the held piece, or take the next one when the slot is empty
+    PieceType_t held = game->current_piece.type;
+    PieceType_t type = game->hold_piece < 0 ? piece_queue_pop(game) : (PieceType_t)game->hold_piece;
+    game->hold_piece = held;
+    game->hold_used = true;
+    spawn_piece(game, type);
+}
+
 void handle_moving_state(TetrisGame_t *game, UserAction_t action, bool hold) {
     Piece_t temp_piece = game->current_piece;
     
@@ -125,6 +242,10 @@ void handle_moving_state(TetrisGame_t *game, UserAction_t action, bool hold) {
             }
             break;
             
+        case Up:
+            handle_hold(game);
+            break;
+            
         case Pause:
             game->state = STATE_PAUSE;
             game->paused = true;
@@ -153,6 +274,8 @@ void handle_shifting_state(TetrisGame_t *game) {
 }
 
 void handle_attaching_state(TetrisGame_t *game) {
+    int score_before = game->score;
+    
     // Place the piece on the board
     place_piece(game, &game->current_piece);
     
@@ -163,6 +286,9 @@ void handle_attaching_state(TetrisGame_t *game) {
         update_score(game, lines_cleared);
         update_level_and_speed(game);
     }
+    if (game->telemetry) {
+        telemetry_record_lock(game, lines_cleared, game->score - score_before);
+    }
     
     // Check game over condition
     if (is_game_over(game)) {
@@ -193,39 +319,12 @@ void handle_pause_state(TetrisGame_t *game, UserAction_t action) {
 }
 
 int clear_completed_lines(TetrisGame_t *game) {
-    int lines_cleared = 0;
-    
-    // Check from bottom to top
-    for (int y = TOTAL_HEIGHT - 1; y >= BOARD_EXTRA_HEIGHT; y--) {
-        bool line_complete = true;
-        
-        // Check if line is complete
-        for (int x = 0; x < BOARD_WIDTH; x++) {
-            if (!game->board[y][x]) {
-                line_complete = false;
-                break;
-            }
-        }
-        
-        if (line_complete) {
-            // Move all lines above down by one
-            for (int move_y = y; move_y > 0; move_y--) {
-                for (int x = 0; x < BOARD_WIDTH; x++) {
-                    game->board[move_y][x] = game->board[move_y - 1][x];
-                }
-            }
-            
-            // Clear top line
-            for (int x = 0; x < BOARD_WIDTH; x++) {
-                game->board[0][x] = 0;
-            }
-            
-            lines_cleared++;
-            y++; // Check the same line again
-        }
-    }
-    
-    return lines_cleared;
+    // Only rows the piece that just locked covers can have filled up
+    const Piece_t *piece = &game->current_piece;
+    game->board_hash = board_hash_clear(game->board_hash, &game->board,
+                                        piece->y, piece->y + PIECE_SIZE - 1);
+    board_color_clear_lines(&game->board, piece->y, piece->y + PIECE_SIZE - 1);
+    return game->board.kernels->clear_lines(&game->board);
 }
 
 void update_score(TetrisGame_t *game, int lines_cleared) {
@@ -265,12 +364,5 @@ void update_level_and_speed(TetrisGame_t *game) {
 
 bool is_game_over(const TetrisGame_t *game) {
     // Check if any blocks are in the spawn area (top 4 rows)
-    for (int y = 0; y < BOARD_EXTRA_HEIGHT; y++) {
-        for (int x = 0; x < BOARD_WIDTH; x++) {
-            if (game->board[y][x]) {
-                return true;
-            }
-        }
-    }
-    return false;
-}
\ No newline at end of file
+    return board_spawn_area_occupied(&game->board);
+}
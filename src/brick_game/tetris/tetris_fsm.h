@@ -4,14 +4,27 @@
 #include <stdbool.h>
 #include "tetris_types.h"
 
+// Game lifecycle
+bool game_init(TetrisGame_t *game, int width, int height);
+void game_destroy(TetrisGame_t *game);
+
 // FSM function declarations
 void fsm_process_action(TetrisGame_t *game, UserAction_t action, bool hold);
 void fsm_update_timer(TetrisGame_t *game);
 
+// fsm_tick action for a tick with no key pressed
+#define FSM_IDLE ((UserAction_t)-1)
+// One fixed-rate tick: the action, or FSM_IDLE, then gravity. Spawning,
+// shifting and attaching advance on every tick whatever the action.
+void fsm_tick(TetrisGame_t *game, UserAction_t action, bool hold);
+// False while spawning, shifting or attaching, which ignore actions
+bool fsm_takes_input(const TetrisGame_t *game);
+
 // State handler functions
 void handle_start_state(TetrisGame_t *game, UserAction_t action);
 void handle_spawn_state(TetrisGame_t *game);
 void handle_moving_state(TetrisGame_t *game, UserAction_t action, bool hold);
+void handle_hold(TetrisGame_t *game);
 void handle_shifting_state(TetrisGame_t *game);
 void handle_attaching_state(TetrisGame_t *game);
 void handle_game_over_state(TetrisGame_t *game, UserAction_t action);
@@ -0,0 +1,14 @@
+#ifndef TETRIS_GAME_H
+#define TETRIS_GAME_H
+
+#include "brick_runtime.h"
+
+// Drives the library's own game, the one userInput() and the other tetris.h
+// calls act on, so options set there (preview count, spectator feed,
+// telemetry) carry over. Only one runtime can hold it at a time, and
+// create fails on a game initialised with another geometry. A game
+// that create had to initialise is cleaned up again on destroy; otherwise
+// cleanup_game() stays with whoever initialised it.
+extern const GameVtable_t tetris_game_vtable;
+
+#endif  // TETRIS_GAME_H
@@ -0,0 +1,138 @@
+#include "tetris_hash.h"
+#include "tetris_board.h"
+
+// Odd, so it has an inverse mod 2^64 for shifting rows down after a clear
+#define HASH_ROW_BASE UINT64_C(0x9e3779b97f4a7c15)
+#define HASH_ROW_BASE_INVERSE UINT64_C(0xf1de83e19937733d)
+#define HASH_COLUMN_SALT UINT64_C(0x5851f42d4c957f2d)
+#define HASH_PIECE_SALT UINT64_C(0x2545f4914f6cdd1d)
+
+// splitmix64 finaliser, as a macro too so the key table is a constant
+#define MIX_STEP(z, shift, mul) (((z) ^ ((z) >> (shift))) * UINT64_C(mul))
+#define MIX64(z) (MIX_STEP(MIX_STEP((z), 30, 0xbf58476d1ce4e5b9), 27, 0x94d049bb133111eb) ^ \
+                  (MIX_STEP(MIX_STEP((z), 30, 0xbf58476d1ce4e5b9), 27, 0x94d049bb133111eb) >> 31))
+
+static inline uint64_t mix64(uint64_t z) {
+    return MIX64(z);
+}
+
+#define COLUMN_KEY(x) MIX64((uint64_t)(x) + HASH_COLUMN_SALT)
+#define COLUMN_KEYS_4(x) COLUMN_KEY(x), COLUMN_KEY(x + 1), COLUMN_KEY(x + 2), COLUMN_KEY(x + 3)
+#define COLUMN_KEYS_16(x) COLUMN_KEYS_4(x), COLUMN_KEYS_4(x + 4), COLUMN_KEYS_4(x + 8), COLUMN_KEYS_4(x + 12)
+
+static const uint64_t column_keys[BOARD_MAX_WIDTH] = {
+    COLUMN_KEYS_16(0), COLUMN_KEYS_16(16), COLUMN_KEYS_16(32), COLUMN_KEYS_16(48),
+};
+
+// Sum of the column keys of every set bit; additive so disjoint cells add up
+static inline uint64_t row_key(uint64_t bits) {
+    uint64_t key = 0;
+
+    for (; bits; bits &= bits - 1) {
+        key += column_keys[__builtin_ctzll(bits)];
+    }
+    return key;
+}
+
+static uint64_t base_power(uint64_t base, int exponent) {
+    uint64_t result = 1;
+
+    for (; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) result *= base;
+        base *= base;
+    }
+    return result;
+}
+
+uint64_t board_hash(const Board_t *board) {
+    uint64_t hash = 0;
+    uint64_t power = 1;
+
+    for (int y = board->total_height - 1; y >= 0; y--) {
+        hash += row_key(board->kernels->get_row(board, y)) * power;
+        power *= HASH_ROW_BASE;
+    }
+    return hash;
+}
+
+uint64_t board_hash_place(uint64_t hash, const Board_t *board, const Piece_t *piece) {
+    if (piece->x <= -PIECE_SIZE || piece->x >= 64) return hash;
+
+    // Walk the piece bottom-up from its lowest row on the board so the row
+    // power only ever grows
+    int i = PIECE_SIZE - 1;
+    if (piece->y + i >= board->total_height) i = board->total_height - 1 - piece->y;
+    uint64_t power = base_power(HASH_ROW_BASE, board->total_height - 1 - (piece->y + i));
+
+    for (; i >= 0 && piece->y + i >= 0; i--, power *= HASH_ROW_BASE) {
+        uint64_t bits = piece_row_mask(piece, i);
+        if (!bits) continue;
+
+        int y = piece->y + i;
+        bits = piece->x < 0 ? bits >> -piece->x : bits << piece->x;
+        bits &= board->full_row & ~board->kernels->get_row(board, y);
+        hash += row_key(bits) * power;
+    }
+    return hash;
+}
+
+uint64_t board_hash_clear(uint64_t hash, const Board_t *board, int first, int last) {
+    int top = -1;
+
+    // Same rows the kernels scan: full rows in the spawn area stay put
+    if (first < BOARD_EXTRA_HEIGHT) first = BOARD_EXTRA_HEIGHT;
+    if (last >= board->total_height) last = board->total_height - 1;
+    for (int y = last; y >= first; y--) {
+        if (board->kernels->get_row(board, y) == board->full_row) top = y;
+    }
+    if (top < 0) return hash;
+
+    // Re-hash the rows from the floor to the highest cleared row; everything
+    // above simply moves down by the number of cleared rows
+    uint64_t old_low = 0;
+    uint64_t new_low = 0;
+    uint64_t old_power = 1;
+    uint64_t new_power = 1;
+    int cleared = 0;
+
+    for (int y = board->total_height - 1; y >= top; y--) {
+        uint64_t row = board->kernels->get_row(board, y);
+        uint64_t key = row_key(row);
+
+        old_low += key * old_power;
+        old_power *= HASH_ROW_BASE;
+        if (row == board->full_row) {
+            cleared++;
+        } else {
+            new_low += key * new_power;
+            new_power *= HASH_ROW_BASE;
+        }
+    }
+
+    return new_low + (hash - old_low) * base_power(HASH_ROW_BASE_INVERSE, cleared);
+}
+
+uint64_t board_hash_garbage(uint64_t hash, int rows, uint64_t garbage) {
+    // Every existing cell moves up a row per garbage row, which lands at j = 0
+    uint64_t key = row_key(garbage);
+
+    for (int j = 0; j < rows; j++) {
+        hash = hash * HASH_ROW_BASE + key;
+    }
+    return hash;
+}
+
+uint64_t piece_hash(const Piece_t *piece) {
+    uint64_t packed = (uint64_t)piece->type << 48 | (uint64_t)(piece->rotation & 3) << 40 |
+                      (uint64_t)(uint16_t)piece->x << 16 | (uint16_t)piece->y;
+    return mix64(packed ^ HASH_PIECE_SALT);
+}
+
+uint64_t game_hash(const TetrisGame_t *game) {
+    uint64_t hash = game->board_hash;
+
+    if (game->state == STATE_MOVING || game->state == STATE_SHIFTING) {
+        hash ^= piece_hash(&game->current_piece);
+    }
+    return hash;
+}
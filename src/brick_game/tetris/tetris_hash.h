@@ -0,0 +1,31 @@
+#ifndef TETRIS_HASH_H
+#define TETRIS_HASH_H
+
+#include <stdint.h>
+#include "tetris_types.h"
+
+// Zobrist-style state hash. Each filled cell contributes its column key
+// times BASE^j, where j counts rows up from the floor, so placing a piece
+// only adds its own cells and a line clear only revisits the rows up to
+// the highest cleared one. An empty board hashes to 0.
+
+// Full recomputation, for checks and for boards edited directly
+uint64_t board_hash(const Board_t *board);
+
+// Hash after piece is placed; call before placing it
+uint64_t board_hash_place(uint64_t hash, const Board_t *board, const Piece_t *piece);
+
+// Hash after full rows in [first, last] are cleared; call before clearing.
+// Only rows a piece just landed in can be full, so that range is enough.
+uint64_t board_hash_clear(uint64_t hash, const Board_t *board, int first, int last);
+
+// Hash after rows copies of garbage are pushed in under the stack; call
+// before pushing. Rows pushed off the top must be empty.
+uint64_t board_hash_garbage(uint64_t hash, int rows, uint64_t garbage);
+
+uint64_t piece_hash(const Piece_t *piece);
+
+// Board plus the falling piece, if any
+uint64_t game_hash(const TetrisGame_t *game);
+
+#endif  // TETRIS_HASH_H
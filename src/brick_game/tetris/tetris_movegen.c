@@ -0,0 +1,274 @@
+#include "tetris_movegen.h"
+#include "tetris_board.h"
+#include "tetris_piece_tables.h"
+#include "tetris_pieces.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MOVEGEN_NO_PARENT UINT32_MAX
+#define MOVEGEN_MIN_LANDINGS 64
+#define MOVEGEN_MIN_INPUTS 1024
+
+// Fit masks index columns from -(PIECE_SIZE - 1) and need room for the
+// shape's width past the right wall, so wider boards use the kernels
+#define MOVEGEN_MASK_MAX_WIDTH (64 - 2 * PIECE_SIZE)
+
+// Per-rotation data for the piece being searched
+typedef struct {
+    Piece_t piece;
+    int dx;     // first filled column of the 4x4 shape
+    int dy;     // first filled row of the 4x4 shape
+    int canon;  // lowest rotation with the same cells, up to translation
+} RotationInfo_t;
+
+static size_t bitmap_words(uint32_t bits) {
+    return ((size_t)bits + 63) / 64;
+}
+
+static bool test_and_set(uint64_t *bitmap, uint32_t bit) {
+    uint64_t mask = UINT64_C(1) << (bit % 64);
+    bool was_set = bitmap[bit / 64] & mask;
+    bitmap[bit / 64] |= mask;
+    return was_set;
+}
+
+static uint32_t state_index(const MoveGen_t *gen, int x, int y, int rotation) {
+    return ((uint32_t)rotation * gen->total_height + (uint32_t)y) * gen->x_span +
+           (uint32_t)(x + PIECE_SIZE - 1);
+}
+
+bool movegen_init(MoveGen_t *gen, int width, int height) {
+    if (!gen) return false;
+
+    memset(gen, 0, sizeof(MoveGen_t));
+    if (width < BOARD_MIN_WIDTH || width > BOARD_MAX_WIDTH ||
+        height < BOARD_MIN_HEIGHT || height > BOARD_MAX_HEIGHT) {
+        return false;
+    }
+
+    gen->width = width;
+    gen->total_height = height + BOARD_EXTRA_HEIGHT;
+    gen->x_span = width + PIECE_SIZE - 1;
+    gen->state_count = 4u * (uint32_t)gen->total_height * (uint32_t)gen->x_span;
+
+    if (width <= MOVEGEN_MASK_MAX_WIDTH) {
+        gen->fit = malloc(4 * (size_t)gen->total_height * sizeof(uint64_t));
+        if (!gen->fit) return false;
+    }
+    gen->visited = calloc(bitmap_words(gen->state_count), sizeof(uint64_t));
+    gen->landed = calloc(bitmap_words(gen->state_count), sizeof(uint64_t));
+    gen->queue = malloc(gen->state_count * sizeof(uint32_t));
+    gen->parent = malloc(gen->state_count * sizeof(uint32_t));
+    gen->parent_move = malloc(gen->state_count);
+    gen->landing_capacity = MOVEGEN_MIN_LANDINGS;
+    gen->landings = malloc(gen->landing_capacity * sizeof(Landing_t));
+    gen->input_capacity = MOVEGEN_MIN_INPUTS;
+    gen->inputs = malloc(gen->input_capacity);
+
+    if (!gen->visited || !gen->landed || !gen->queue || !gen->parent || !gen->parent_move ||
+        !gen->landings || !gen->inputs) {
+        movegen_free(gen);
+        return false;
+    }
+    return true;
+}
+
+void movegen_free(MoveGen_t *gen) {
+    if (!gen) return;
+
+    free(gen->fit);
+    free(gen->visited);
+    free(gen->landed);
+    free(gen->queue);
+    free(gen->parent);
+    free(gen->parent_move);
+    free(gen->landings);
+    free(gen->inputs);
+    memset(gen, 0, sizeof(MoveGen_t));
+}
+
+static void rotation_info(const Piece_t *start, RotationInfo_t info[4]) {
+    init_piece(&info[0].piece, start->type);
+    for (int r = 0; r < 4; r++) {
+        if (r > 0) {
+            info[r].piece = info[r - 1].piece;
+            rotate_piece(&info[r].piece);
+        }
+
+        info[r].dx = piece_extents[start->type][r].left;
+        info[r].dy = piece_extents[start->type][r].top;
+        info[r].canon = piece_canonical_rotation[start->type][r];
+    }
+}
+
+// All positions of every rotation at once: a cell of the shape at column
+// offset b collides where the padded row, shifted right by b, is set
+static void build_fit_masks(MoveGen_t *gen, const Board_t *board, const RotationInfo_t info[4]) {
+    const int pad = PIECE_SIZE - 1;
+    const uint64_t walls = ~(board->full_row << pad);
+    const uint64_t span = (UINT64_C(1) << gen->x_span) - 1;
+
+    for (int r = 0; r < 4; r++) {
+        const uint8_t *rows = piece_row_masks[info[r].piece.type][r];
+
+        for (int y = 0; y < gen->total_height; y++) {
+            uint64_t blocked = 0;
+
+            for (int i = 0; i < PIECE_SIZE && blocked != UINT64_MAX; i++) {
+                if (!rows[i]) continue;
+                if (y + i >= gen->total_height) {
+                    blocked = UINT64_MAX;
+                    break;
+                }
+
+                uint64_t padded = (board->kernels->get_row(board, y + i) << pad) | walls;
+                for (unsigned bits = rows[i]; bits; bits &= bits - 1) {
+                    blocked |= padded >> __builtin_ctz(bits);
+                }
+            }
+            gen->fit[r * gen->total_height + y] = ~blocked & span;
+        }
+    }
+}
+
+static bool state_fits(const MoveGen_t *gen, const Board_t *board, const RotationInfo_t info[4],
+                       int x, int y, int rotation) {
+    if (x <= -PIECE_SIZE || x >= gen->width || y >= gen->total_height) return false;
+    if (gen->fit) {
+        return (gen->fit[rotation * gen->total_height + y] >> (x + PIECE_SIZE - 1)) & 1;
+    }
+
+    Piece_t piece = info[rotation].piece;
+    piece.x = x;
+    piece.y = y;
+    return board->kernels->fits(board, &piece);
+}
+
+static bool grow(void **buffer, int *capacity, int needed, size_t item_size) {
+    if (needed <= *capacity) return true;
+
+    int next = *capacity * 2 > needed ? *capacity * 2 : needed;
+    void *grown = realloc(*buffer, (size_t)next * item_size);
+    if (!grown) return false;
+
+    *buffer = grown;
+    *capacity = next;
+    return true;
+}
+
+// Shortest path to state, with the trailing soft drops and the final lock
+// folded into one hard drop
+static bool add_landing(MoveGen_t *gen, uint32_t state, int x, int y, int rotation) {
+    int length = 0;
+    for (uint32_t s = state; gen->parent[s] != MOVEGEN_NO_PARENT; s = gen->parent[s]) {
+        length++;
+    }
+
+    if (!grow((void **)&gen->landings, &gen->landing_capacity, gen->landing_count + 1,
+              sizeof(Landing_t)) ||
+        !grow((void **)&gen->inputs, &gen->input_capacity, gen->input_count + length + 1, 1)) {
+        return false;
+    }
+
+    uint8_t *inputs = gen->inputs + gen->input_count;
+    int i = length;
+    for (uint32_t s = state; gen->parent[s] != MOVEGEN_NO_PARENT; s = gen->parent[s]) {
+        inputs[--i] = gen->parent_move[s];
+    }
+    while (length > 0 && inputs[length - 1] == MOVE_DOWN) {
+        length--;
+    }
+    inputs[length++] = MOVE_DROP;
+
+    Landing_t *landing = &gen->landings[gen->landing_count++];
+    landing->x = x;
+    landing->y = y;
+    landing->rotation = rotation;
+    landing->input_offset = gen->input_count;
+    landing->input_count = length;
+    gen->input_count += length;
+    return true;
+}
+
+int movegen_generate(MoveGen_t *gen, const Board_t *board, const Piece_t *start) {
+    if (!gen || !gen->visited || !board || !start) return -1;
+    if (board->width != gen->width || board->total_height != gen->total_height) return -1;
+
+    gen->landing_count = 0;
+    gen->input_count = 0;
+
+    if (start->y < 0 || start->y >= gen->total_height || !board->kernels->fits(board, start)) {
+        return 0;
+    }
+
+    RotationInfo_t info[4];
+    rotation_info(start, info);
+    if (gen->fit) build_fit_masks(gen, board, info);
+    memset(gen->visited, 0, bitmap_words(gen->state_count) * sizeof(uint64_t));
+    memset(gen->landed, 0, bitmap_words(gen->state_count) * sizeof(uint64_t));
+
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    uint32_t root = state_index(gen, start->x, start->y, start->rotation & 3);
+    test_and_set(gen->visited, root);
+    gen->parent[root] = MOVEGEN_NO_PARENT;
+    gen->queue[tail++] = root;
+
+    while (head < tail) {
+        uint32_t state = gen->queue[head++];
+        int x = (int)(state % gen->x_span) - (PIECE_SIZE - 1);
+        int y = (int)(state / gen->x_span % gen->total_height);
+        int rotation = (int)(state / gen->x_span / gen->total_height);
+        gen->states_expanded++;
+
+        // Rotation first and the soft drop last keeps paths lateral-first,
+        // which lets the final drops fold into a single hard drop
+        const struct {
+            MoveInput_t input;
+            int x, y, rotation;
+        } next[] = {
+            {MOVE_ROTATE, x, y, (rotation + 1) & 3},
+            {MOVE_LEFT, x - 1, y, rotation},
+            {MOVE_RIGHT, x + 1, y, rotation},
+            {MOVE_DOWN, x, y + 1, rotation},
+        };
+
+        for (int m = 0; m < 4; m++) {
+            if (!state_fits(gen, board, info, next[m].x, next[m].y, next[m].rotation)) {
+                if (next[m].input != MOVE_DOWN) continue;
+
+                // Resting here: keep it unless another path already locked the same cells
+                const RotationInfo_t *r = &info[rotation];
+                uint32_t key = state_index(gen, x + r->dx, y + r->dy, r->canon);
+                if (!test_and_set(gen->landed, key) && !add_landing(gen, state, x, y, rotation)) {
+                    return -1;
+                }
+                continue;
+            }
+
+            uint32_t neighbour = state_index(gen, next[m].x, next[m].y, next[m].rotation);
+            if (test_and_set(gen->visited, neighbour)) continue;
+
+            gen->parent[neighbour] = state;
+            gen->parent_move[neighbour] = (uint8_t)next[m].input;
+            gen->queue[tail++] = neighbour;
+        }
+    }
+
+    return gen->landing_count;
+}
+
+const uint8_t *movegen_landing_inputs(const MoveGen_t *gen, const Landing_t *landing) {
+    return gen->inputs + landing->input_offset;
+}
+
+void move_input_action(MoveInput_t input, UserAction_t *action, bool *hold) {
+    *hold = false;
+    switch (input) {
+        case MOVE_LEFT: *action = Left; break;
+        case MOVE_RIGHT: *action = Right; break;
+        case MOVE_ROTATE: *action = Action; break;
+        case MOVE_DROP: *action = Down; *hold = true; break;
+        default: *action = Down; break;
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef TETRIS_MOVEGEN_H
+#define TETRIS_MOVEGEN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_types.h"
+
+// One engine input; MOVE_DROP is Down with hold, the rest are single presses
+typedef enum {
+    MOVE_LEFT,
+    MOVE_RIGHT,
+    MOVE_ROTATE,
+    MOVE_DOWN,
+    MOVE_DROP
+} MoveInput_t;
+
+// A distinct final placement: the piece locks at (x, y, rotation) after
+// inputs[input_offset .. input_offset + input_count) of the generator
+typedef struct {
+    int x;
+    int y;
+    int rotation;
+    int input_offset;
+    int input_count;
+} Landing_t;
+
+// Breadth-first search over (x, y, rotation) using the engine's own moves,
+// so slides and rotations under overhangs are found. Buffers are sized for
+// one board geometry and reused across calls.
+typedef struct {
+    int width;
+    int total_height;
+    int x_span;
+    uint32_t state_count;
+    uint64_t *fit;      // per (rotation, y): bit x + 3 set when the piece fits
+    uint64_t *visited;  // one bit per (rotation, y, x) state
+    uint64_t *landed;   // one bit per distinct set of locked cells
+    uint32_t *queue;
+    uint32_t *parent;
+    uint8_t *parent_move;
+    Landing_t *landings;
+    int landing_count;
+    int landing_capacity;
+    uint8_t *inputs;
+    int input_count;
+    int input_capacity;
+    uint64_t states_expanded;
+} MoveGen_t;
+
+bool movegen_init(MoveGen_t *gen, int width, int height);
+void movegen_free(MoveGen_t *gen);
+
+// Every distinct landing for start on board, with the shortest input
+// sequence from start's position; returns the landing count or -1
+int movegen_generate(MoveGen_t *gen, const Board_t *board, const Piece_t *start);
+
+const uint8_t *movegen_landing_inputs(const MoveGen_t *gen, const Landing_t *landing);
+void move_input_action(MoveInput_t input, UserAction_t *action, bool *hold);
+
+#endif  // TETRIS_MOVEGEN_H
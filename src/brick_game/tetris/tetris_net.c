@@ -0,0 +1,328 @@
+#define _GNU_SOURCE
+#include "tetris_net.h"
+#include "tetris_fsm.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define NET_LISTEN_BACKLOG 4096
+
+static uint8_t *put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+    return p + 4;
+}
+
+static uint8_t *put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+    return p + 8;
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) {
+        v = v << 8 | p[i];
+    }
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = v << 8 | p[i];
+    }
+    return v;
+}
+
+// Fills in the length prefix once the body is written
+static size_t finish_message(uint8_t *out, const uint8_t *end) {
+    size_t size = (size_t)(end - out);
+    put_u16(out, (uint16_t)(size - NET_LENGTH_BYTES));
+    return size;
+}
+
+int net_message_size(const uint8_t *buf, size_t available) {
+    if (available < NET_LENGTH_BYTES) return 0;
+
+    int body = get_u16(buf);
+    if (body < 1 || body > NET_MAX_MESSAGE - NET_LENGTH_BYTES) return -1;
+    return available < (size_t)(NET_LENGTH_BYTES + body) ? 0 : NET_LENGTH_BYTES + body;
+}
+
+NetMessageType_t net_message_type(const uint8_t *msg) {
+    return (NetMessageType_t)msg[NET_LENGTH_BYTES];
+}
+
+size_t net_write_hello(uint8_t *out, NetMessageType_t type, const NetHello_t *hello) {
+    uint8_t *p = out + NET_LENGTH_BYTES;
+    *p++ = (uint8_t)type;
+    *p++ = hello->version;
+    *p++ = hello->width;
+    p = put_u16(p, hello->height);
+    p = type == NET_HELLO ? put_u64(p, hello->seed) : put_u32(p, hello->session);
+    return finish_message(out, p);
+}
+
+size_t net_write_input(uint8_t *out, const NetInput_t *input) {
+    uint8_t *p = out + NET_LENGTH_BYTES;
+    *p++ = NET_INPUT;
+    p = put_u32(p, input->seq);
+    p = put_u64(p, input->stamp);
+    *p++ = input->action;
+    *p++ = input->hold;
+    return finish_message(out, p);
+}
+
+size_t net_write_frame(uint8_t *out, uint32_t seq, uint64_t stamp, FrameStream_t *stream,
+                       const FrameView_t *view, const TetrisGame_t *game) {
+    uint8_t *p = out + NET_LENGTH_BYTES;
+    *p++ = NET_FRAME;
+    p = put_u32(p, seq);
+    p = put_u64(p, stamp);
+    *p++ = game->game_over ? NET_FRAME_GAME_OVER : 0;
+    p += stream_encode(stream, view, p);
+    return finish_message(out, p);
+}
+
+bool net_read_hello(const uint8_t *msg, int size, NetHello_t *hello) {
+    const uint8_t *p = msg + NET_LENGTH_BYTES;
+    NetMessageType_t type = (NetMessageType_t)*p++;
+    int expected = NET_LENGTH_BYTES + 5 + (type == NET_HELLO ? 8 : 4);
+    if ((type != NET_HELLO && type != NET_WELCOME) || size != expected) return false;
+
+    memset(hello, 0, sizeof(NetHello_t));
+    hello->version = *p++;
+    hello->width = *p++;
+    hello->height = get_u16(p);
+    p += 2;
+    if (type == NET_HELLO) {
+        hello->seed = get_u64(p);
+    } else {
+        hello->session = get_u32(p);
+    }
+    return true;
+}
+
+bool net_read_input(const uint8_t *msg, int size, NetInput_t *input) {
+    const uint8_t *p = msg + NET_LENGTH_BYTES;
+    if (*p++ != NET_INPUT || size != NET_LENGTH_BYTES + 15) return false;
+
+    input->seq = get_u32(p);
+    input->stamp = get_u64(p + 4);
+    input->action = p[12];
+    input->hold = p[13] != 0;
+    return input->action <= Action || input->action == NET_ACTION_IDLE;
+}
+
+bool net_read_frame(const uint8_t *msg, int size, NetFrame_t *frame) {
+    const uint8_t *p = msg + NET_LENGTH_BYTES;
+    if (size < NET_LENGTH_BYTES + NET_FRAME_HEADER || *p++ != NET_FRAME) return false;
+
+    frame->seq = get_u32(p);
+    frame->stamp = get_u64(p + 4);
+    frame->flags = p[12];
+    frame->payload = p + 13;
+    frame->payload_size = size - NET_LENGTH_BYTES - NET_FRAME_HEADER;
+    return true;
+}
+
+void net_step_game(TetrisGame_t *game, const NetInput_t *input) {
+    UserAction_t action = input->action == NET_ACTION_IDLE ? FSM_IDLE : (UserAction_t)input->action;
+    fsm_tick(game, action, input->hold);
+}
+
+bool net_buffer_init(NetBuffer_t *buf, size_t capacity) {
+    if (!buf) return false;
+
+    memset(buf, 0, sizeof(NetBuffer_t));
+    buf->data = malloc(capacity);
+    if (!buf->data) return false;
+
+    buf->capacity = capacity;
+    return true;
+}
+
+void net_buffer_free(NetBuffer_t *buf) {
+    if (!buf) return;
+
+    free(buf->data);
+    memset(buf, 0, sizeof(NetBuffer_t));
+}
+
+size_t net_buffer_pending(const NetBuffer_t *buf) {
+    return buf->end - buf->start;
+}
+
+uint8_t *net_buffer_reserve(NetBuffer_t *buf, size_t size) {
+    if (buf->capacity - buf->end < size && buf->start > 0) {
+        size_t pending = net_buffer_pending(buf);
+        memmove(buf->data, buf->data + buf->start, pending);
+        buf->start = 0;
+        buf->end = pending;
+    }
+    return buf->capacity - buf->end < size ? NULL : buf->data + buf->end;
+}
+
+void net_buffer_commit(NetBuffer_t *buf, size_t size) {
+    buf->end += size;
+}
+
+void net_buffer_consume(NetBuffer_t *buf, size_t size) {
+    buf->start += size;
+    if (buf->start == buf->end) {
+        buf->start = buf->end = 0;
+    }
+}
+
+int net_buffer_next_message(const NetBuffer_t *buf) {
+    size_t pending = net_buffer_pending(buf);
+    int size = net_message_size(buf->data + buf->start, pending);
+    return size == 0 && pending == buf->capacity ? -1 : size;
+}
+
+NetIoResult_t net_buffer_fill(NetBuffer_t *buf, int fd) {
+    for (;;) {
+        uint8_t *space = net_buffer_reserve(buf, 1);
+        if (!space) return NET_IO_FULL;
+
+        size_t room = buf->capacity - buf->end;
+        ssize_t n = read(fd, space, room);
+        if (n > 0) {
+            buf->end += (size_t)n;
+            // A short read means the socket is drained; epoll is level
+            // triggered, so skip the read that would only say EAGAIN
+            if ((size_t)n < room) return NET_IO_OK;
+            continue;
+        }
+        if (n == 0) return NET_IO_CLOSED;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK ? NET_IO_OK : NET_IO_ERROR;
+    }
+}
+
+NetIoResult_t net_buffer_flush(NetBuffer_t *buf, int fd) {
+    while (net_buffer_pending(buf) > 0) {
+        ssize_t n = send(fd, buf->data + buf->start, net_buffer_pending(buf), MSG_NOSIGNAL);
+        if (n > 0) {
+            net_buffer_consume(buf, (size_t)n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return NET_IO_FULL;
+        return n < 0 && errno == EPIPE ? NET_IO_CLOSED : NET_IO_ERROR;
+    }
+    return NET_IO_OK;
+}
+
+bool net_parse_address(const char *text, NetAddress_t *address) {
+    if (!text || !address) return false;
+
+    memset(address, 0, sizeof(NetAddress_t));
+    const char *port = strncmp(text, "tcp:", 4) == 0 ? text + 4 : text;
+    char *end;
+    long value = strtol(port, &end, 10);
+    if (*port && !*end) {
+        address->port = (int)value;
+        return value > 0 && value < 65536;
+    }
+    if (port != text) return false;
+
+    const char *path = strncmp(text, "unix:", 5) == 0 ? text + 5 : text;
+    if (!*path || strlen(path) >= sizeof(address->path)) return false;
+
+    address->is_unix = true;
+    strcpy(address->path, path);
+    return true;
+}
+
+static int make_socket(const NetAddress_t *address, struct sockaddr_storage *sa, socklen_t *len) {
+    memset(sa, 0, sizeof(*sa));
+    if (address->is_unix) {
+        struct sockaddr_un *un = (struct sockaddr_un *)sa;
+        un->sun_family = AF_UNIX;
+        strcpy(un->sun_path, address->path);
+        *len = sizeof(struct sockaddr_un);
+        return socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    }
+
+    struct sockaddr_in *in = (struct sockaddr_in *)sa;
+    in->sin_family = AF_INET;
+    in->sin_port = htons((uint16_t)address->port);
+    in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    *len = sizeof(struct sockaddr_in);
+    return socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+}
+
+// Frames are small and latency-bound, so never wait to coalesce them
+static void set_no_delay(int fd, const NetAddress_t *address) {
+    int one = 1;
+    if (!address->is_unix) {
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+}
+
+int net_listen(const NetAddress_t *address, bool reuse_port) {
+    struct sockaddr_storage sa;
+    socklen_t len;
+    int fd = make_socket(address, &sa, &len);
+    if (fd < 0) return -1;
+
+    int one = 1;
+    if (address->is_unix) {
+        unlink(address->path);
+    } else {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (reuse_port && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    if (bind(fd, (struct sockaddr *)&sa, len) != 0 || listen(fd, NET_LISTEN_BACKLOG) != 0 ||
+        fcntl(fd, F_SETFL, O_NONBLOCK) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int net_accept(int listen_fd, const NetAddress_t *address) {
+    int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd >= 0) {
+        set_no_delay(fd, address);
+    }
+    return fd;
+}
+
+int net_connect(const NetAddress_t *address) {
+    struct sockaddr_storage sa;
+    socklen_t len;
+    int fd = make_socket(address, &sa, &len);
+    if (fd < 0) return -1;
+
+    if (connect(fd, (struct sockaddr *)&sa, len) != 0 || fcntl(fd, F_SETFL, O_NONBLOCK) != 0) {
+        close(fd);
+        return -1;
+    }
+    set_no_delay(fd, address);
+    return fd;
+}
@@ -0,0 +1,135 @@
+#ifndef TETRIS_NET_H
+#define TETRIS_NET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tetris_frame.h"
+#include "tetris_stream.h"
+#include "tetris_types.h"
+
+// Wire protocol of tetris-server. Every message is a little-endian u16
+// body length followed by the body: a u8 type, then the fields below in
+// order, all little-endian. The client drives its game: each INPUT
+// advances the server's engine one tick and is answered by one FRAME
+// holding one frame of the connection's tetris_stream.h stream.
+//
+//   HELLO    c->s  u8 version, u8 width, u16 height, u64 seed
+//   WELCOME  s->c  u8 version, u8 width, u16 height, u32 session
+//   INPUT    c->s  u32 seq, u64 stamp, u8 action (0xff idle), u8 hold
+//   FRAME    s->c  u32 seq, u64 stamp, u8 flags, then the stream frame
+//
+// seq and stamp are echoed untouched so the client can time each tick.
+
+#define NET_PROTOCOL_VERSION 2
+#define NET_LENGTH_BYTES 2
+#define NET_MAX_HEIGHT 256  // keeps a full frame under the u16 length
+#define NET_FRAME_HEADER 14  // FRAME body before the stream frame
+#define NET_MAX_MESSAGE \
+    (NET_LENGTH_BYTES + NET_FRAME_HEADER + STREAM_MAX_FRAME_BYTES(NET_MAX_HEIGHT))
+#define NET_ACTION_IDLE 0xff
+#define NET_FRAME_GAME_OVER 0x01
+
+typedef enum {
+    NET_HELLO = 1,
+    NET_WELCOME,
+    NET_INPUT,
+    NET_FRAME
+} NetMessageType_t;
+
+typedef struct {
+    uint8_t version;
+    uint8_t width;
+    uint16_t height;
+    uint64_t seed;  // HELLO only
+    uint32_t session;  // WELCOME only
+} NetHello_t;
+
+typedef struct {
+    uint32_t seq;
+    uint64_t stamp;
+    uint8_t action;  // UserAction_t or NET_ACTION_IDLE
+    uint8_t hold;
+} NetInput_t;
+
+// Decoded FRAME header; payload points into the message
+typedef struct {
+    uint32_t seq;
+    uint64_t stamp;
+    uint8_t flags;
+    const uint8_t *payload;
+    int payload_size;
+} NetFrame_t;
+
+// Size of the first message in buf including its length prefix, 0 when
+// more bytes are needed, -1 when the length is impossible
+int net_message_size(const uint8_t *buf, size_t available);
+NetMessageType_t net_message_type(const uint8_t *msg);
+
+// Encoders write a whole message to out and return its size; out must
+// hold NET_MAX_MESSAGE bytes
+size_t net_write_hello(uint8_t *out, NetMessageType_t type, const NetHello_t *hello);
+size_t net_write_input(uint8_t *out, const NetInput_t *input);
+size_t net_write_frame(uint8_t *out, uint32_t seq, uint64_t stamp, FrameStream_t *stream,
+                       const FrameView_t *view, const TetrisGame_t *game);
+
+// Decoders take one message as sized by net_message_size()
+bool net_read_hello(const uint8_t *msg, int size, NetHello_t *hello);
+bool net_read_input(const uint8_t *msg, int size, NetInput_t *input);
+bool net_read_frame(const uint8_t *msg, int size, NetFrame_t *frame);
+
+// One network tick: the engine step both ends run for an INPUT
+void net_step_game(TetrisGame_t *game, const NetInput_t *input);
+
+// Byte queue for one socket direction: data[start, end) is pending
+typedef struct {
+    uint8_t *data;
+    size_t start;
+    size_t end;
+    size_t capacity;
+} NetBuffer_t;
+
+typedef enum {
+    NET_IO_OK,      // drained or filled until the socket would block
+    NET_IO_FULL,    // buffer full (fill) or socket still busy (flush)
+    NET_IO_CLOSED,  // peer closed the connection
+    NET_IO_ERROR
+} NetIoResult_t;
+
+bool net_buffer_init(NetBuffer_t *buf, size_t capacity);
+void net_buffer_free(NetBuffer_t *buf);
+size_t net_buffer_pending(const NetBuffer_t *buf);
+
+// Room for at least size more bytes at the end, NULL when out of space
+uint8_t *net_buffer_reserve(NetBuffer_t *buf, size_t size);
+void net_buffer_commit(NetBuffer_t *buf, size_t size);
+void net_buffer_consume(NetBuffer_t *buf, size_t size);
+// Size of the first message pending in buf, as net_message_size(), and
+// also -1 when buf is full without a whole message: no read can finish it
+int net_buffer_next_message(const NetBuffer_t *buf);
+
+// Non-blocking socket I/O into and out of a buffer
+NetIoResult_t net_buffer_fill(NetBuffer_t *buf, int fd);
+NetIoResult_t net_buffer_flush(NetBuffer_t *buf, int fd);
+
+// Addresses are "unix:PATH" or "tcp:PORT" (loopback only); a bare number
+// is a TCP port and anything else a socket path
+typedef struct {
+    bool is_unix;
+    int port;
+    char path[108];
+} NetAddress_t;
+
+bool net_parse_address(const char *text, NetAddress_t *address);
+
+// Non-blocking listening socket; reuse_port lets one socket per worker
+// share a TCP port. Returns the fd or -1.
+int net_listen(const NetAddress_t *address, bool reuse_port);
+
+// Next pending connection, non-blocking; -1 when there is none
+int net_accept(int listen_fd, const NetAddress_t *address);
+
+// Blocking connect, then switched to non-blocking; returns the fd or -1
+int net_connect(const NetAddress_t *address);
+
+#endif  // TETRIS_NET_H
@@ -1,62 +1,11 @@
 #include "tetris_pieces.h"
+#include "tetris_board.h"
+#include "tetris_hash.h"
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
 #include <stdbool.h>
 
-// Tetris piece templates [piece_type][rotation][y][x]
-const int piece_templates[PIECE_COUNT][4][PIECE_SIZE][PIECE_SIZE] = {
-    // I piece
-    {
-        {{0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0}},
-        {{0,0,1,0}, {0,0,1,0}, {0,0,1,0}, {0,0,1,0}},
-        {{0,0,0,0}, {0,0,0,0}, {1,1,1,1}, {0,0,0,0}},
-        {{0,1,0,0}, {0,1,0,0}, {0,1,0,0}, {0,1,0,0}}
-    },
-    // O piece
-    {
-        {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
-        {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
-        {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
-        {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}}
-    },
-    // T piece
-    {
-        {{0,0,0,0}, {0,1,0,0}, {1,1,1,0}, {0,0,0,0}},
-        {{0,0,0,0}, {0,1,0,0}, {0,1,1,0}, {0,1,0,0}},
-        {{0,0,0,0}, {0,0,0,0}, {1,1,1,0}, {0,1,0,0}},
-        {{0,0,0,0}, {0,1,0,0}, {1,1,0,0}, {0,1,0,0}}
-    },
-    // S piece
-    {
-        {{0,0,0,0}, {0,1,1,0}, {1,1,0,0}, {0,0,0,0}},
-        {{0,0,0,0}, {0,1,0,0}, {0,1,1,0}, {0,0,1,0}},
-        {{0,0,0,0}, {0,0,0,0}, {0,1,1,0}, {1,1,0,0}},
-        {{0,0,0,0}, {1,0,0,0}, {1,1,0,0}, {0,1,0,0}}
-    },
-    // Z piece
-    {
-        {{0,0,0,0}, {1,1,0,0}, {0,1,1,0}, {0,0,0,0}},
-        {{0,0,0,0}, {0,0,1,0}, {0,1,1,0}, {0,1,0,0}},
-        {{0,0,0,0}, {0,0,0,0}, {1,1,0,0}, {0,1,1,0}},
-        {{0,0,0,0}, {0,1,0,0}, {1,1,0,0}, {1,0,0,0}}
-    },
-    // J piece
-    {
-        {{0,0,0,0}, {1,0,0,0}, {1,1,1,0}, {0,0,0,0}},
-        {{0,0,0,0}, {0,1,1,0}, {0,1,0,0}, {0,1,0,0}},
-        {{0,0,0,0}, {0,0,0,0}, {1,1,1,0}, {0,0,1,0}},
-        {{0,0,0,0}, {0,1,0,0}, {0,1,0,0}, {1,1,0,0}}
-    },
-    // L piece
-    {
-        {{0,0,0,0}, {0,0,1,0}, {1,1,1,0}, {0,0,0,0}},
-        {{0,0,0,0}, {0,1,0,0}, {0,1,0,0}, {0,1,1,0}},
-        {{0,0,0,0}, {0,0,0,0}, {1,1,1,0}, {1,0,0,0}},
-        {{0,0,0,0}, {1,1,0,0}, {0,1,0,0}, {0,1,0,0}}
-    }
-};
-
 void init_piece(Piece_t *piece, PieceType_t type) {
     if (!piece) return;
     
@@ -65,12 +14,7 @@ void init_piece(Piece_t *piece, PieceType_t type) {
     piece->y = 0;  // Start at top
     piece->rotation = 0;
     
-    // Copy the template
-    for (int i = 0; i < PIECE_SIZE; i++) {
-        for (int j = 0; j < PIECE_SIZE; j++) {
-            piece->shape[i][j] = piece_templates[type][0][i][j];
-        }
-    }
+    memcpy(piece->shape, piece_templates[type][0], sizeof(piece->shape));
 }
 
 void rotate_piece(Piece_t *piece) {
@@ -78,12 +22,7 @@ void rotate_piece(Piece_t *piece) {
     
     int new_rotation = (piece->rotation + 1) % 4;
     
-    // Copy the new rotation template
-    for (int i = 0; i < PIECE_SIZE; i++) {
-        for (int j = 0; j < PIECE_SIZE; j++) {
-            piece->shape[i][j] = piece_templates[piece->type][new_rotation][i][j];
-        }
-    }
+    memcpy(piece->shape, piece_templates[piece->type][new_rotation], sizeof(piece->shape));
     
     piece->rotation = new_rotation;
 }
@@ -104,46 +43,83 @@ PieceType_t get_random_piece_type(void) {
     return rand() % PIECE_COUNT;
 }
 
-bool is_valid_position(const TetrisGame_t *game, const Piece_t *piece) {
-    if (!game || !piece) return false;
+void seed_piece_generator(TetrisGame_t *game, uint64_t seed) {
+    if (!game) return;
     
-    for (int i = 0; i < PIECE_SIZE; i++) {
-        for (int j = 0; j < PIECE_SIZE; j++) {
-            if (piece->shape[i][j]) {
-                int board_x = piece->x + j;
-                int board_y = piece->y + i;
-                
-                // Check boundaries
-                if (board_x < 0 || board_x >= BOARD_WIDTH || 
-                    board_y >= TOTAL_HEIGHT) {
-                    return false;
-                }
-                
-                // Check collision with existing blocks (only if not in spawn area)
-                if (board_y >= 0 && game->board[board_y][board_x]) {
-                    return false;
-                }
-            }
-        }
+    // xorshift must never hold zero
+    game->rng_state = seed ? seed : 0x9e3779b97f4a7c15ull;
+}
+
+PieceType_t next_piece_type(TetrisGame_t *game) {
+    // Per-game xorshift64* so seeded games are reproducible and independent
+    uint64_t x = game->rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    game->rng_state = x;
+    
+    return (PieceType_t)(((x * 0x2545f4914f6cdd1dull) >> 32) % PIECE_COUNT);
+}
+
+// Tops the ring up in one batch so the generator runs in bursts, not per spawn
+static void piece_queue_fill(TetrisGame_t *game) {
+    PieceQueue_t *queue = &game->queue;
+
+    while (queue->count < PIECE_QUEUE_CAPACITY) {
+        int slot = (queue->head + queue->count) & (PIECE_QUEUE_CAPACITY - 1);
+        uint8_t type = (uint8_t)next_piece_type(game);
+        queue->types[slot] = type;
+        queue->types[slot + PIECE_QUEUE_CAPACITY] = type;
+        queue->count++;
     }
+}
+
+void piece_queue_reset(TetrisGame_t *game) {
+    if (!game) return;
+    
+    game->queue.head = 0;
+    game->queue.count = 0;
+    piece_queue_fill(game);
+}
+
+PieceType_t piece_queue_pop(TetrisGame_t *game) {
+    PieceQueue_t *queue = &game->queue;
+    if (queue->count == 0) piece_queue_fill(game);
+
+    PieceType_t type = queue->types[queue->head];
+    queue->head = (queue->head + 1) & (PIECE_QUEUE_CAPACITY - 1);
+    queue->count--;
+    if (queue->count < queue->preview) piece_queue_fill(game);
+
+    return type;
+}
+
+bool piece_queue_set_preview(TetrisGame_t *game, int preview) {
+    if (!game || preview < PREVIEW_MIN || preview > PREVIEW_MAX) return false;
     
+    if (game->queue.preview != preview) {
+        game->queue.preview = preview;
+        game->version++;
+    }
     return true;
 }
 
+const uint8_t *piece_queue_view(const TetrisGame_t *game, int *count) {
+    const PieceQueue_t *queue = &game->queue;
+    *count = queue->count < queue->preview ? queue->count : queue->preview;
+    return queue->types + queue->head;
+}
+
+bool is_valid_position(const TetrisGame_t *game, const Piece_t *piece) {
+    if (!game || !piece) return false;
+    
+    return game->board.kernels->fits(&game->board, piece);
+}
+
 void place_piece(TetrisGame_t *game, const Piece_t *piece) {
     if (!game || !piece) return;
     
-    for (int i = 0; i < PIECE_SIZE; i++) {
-        for (int j = 0; j < PIECE_SIZE; j++) {
-            if (piece->shape[i][j]) {
-                int board_x = piece->x + j;
-                int board_y = piece->y + i;
-                
-                if (board_x >= 0 && board_x < BOARD_WIDTH && 
-                    board_y >= 0 && board_y < TOTAL_HEIGHT) {
-                    game->board[board_y][board_x] = 1;
-                }
-            }
-        }
-    }
+    game->board_hash = board_hash_place(game->board_hash, &game->board, piece);
+    game->board.kernels->place(&game->board, piece);
+    board_color_piece(&game->board, piece);
 }
\ No newline at end of file
@@ -12,6 +12,15 @@ void init_piece(Piece_t *piece, PieceType_t type);
 void rotate_piece(Piece_t *piece);
 void copy_piece(const Piece_t *src, Piece_t *dest);
 PieceType_t get_random_piece_type(void);
+void seed_piece_generator(TetrisGame_t *game, uint64_t seed);
+PieceType_t next_piece_type(TetrisGame_t *game);
+
+// Preview queue
+void piece_queue_reset(TetrisGame_t *game);
+PieceType_t piece_queue_pop(TetrisGame_t *game);
+bool piece_queue_set_preview(TetrisGame_t *game, int preview);
+const uint8_t *piece_queue_view(const TetrisGame_t *game, int *count);
+
 bool is_valid_position(const TetrisGame_t *game, const Piece_t *piece);
 void place_piece(TetrisGame_t *game, const Piece_t *piece);
 
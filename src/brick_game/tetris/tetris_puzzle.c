@@ -0,0 +1,495 @@
+#define _POSIX_C_SOURCE 200809L
+#include "tetris_puzzle.h"
+#include "tetris_board.h"
+#include "tetris_hash.h"
+#include "tetris_piece_tables.h"
+#include "tetris_pieces.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PUZZLE_DEFAULT_TABLE_BYTES ((size_t)64 << 20)
+#define PUZZLE_MIN_TABLE_ENTRIES 1024
+#define PUZZLE_NO_MOVE -1
+
+static const char piece_letters[PIECE_COUNT] = {'I', 'O', 'T', 'S', 'Z', 'J', 'L'};
+
+// Memoised result for one (board, queue position) state
+typedef struct {
+    uint64_t key;  // 0 marks an empty slot
+    int32_t value;
+    int16_t move;  // shape * 128 + x + PIECE_SIZE
+    bool exact;    // otherwise value is only an upper bound
+} PuzzleEntry_t;
+
+typedef struct {
+    const Puzzle_t *puzzle;
+    PuzzleResult_t *result;
+    bool perfect_clear;
+    int max_height;
+    Board_t boards[PUZZLE_MAX_PIECES + 1];  // boards[d] is the state before piece d
+    uint64_t hashes[PUZZLE_MAX_PIECES + 1];  // board_hash() of boards[d]
+    PuzzleEntry_t *table;
+    size_t table_mask;
+    int parity_budget[PUZZLE_MAX_PIECES + 1];
+    Piece_t shapes[PIECE_COUNT][4];  // distinct rotations per piece type
+    int shape_rotation[PIECE_COUNT][4];
+    int shape_count[PIECE_COUNT];
+} Solver_t;
+
+bool puzzle_init(Puzzle_t *puzzle, int width, int height) {
+    if (!puzzle) return false;
+
+    memset(puzzle, 0, sizeof(Puzzle_t));
+    return board_init(&puzzle->board, width, height);
+}
+
+void puzzle_free(Puzzle_t *puzzle) {
+    if (!puzzle) return;
+
+    board_free(&puzzle->board);
+    puzzle->piece_count = 0;
+}
+
+static int piece_from_letter(char c) {
+    for (int i = 0; i < PIECE_COUNT; i++) {
+        if (piece_letters[i] == c || piece_letters[i] == c - 'a' + 'A') return i;
+    }
+    return -1;
+}
+
+static bool is_row_line(const char *line, int length) {
+    for (int i = 0; i < length; i++) {
+        if (line[i] != '.' && line[i] != 'X') return false;
+    }
+    return length > 0;
+}
+
+// Calls back once per non-blank, non-comment line with trailing space trimmed
+typedef bool (*LineFn_t)(void *ctx, const char *line, int length);
+
+static bool for_each_line(const char *text, LineFn_t fn, void *ctx) {
+    while (*text) {
+        const char *end = strchr(text, '\n');
+        int length = end ? (int)(end - text) : (int)strlen(text);
+        const char *next = end ? end + 1 : text + length;
+
+        while (length > 0 && (text[length - 1] == '\r' || text[length - 1] == ' ' ||
+                              text[length - 1] == '\t')) {
+            length--;
+        }
+        if (length > 0 && text[0] != '#' && !fn(ctx, text, length)) return false;
+        text = next;
+    }
+    return true;
+}
+
+typedef struct {
+    Puzzle_t *puzzle;
+    int width;
+    int height;
+    int row_count;
+    int row;
+} ParseState_t;
+
+static bool parse_header(void *ctx, const char *line, int length) {
+    ParseState_t *state = ctx;
+
+    if (is_row_line(line, length)) {
+        state->row_count++;
+        return true;
+    }
+    if (length > 5 && strncmp(line, "size ", 5) == 0) {
+        return sscanf(line + 5, "%d %d", &state->width, &state->height) == 2;
+    }
+    if (length > 7 && strncmp(line, "pieces ", 7) == 0) {
+        for (int i = 7; i < length; i++) {
+            if (line[i] == ' ') continue;
+
+            int type = piece_from_letter(line[i]);
+            if (type < 0 || state->puzzle->piece_count >= PUZZLE_MAX_PIECES) return false;
+            state->puzzle->pieces[state->puzzle->piece_count++] = type;
+        }
+        return true;
+    }
+    return false;
+}
+
+static bool parse_rows(void *ctx, const char *line, int length) {
+    ParseState_t *state = ctx;
+    Board_t *board = &state->puzzle->board;
+
+    if (!is_row_line(line, length)) return true;
+    if (length != board->width) return false;
+
+    // Rows are bottom-aligned: the last one listed is the bottom row
+    int y = board->total_height - state->row_count + state->row++;
+    for (int x = 0; x < length; x++) {
+        board_set_cell(board, x, y, line[x] == 'X');
+    }
+    return true;
+}
+
+bool puzzle_parse(Puzzle_t *puzzle, const char *text) {
+    if (!puzzle || !text) return false;
+
+    memset(puzzle, 0, sizeof(Puzzle_t));
+    ParseState_t state = {puzzle, BOARD_WIDTH, BOARD_HEIGHT, 0, 0};
+
+    if (!for_each_line(text, parse_header, &state) || puzzle->piece_count == 0) {
+        return false;
+    }
+    // puzzle_init() resets the queue parsed above
+    PieceType_t pieces[PUZZLE_MAX_PIECES];
+    int piece_count = puzzle->piece_count;
+    memcpy(pieces, puzzle->pieces, sizeof(pieces));
+
+    if (state.row_count > state.height || !puzzle_init(puzzle, state.width, state.height)) {
+        return false;
+    }
+    memcpy(puzzle->pieces, pieces, sizeof(pieces));
+    puzzle->piece_count = piece_count;
+
+    if (!for_each_line(text, parse_rows, &state)) {
+        puzzle_free(puzzle);
+        return false;
+    }
+    return true;
+}
+
+void puzzle_default_options(PuzzleOptions_t *options) {
+    options->perfect_clear = true;
+    options->max_height = 0;
+    options->table_bytes = PUZZLE_DEFAULT_TABLE_BYTES;
+}
+
+static bool board_empty(const Board_t *board) {
+    return board_stack_height(board) == 0;
+}
+
+static uint64_t state_key(const Solver_t *s, int depth) {
+    uint64_t key = s->hashes[depth] ^ UINT64_C(0x9e3779b97f4a7c15) * (uint64_t)(depth + 1);
+    return key ? key : 1;
+}
+
+// Cheap necessary conditions for clearing the board with the pieces left:
+// the stack plus whole pieces must exactly fill some number of rows, and on
+// even widths the even/odd column imbalance must be fixable. Only I, T, L
+// and J can shift that imbalance, and line clears never change it.
+static bool clear_possible(const Solver_t *s, const Board_t *board, int depth) {
+    const uint64_t even_columns = UINT64_C(0x5555555555555555) & board->full_row;
+    const int width = board->width;
+    int height = board_stack_height(board);
+    int filled = 0;
+    int imbalance = 0;
+
+    for (int y = board->total_height - height; y < board->total_height; y++) {
+        uint64_t row = board->kernels->get_row(board, y);
+        filled += __builtin_popcountll(row);
+        imbalance += __builtin_popcountll(row & even_columns) -
+                     __builtin_popcountll(row & ~even_columns);
+    }
+
+    if (width % 2 == 0 && abs(imbalance) > s->parity_budget[depth]) return false;
+
+    int cells_left = (s->puzzle->piece_count - depth) * PIECE_SIZE;
+    for (int rows = height > 0 ? height : 1; rows <= s->max_height; rows++) {
+        int needed = width * rows - filled;
+        if (needed > cells_left) break;
+        if (needed % PIECE_SIZE == 0) return true;
+    }
+    return false;
+}
+
+// Most lines the remaining pieces could clear. Rows never merge, so each
+// cleared line is one stack row completed or one new row filled outright;
+// completing the emptiest-needing rows first gives the most lines, and any
+// cell a piece leaves outside those rows is wasted.
+static int line_bound(const Solver_t *s, const Board_t *board, int depth) {
+    const int width = board->width;
+    int cells = (s->puzzle->piece_count - depth) * PIECE_SIZE;
+    int rows_missing[BOARD_MAX_WIDTH + 1] = {0};  // stack rows by empty cells
+
+    for (int y = board->total_height - board_stack_height(board); y < board->total_height; y++) {
+        rows_missing[width - __builtin_popcountll(board->kernels->get_row(board, y))]++;
+    }
+
+    int lines = 0;
+    for (int missing = 1; missing < width; missing++) {
+        int rows = cells / missing;
+        if (rows > rows_missing[missing]) rows = rows_missing[missing];
+        lines += rows;
+        cells -= rows * missing;
+        if (rows < rows_missing[missing]) return lines;
+    }
+    return lines + cells / width;
+}
+
+static PuzzleEntry_t *table_slot(const Solver_t *s, uint64_t key) {
+    return &s->table[key & s->table_mask];
+}
+
+// Hard drop one shape at column x from boards[depth] into boards[depth + 1].
+// Returns the lines cleared, or -1 if the placement is illegal or too tall.
+static int play_move(Solver_t *s, int depth, int shape, int x, int *landed) {
+    const Board_t *from = &s->boards[depth];
+    Board_t *to = &s->boards[depth + 1];
+    Piece_t piece = s->shapes[s->puzzle->pieces[depth]][shape];
+
+    // Everything above the stack is empty, so start the drop just above it
+    int height = board_stack_height(from);
+    piece.x = x;
+    piece.y = 0;
+    if (!from->kernels->fits(from, &piece)) return -1;
+    if (from->total_height - height - PIECE_SIZE > 0) {
+        piece.y = from->total_height - height - PIECE_SIZE;
+    }
+
+    while (from->kernels->fits(from, &piece)) {
+        piece.y++;
+    }
+    piece.y--;
+
+    // The piece may not reach above the row limit even before lines clear:
+    // every row a perfect clear touches must be cleared, and in lines mode
+    // the limit is what keeps the search to stacks that can still pay off
+    int top = piece_extents[piece.type][piece.rotation].top;
+    if (from->total_height - piece.y - top > s->max_height) {
+        s->result->pruned++;
+        return -1;
+    }
+
+    board_copy(to, from);
+    uint64_t hash = board_hash_place(s->hashes[depth], from, &piece);
+    to->kernels->place(to, &piece);
+    s->hashes[depth + 1] = board_hash_clear(hash, to, piece.y, piece.y + PIECE_SIZE - 1);
+    int lines = to->kernels->clear_lines(to);
+
+    if (board_spawn_area_occupied(to) || board_stack_height(to) > s->max_height) {
+        s->result->pruned++;
+        return -1;
+    }
+    if (landed) *landed = piece.y;
+    return lines;
+}
+
+// Best value reachable from boards[depth]: 1/0 for perfect clear found or
+// not, otherwise the most lines the remaining pieces can clear. Only values
+// above floor are exact; anything else is an upper bound, which is all the
+// caller needs to know that this branch cannot beat what it already has.
+static int search(Solver_t *s, int depth, int floor) {
+    const Board_t *board = &s->boards[depth];
+    PuzzleResult_t *result = s->result;
+
+    result->nodes++;
+    if (depth == s->puzzle->piece_count) return 0;
+    if (s->perfect_clear && !clear_possible(s, board, depth)) {
+        result->pruned++;
+        return 0;
+    }
+
+    // Nothing beats clearing every cell on the board
+    const int bound = s->perfect_clear ? 1 : line_bound(s, board, depth);
+    if (bound <= floor) {
+        result->pruned++;
+        return bound;
+    }
+
+    uint64_t key = state_key(s, depth);
+    PuzzleEntry_t *entry = table_slot(s, key);
+    result->table_probes++;
+    if (entry->key == key && (entry->exact || entry->value <= floor)) {
+        result->table_hits++;
+        return entry->value;
+    }
+
+    const int type = s->puzzle->pieces[depth];
+    int best = -1;
+    int best_move = PUZZLE_NO_MOVE;
+
+    for (int shape = 0; shape < s->shape_count[type] && best < bound; shape++) {
+        for (int x = 1 - PIECE_SIZE; x < board->width; x++) {
+            int lines = play_move(s, depth, shape, x, NULL);
+            if (lines < 0) continue;
+
+            int value;
+            if (s->perfect_clear) {
+                value = board_empty(&s->boards[depth + 1]) ? 1 : search(s, depth + 1, -1);
+            } else {
+                int child_floor = (best > floor ? best : floor) - lines;
+                value = lines + search(s, depth + 1, child_floor);
+            }
+
+            if (value > best) {
+                best = value;
+                best_move = shape * 128 + x + PIECE_SIZE;
+                if (best >= bound) break;
+            }
+        }
+    }
+
+    if (best < 0) best = 0;
+
+    // Always replace: recent states are the likeliest to be revisited
+    entry = table_slot(s, key);
+    entry->key = key;
+    entry->value = best;
+    entry->move = (int16_t)best_move;
+    entry->exact = best > floor || best_move == PUZZLE_NO_MOVE;
+    return best;
+}
+
+// Lines mode has no natural ceiling, and without one the search wanders
+// through tall stacks whose cells can never all be cleared
+static int default_max_height(const Solver_t *s, const Board_t *board) {
+    if (s->perfect_clear) return board->height;
+
+    int cells = s->puzzle->piece_count * PIECE_SIZE;
+    int rows = board_stack_height(board) + (cells + board->width - 1) / board->width;
+    return rows > PIECE_SIZE ? rows : PIECE_SIZE;
+}
+
+static bool solver_init(Solver_t *s, const Puzzle_t *puzzle, const PuzzleOptions_t *options,
+                        PuzzleResult_t *result) {
+    const Board_t *board = &puzzle->board;
+
+    memset(s, 0, sizeof(Solver_t));
+    s->puzzle = puzzle;
+    s->result = result;
+    s->perfect_clear = options->perfect_clear;
+    s->max_height = options->max_height > 0 ? options->max_height : default_max_height(s, board);
+    if (s->max_height > board->height) s->max_height = board->height;
+
+    // Every column is tried, so rotations that only shift the cells within
+    // the piece box give the same placements; keep the canonical one
+    for (int type = 0; type < PIECE_COUNT; type++) {
+        Piece_t piece;
+        init_piece(&piece, type);
+
+        for (int rotation = 0; rotation < 4; rotation++) {
+            if (rotation > 0) rotate_piece(&piece);
+            if (piece_canonical_rotation[type][rotation] != rotation) continue;
+
+            s->shape_rotation[type][s->shape_count[type]] = rotation;
+            s->shapes[type][s->shape_count[type]++] = piece;
+        }
+    }
+
+    // Column imbalance each remaining piece can correct at most
+    for (int d = puzzle->piece_count - 1; d >= 0; d--) {
+        int type = puzzle->pieces[d];
+        int budget = type == PIECE_I ? 4 : (type == PIECE_T || type == PIECE_J || type == PIECE_L) ? 2 : 0;
+        s->parity_budget[d] = s->parity_budget[d + 1] + budget;
+    }
+
+    size_t entries = PUZZLE_MIN_TABLE_ENTRIES;
+    while (entries * 2 * sizeof(PuzzleEntry_t) <= options->table_bytes) {
+        entries *= 2;
+    }
+    s->table = calloc(entries, sizeof(PuzzleEntry_t));
+    s->table_mask = entries - 1;
+    if (!s->table) return false;
+
+    for (int d = 0; d <= puzzle->piece_count; d++) {
+        if (!board_init(&s->boards[d], board->width, board->height)) return false;
+    }
+    board_copy(&s->boards[0], board);
+    s->hashes[0] = board_hash(board);
+
+    // A perfect clear can never involve more rows than all cells could fill
+    if (s->perfect_clear) {
+        int cells = puzzle->piece_count * PIECE_SIZE;
+        for (int y = 0; y < board->total_height; y++) {
+            cells += __builtin_popcountll(board->kernels->get_row(board, y));
+        }
+        if (cells / board->width < s->max_height) s->max_height = cells / board->width;
+    }
+
+    result->memory_bytes = entries * sizeof(PuzzleEntry_t) +
+                           (size_t)(puzzle->piece_count + 1) * board->total_height *
+                               board_row_bytes(board);
+    return true;
+}
+
+static void solver_free(Solver_t *s) {
+    for (int d = 0; d <= PUZZLE_MAX_PIECES; d++) {
+        board_free(&s->boards[d]);
+    }
+    free(s->table);
+}
+
+// Walk the table from the root; each probe is a hit since search() stores
+// the state it was called on last
+static void reconstruct(Solver_t *s) {
+    PuzzleResult_t *result = s->result;
+
+    for (int depth = 0; depth < s->puzzle->piece_count; depth++) {
+        search(s, depth, -1);
+
+        uint64_t key = state_key(s, depth);
+        const PuzzleEntry_t *entry = table_slot(s, key);
+        if (entry->key != key || entry->move == PUZZLE_NO_MOVE) break;
+
+        int type = s->puzzle->pieces[depth];
+        int shape = entry->move / 128;
+        int x = entry->move % 128 - PIECE_SIZE;
+        int landed = 0;
+        int lines = play_move(s, depth, shape, x, &landed);
+        if (lines < 0) break;
+
+        PuzzlePlacement_t *placement = &result->placements[result->placement_count++];
+        placement->type = type;
+        placement->rotation = s->shape_rotation[type][shape];
+        placement->x = x;
+        placement->y = landed;
+        result->lines += lines;
+
+        if (s->perfect_clear && board_empty(&s->boards[depth + 1])) {
+            result->solved = true;
+            break;
+        }
+    }
+}
+
+static double elapsed_seconds(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+bool puzzle_solve(const Puzzle_t *puzzle, const PuzzleOptions_t *options, PuzzleResult_t *result) {
+    if (!puzzle || !puzzle->board.rows || !result) return false;
+    if (puzzle->piece_count < 0 || puzzle->piece_count > PUZZLE_MAX_PIECES) return false;
+
+    PuzzleOptions_t defaults;
+    if (!options) {
+        puzzle_default_options(&defaults);
+        options = &defaults;
+    }
+
+    memset(result, 0, sizeof(PuzzleResult_t));
+    Solver_t *s = malloc(sizeof(Solver_t));
+    if (!s) return false;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    bool ok = solver_init(s, puzzle, options, result);
+    if (ok) {
+        search(s, 0, -1);
+        result->seconds = elapsed_seconds(&start);
+
+        // Keep the statistics about the search itself
+        PuzzleResult_t stats = *result;
+        reconstruct(s);
+        result->nodes = stats.nodes;
+        result->pruned = stats.pruned;
+        result->table_probes = stats.table_probes;
+        result->table_hits = stats.table_hits;
+    }
+
+    solver_free(s);
+    free(s);
+    return ok;
+}
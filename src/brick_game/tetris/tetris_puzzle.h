@@ -0,0 +1,59 @@
+#ifndef TETRIS_PUZZLE_H
+#define TETRIS_PUZZLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tetris_types.h"
+
+#define PUZZLE_MAX_PIECES 32
+
+// A starting board plus the fixed sequence of pieces to place on it
+typedef struct {
+    Board_t board;
+    PieceType_t pieces[PUZZLE_MAX_PIECES];
+    int piece_count;
+} Puzzle_t;
+
+typedef struct {
+    bool perfect_clear;  // search for an empty board; otherwise maximise lines
+    // Stack rows allowed. 0 picks the visible height for a perfect clear,
+    // and the starting stack plus the rows the queue could fill for lines
+    int max_height;
+    size_t table_bytes;  // transposition table budget
+} PuzzleOptions_t;
+
+// Hard-drop placement of one piece; y is the row it lands on
+typedef struct {
+    PieceType_t type;
+    int rotation;
+    int x;
+    int y;
+} PuzzlePlacement_t;
+
+typedef struct {
+    bool solved;  // perfect clear reached (perfect_clear mode only)
+    int lines;
+    int placement_count;
+    PuzzlePlacement_t placements[PUZZLE_MAX_PIECES];
+    uint64_t nodes;
+    uint64_t pruned;
+    uint64_t table_probes;
+    uint64_t table_hits;
+    size_t memory_bytes;
+    double seconds;
+} PuzzleResult_t;
+
+bool puzzle_init(Puzzle_t *puzzle, int width, int height);
+void puzzle_free(Puzzle_t *puzzle);
+
+// Text format, '#' starts a comment:
+//   size W H         optional, defaults to the classic board
+//   pieces IOTSZJL   the queue, in order
+//   ..XX......       board rows, the last one is the bottom row
+bool puzzle_parse(Puzzle_t *puzzle, const char *text);
+
+void puzzle_default_options(PuzzleOptions_t *options);
+bool puzzle_solve(const Puzzle_t *puzzle, const PuzzleOptions_t *options, PuzzleResult_t *result);
+
+#endif  // TETRIS_PUZZLE_H
@@ -0,0 +1,236 @@
+#include "tetris_rowscan.h"
+#include <pthread.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ROWSCAN_X86 1
+#include <immintrin.h>
+#endif
+
+#define ROWSCAN_FN_(bits, isa) rows_clear_full_##bits##_##isa
+#define ROWSCAN_FN(bits, isa) ROWSCAN_FN_(bits, isa)
+
+// Scalar fallback, always available
+#define ISA scalar
+#define ISA_ATTR
+
+#define ROW_BITS 16
+#define ROW_T uint16_t
+#include "tetris_rowscan_impl.h"
+#undef ROW_T
+#undef ROW_BITS
+
+#define ROW_BITS 32
+#define ROW_T uint32_t
+#include "tetris_rowscan_impl.h"
+#undef ROW_T
+#undef ROW_BITS
+
+#define ROW_BITS 64
+#define ROW_T uint64_t
+#include "tetris_rowscan_impl.h"
+#undef ROW_T
+#undef ROW_BITS
+
+#undef ISA_ATTR
+#undef ISA
+
+#ifdef ROWSCAN_X86
+
+// SSE2: 8, 4 or 2 rows per compare
+#define ISA sse2
+#define ISA_ATTR __attribute__((target("sse2")))
+#define VEC_T __m128i
+#define VEC_LOAD(p) _mm_loadu_si128((const __m128i *)(p))
+#define VEC_STORE(p, v) _mm_storeu_si128((__m128i *)(p), (v))
+
+#define ROW_BITS 16
+#define ROW_T uint16_t
+#define VEC_ROWS 8
+#define VEC_SPLAT(f) _mm_set1_epi16((short)(f))
+#define VEC_ANY_EQ(v, f) _mm_movemask_epi8(_mm_cmpeq_epi16((v), (f)))
+#include "tetris_rowscan_impl.h"
+#undef VEC_ANY_EQ
+#undef VEC_SPLAT
+#undef VEC_ROWS
+#undef ROW_T
+#undef ROW_BITS
+
+#define ROW_BITS 32
+#define ROW_T uint32_t
+#define VEC_ROWS 4
+#define VEC_SPLAT(f) _mm_set1_epi32((int)(f))
+#define VEC_ANY_EQ(v, f) _mm_movemask_epi8(_mm_cmpeq_epi32((v), (f)))
+#include "tetris_rowscan_impl.h"
+#undef VEC_ANY_EQ
+#undef VEC_SPLAT
+#undef VEC_ROWS
+#undef ROW_T
+#undef ROW_BITS
+
+// SSE2 has no 64-bit compare: a row matches when both 32-bit halves do
+static inline __attribute__((target("sse2"))) int sse2_any_eq64(__m128i v, __m128i f) {
+    __m128i eq = _mm_cmpeq_epi32(v, f);
+    eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_movemask_epi8(eq);
+}
+
+#define ROW_BITS 64
+#define ROW_T uint64_t
+#define VEC_ROWS 2
+#define VEC_SPLAT(f) _mm_set1_epi64x((long long)(f))
+#define VEC_ANY_EQ(v, f) sse2_any_eq64((v), (f))
+#include "tetris_rowscan_impl.h"
+#undef VEC_ANY_EQ
+#undef VEC_SPLAT
+#undef VEC_ROWS
+#undef ROW_T
+#undef ROW_BITS
+
+#undef VEC_STORE
+#undef VEC_LOAD
+#undef VEC_T
+#undef ISA_ATTR
+#undef ISA
+
+// AVX2: 16, 8 or 4 rows per compare
+#define ISA avx2
+#define ISA_ATTR __attribute__((target("avx2")))
+#define VEC_T __m256i
+#define VEC_LOAD(p) _mm256_loadu_si256((const __m256i *)(p))
+#define VEC_STORE(p, v) _mm256_storeu_si256((__m256i *)(p), (v))
+
+#define ROW_BITS 16
+#define ROW_T uint16_t
+#define VEC_ROWS 16
+#define VEC_SPLAT(f) _mm256_set1_epi16((short)(f))
+#define VEC_ANY_EQ(v, f) _mm256_movemask_epi8(_mm256_cmpeq_epi16((v), (f)))
+#include "tetris_rowscan_impl.h"
+#undef VEC_ANY_EQ
+#undef VEC_SPLAT
+#undef VEC_ROWS
+#undef ROW_T
+#undef ROW_BITS
+
+#define ROW_BITS 32
+#define ROW_T uint32_t
+#define VEC_ROWS 8
+#define VEC_SPLAT(f) _mm256_set1_epi32((int)(f))
+#define VEC_ANY_EQ(v, f) _mm256_movemask_epi8(_mm256_cmpeq_epi32((v), (f)))
+#include "tetris_rowscan_impl.h"
+#undef VEC_ANY_EQ
+#undef VEC_SPLAT
+#undef VEC_ROWS
+#undef ROW_T
+#undef ROW_BITS
+
+#define ROW_BITS 64
+#define ROW_T uint64_t
+#define VEC_ROWS 4
+#define VEC_SPLAT(f) _mm256_set1_epi64x((long long)(f))
+#define VEC_ANY_EQ(v, f) _mm256_movemask_epi8(_mm256_cmpeq_epi64((v), (f)))
+#include "tetris_rowscan_impl.h"
+#undef VEC_ANY_EQ
+#undef VEC_SPLAT
+#undef VEC_ROWS
+#undef ROW_T
+#undef ROW_BITS
+
+#undef VEC_STORE
+#undef VEC_LOAD
+#undef VEC_T
+#undef ISA_ATTR
+#undef ISA
+
+#else  // ROWSCAN_X86
+
+// Other targets only have the scalar path
+int rows_clear_full_16_sse2(uint16_t *rows, int count, int first, uint16_t full) {
+    return rows_clear_full_16_scalar(rows, count, first, full);
+}
+int rows_clear_full_16_avx2(uint16_t *rows, int count, int first, uint16_t full) {
+    return rows_clear_full_16_scalar(rows, count, first, full);
+}
+int rows_clear_full_32_sse2(uint32_t *rows, int count, int first, uint32_t full) {
+    return rows_clear_full_32_scalar(rows, count, first, full);
+}
+int rows_clear_full_32_avx2(uint32_t *rows, int count, int first, uint32_t full) {
+    return rows_clear_full_32_scalar(rows, count, first, full);
+}
+int rows_clear_full_64_sse2(uint64_t *rows, int count, int first, uint64_t full) {
+    return rows_clear_full_64_scalar(rows, count, first, full);
+}
+int rows_clear_full_64_avx2(uint64_t *rows, int count, int first, uint64_t full) {
+    return rows_clear_full_64_scalar(rows, count, first, full);
+}
+
+#endif  // ROWSCAN_X86
+
+bool rowscan_level_supported(RowScanLevel_t level) {
+    switch (level) {
+        case ROWSCAN_SCALAR:
+            return true;
+#ifdef ROWSCAN_X86
+        case ROWSCAN_SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        case ROWSCAN_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+static RowScanLevel_t best_level;
+static pthread_once_t best_level_once = PTHREAD_ONCE_INIT;
+
+static void detect_best_level(void) {
+    RowScanLevel_t best = ROWSCAN_SCALAR;
+    for (int level = ROWSCAN_SCALAR + 1; level < ROWSCAN_LEVEL_COUNT; level++) {
+        if (rowscan_level_supported(level)) {
+            best = level;
+        }
+    }
+    best_level = best;
+}
+
+// Games are created from several threads at once (server workers, tune)
+RowScanLevel_t rowscan_best_level(void) {
+    pthread_once(&best_level_once, detect_best_level);
+    return best_level;
+}
+
+const char *rowscan_level_name(RowScanLevel_t level) {
+    switch (level) {
+        case ROWSCAN_SCALAR: return "scalar";
+        case ROWSCAN_SSE2: return "sse2";
+        case ROWSCAN_AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+int rows_clear_full(RowScanLevel_t level, void *rows, int row_bits,
+                    int count, int first, uint64_t full) {
+    if (!rowscan_level_supported(level)) {
+        level = ROWSCAN_SCALAR;
+    }
+
+    switch (row_bits) {
+        case 16:
+            if (level == ROWSCAN_AVX2) return rows_clear_full_16_avx2(rows, count, first, full);
+            if (level == ROWSCAN_SSE2) return rows_clear_full_16_sse2(rows, count, first, full);
+            return rows_clear_full_16_scalar(rows, count, first, full);
+        case 32:
+            if (level == ROWSCAN_AVX2) return rows_clear_full_32_avx2(rows, count, first, full);
+            if (level == ROWSCAN_SSE2) return rows_clear_full_32_sse2(rows, count, first, full);
+            return rows_clear_full_32_scalar(rows, count, first, full);
+        case 64:
+            if (level == ROWSCAN_AVX2) return rows_clear_full_64_avx2(rows, count, first, full);
+            if (level == ROWSCAN_SSE2) return rows_clear_full_64_sse2(rows, count, first, full);
+            return rows_clear_full_64_scalar(rows, count, first, full);
+        default:
+            return 0;
+    }
+}
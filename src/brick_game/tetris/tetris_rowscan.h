@@ -0,0 +1,36 @@
+#ifndef TETRIS_ROWSCAN_H
+#define TETRIS_ROWSCAN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Instruction set levels for full-row detection and compaction
+typedef enum {
+    ROWSCAN_SCALAR,
+    ROWSCAN_SSE2,
+    ROWSCAN_AVX2,
+    ROWSCAN_LEVEL_COUNT
+} RowScanLevel_t;
+
+// CPU dispatch (CPUID is queried once)
+RowScanLevel_t rowscan_best_level(void);
+bool rowscan_level_supported(RowScanLevel_t level);
+const char *rowscan_level_name(RowScanLevel_t level);
+
+// Removes every row equal to full among rows[first..count), moves the
+// survivors (including rows above first) down and zero-fills the top.
+// Returns the number of removed rows.
+int rows_clear_full(RowScanLevel_t level, void *rows, int row_bits,
+                    int count, int first, uint64_t full);
+
+int rows_clear_full_16_scalar(uint16_t *rows, int count, int first, uint16_t full);
+int rows_clear_full_16_sse2(uint16_t *rows, int count, int first, uint16_t full);
+int rows_clear_full_16_avx2(uint16_t *rows, int count, int first, uint16_t full);
+int rows_clear_full_32_scalar(uint32_t *rows, int count, int first, uint32_t full);
+int rows_clear_full_32_sse2(uint32_t *rows, int count, int first, uint32_t full);
+int rows_clear_full_32_avx2(uint32_t *rows, int count, int first, uint32_t full);
+int rows_clear_full_64_scalar(uint64_t *rows, int count, int first, uint64_t full);
+int rows_clear_full_64_sse2(uint64_t *rows, int count, int first, uint64_t full);
+int rows_clear_full_64_avx2(uint64_t *rows, int count, int first, uint64_t full);
+
+#endif  // TETRIS_ROWSCAN_H
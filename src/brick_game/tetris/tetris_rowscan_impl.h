@@ -0,0 +1,51 @@
+// Full-row clear template, included by tetris_rowscan.c once per row width
+// and instruction set. Expects ROW_BITS, ROW_T and ISA to be defined; vector
+// variants also define VEC_T, VEC_ROWS, VEC_LOAD, VEC_STORE, VEC_SPLAT,
+// VEC_ANY_EQ and ISA_ATTR. There is deliberately no include guard.
+
+ISA_ATTR int ROWSCAN_FN(ROW_BITS, ISA)(ROW_T *rows, int count, int first, ROW_T full) {
+    int shift = 0;
+    int src = count - 1;
+
+#ifdef VEC_T
+    const VEC_T fullv = VEC_SPLAT(full);
+
+    while (src - VEC_ROWS + 1 >= first) {
+        ROW_T *chunk = rows + src - VEC_ROWS + 1;
+        VEC_T v = VEC_LOAD(chunk);
+
+        // Common case: no full row in the chunk, move it as a whole
+        if (!VEC_ANY_EQ(v, fullv)) {
+            if (shift) VEC_STORE(chunk + shift, v);
+            src -= VEC_ROWS;
+            continue;
+        }
+
+        for (int end = src - VEC_ROWS; src > end; src--) {
+            if (rows[src] == full) {
+                shift++;
+            } else if (shift) {
+                rows[src + shift] = rows[src];
+            }
+        }
+    }
+#endif
+
+    for (; src >= first; src--) {
+        if (rows[src] == full) {
+            shift++;
+        } else if (shift) {
+            rows[src + shift] = rows[src];
+        }
+    }
+
+    if (shift) {
+        // Rows above first are moved but never counted
+        for (; src >= 0; src--) {
+            rows[src + shift] = rows[src];
+        }
+        memset(rows, 0, (size_t)shift * sizeof(ROW_T));
+    }
+
+    return shift;
+}
@@ -0,0 +1,225 @@
+#define _POSIX_C_SOURCE 200809L
+#include "tetris_spectator.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SPECTATOR_MAGIC 0x46505354u  // "TSPF"
+#define SPECTATOR_READ_RETRIES 4
+
+// Shared segment layout: header, then SPECTATOR_SLOTS fixed-size slots
+typedef struct {
+    uint32_t magic;
+    uint32_t slot_count;
+    uint32_t width;
+    uint32_t height;
+    uint64_t slot_bytes;
+    _Atomic uint64_t head;  // number of frames published
+} SpectatorHeader_t;
+
+// seq is 2 * index + 1 while frame index is being written, 2 * index + 2 once done
+typedef struct {
+    _Atomic uint64_t seq;
+    SpectatorFrame_t frame;
+    uint64_t rows[];
+} SpectatorSlot_t;
+
+static size_t slot_bytes_for(int height) {
+    size_t bytes = sizeof(SpectatorSlot_t) + (size_t)height * sizeof(uint64_t);
+    return (bytes + 63) & ~(size_t)63;
+}
+
+static SpectatorHeader_t *feed_header(const SpectatorFeed_t *feed) {
+    return feed->base;
+}
+
+static SpectatorSlot_t *feed_slot(const SpectatorFeed_t *feed, uint64_t index) {
+    size_t offset = 64 + (size_t)(index % feed->slot_count) * feed->slot_bytes;
+    return (SpectatorSlot_t *)((char *)feed->base + offset);
+}
+
+static bool copy_name(SpectatorFeed_t *feed, const char *name) {
+    // shm_open() wants a single leading slash
+    int written = snprintf(feed->name, sizeof(feed->name), "/%s", name[0] == '/' ? name + 1 : name);
+    return written > 1 && written < (int)sizeof(feed->name);
+}
+
+bool spectator_open_writer(SpectatorFeed_t *feed, const char *name, int width, int height) {
+    if (!feed || !name || width <= 0 || height <= 0) return false;
+
+    memset(feed, 0, sizeof(SpectatorFeed_t));
+    if (!copy_name(feed, name)) return false;
+
+    size_t size = 64 + SPECTATOR_SLOTS * slot_bytes_for(height);
+    int fd = shm_open(feed->name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        shm_unlink(feed->name);
+        return false;
+    }
+
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(feed->name);
+        return false;
+    }
+
+    feed->base = base;
+    feed->size = size;
+    feed->writer = true;
+    feed->width = width;
+    feed->height = height;
+    feed->slot_count = SPECTATOR_SLOTS;
+    feed->slot_bytes = slot_bytes_for(height);
+
+    SpectatorHeader_t *header = base;
+    header->slot_count = SPECTATOR_SLOTS;
+    header->width = (uint32_t)width;
+    header->height = (uint32_t)height;
+    header->slot_bytes = slot_bytes_for(height);
+    atomic_store_explicit(&header->head, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    header->magic = SPECTATOR_MAGIC;
+
+    return true;
+}
+
+void spectator_publish(SpectatorFeed_t *feed, const FrameView_t *view) {
+    if (!feed || !feed->writer || !view) return;
+    if (view->width != feed->width || view->height != feed->height) return;
+
+    uint64_t index = feed->next_index++;
+    SpectatorSlot_t *slot = feed_slot(feed, index);
+
+    atomic_store_explicit(&slot->seq, 2 * index + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot->frame.generation = view->generation;
+    slot->frame.width = (uint32_t)view->width;
+    slot->frame.height = (uint32_t)view->height;
+    slot->frame.score = view->score;
+    slot->frame.high_score = view->high_score;
+    slot->frame.level = view->level;
+    slot->frame.speed = view->speed;
+    slot->frame.next = view->next;
+    slot->frame.pause = (uint8_t)view->pause;
+    memcpy(slot->rows, view->rows, (size_t)view->height * sizeof(uint64_t));
+
+    atomic_store_explicit(&slot->seq, 2 * index + 2, memory_order_release);
+    atomic_store_explicit(&feed_header(feed)->head, index + 1, memory_order_release);
+}
+
+static bool header_valid(const SpectatorHeader_t *header, size_t size) {
+    if (header->magic != SPECTATOR_MAGIC || header->slot_count == 0) return false;
+    if (header->width < BOARD_MIN_WIDTH || header->width > BOARD_MAX_WIDTH ||
+        header->height < BOARD_MIN_HEIGHT || header->height > BOARD_MAX_HEIGHT) {
+        return false;
+    }
+    if (header->slot_bytes < slot_bytes_for((int)header->height)) return false;
+
+    // Divide rather than multiply so a huge count cannot wrap past the check
+    return header->slot_count <= (size - 64) / header->slot_bytes;
+}
+
+bool spectator_open_reader(SpectatorFeed_t *feed, const char *name) {
+    if (!feed || !name) return false;
+
+    memset(feed, 0, sizeof(SpectatorFeed_t));
+    if (!copy_name(feed, name)) return false;
+
+    int fd = shm_open(feed->name, O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < 64) {
+        close(fd);
+        return false;
+    }
+
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+    // The header is written by another process: take one copy and check
+    // it before any of it is used to index the mapping
+    const SpectatorHeader_t *shared = base;
+    atomic_thread_fence(memory_order_acquire);
+    SpectatorHeader_t header;
+    header.magic = shared->magic;
+    header.slot_count = shared->slot_count;
+    header.width = shared->width;
+    header.height = shared->height;
+    header.slot_bytes = shared->slot_bytes;
+    if (!header_valid(&header, (size_t)st.st_size)) {
+        munmap(base, (size_t)st.st_size);
+        return false;
+    }
+
+    feed->base = base;
+    feed->size = (size_t)st.st_size;
+    feed->width = (int)header.width;
+    feed->height = (int)header.height;
+    feed->slot_count = header.slot_count;
+    feed->slot_bytes = (size_t)header.slot_bytes;
+
+    return true;
+}
+
+uint64_t spectator_frames_published(const SpectatorFeed_t *feed) {
+    if (!feed || !feed->base) return 0;
+
+    return atomic_load_explicit(&feed_header(feed)->head, memory_order_acquire);
+}
+
+bool spectator_read(const SpectatorFeed_t *feed, uint64_t index,
+                    SpectatorFrame_t *frame, uint64_t *rows) {
+    if (!feed || !feed->base || !frame || !rows) return false;
+
+    SpectatorSlot_t *slot = feed_slot(feed, index);
+    uint64_t expected = 2 * index + 2;
+
+    // Not written yet, being written, or already overwritten
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != expected) {
+        return false;
+    }
+
+    memcpy(frame, &slot->frame, sizeof(SpectatorFrame_t));
+    memcpy(rows, slot->rows, (size_t)feed->height * sizeof(uint64_t));
+
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != expected) return false;
+
+    // Readers size their buffers from the feed, so a frame claiming another
+    // geometry is not one they can draw
+    return frame->width == (uint32_t)feed->width && frame->height == (uint32_t)feed->height;
+}
+
+bool spectator_read_latest(const SpectatorFeed_t *feed, SpectatorFrame_t *frame, uint64_t *rows) {
+    for (int attempt = 0; attempt < SPECTATOR_READ_RETRIES; attempt++) {
+        uint64_t head = spectator_frames_published(feed);
+        if (head == 0) return false;
+
+        if (spectator_read(feed, head - 1, frame, rows)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void spectator_close(SpectatorFeed_t *feed) {
+    if (!feed || !feed->base) return;
+
+    munmap(feed->base, feed->size);
+    if (feed->writer) {
+        shm_unlink(feed->name);
+    }
+    memset(feed, 0, sizeof(SpectatorFeed_t));
+}
@@ -0,0 +1,53 @@
+#ifndef TETRIS_SPECTATOR_H
+#define TETRIS_SPECTATOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tetris_frame.h"
+
+// Frames kept in the shared ring; readers may lag this far behind
+#define SPECTATOR_SLOTS 16
+#define SPECTATOR_NAME_MAX 64
+
+// Fixed part of a published frame, followed by height packed rows
+typedef struct {
+    uint64_t generation;
+    uint32_t width;
+    uint32_t height;
+    int32_t score;
+    int32_t high_score;
+    int32_t level;
+    int32_t speed;
+    uint16_t next;
+    uint8_t pause;
+} SpectatorFrame_t;
+
+// One end of a POSIX shared-memory feed (writer or read-only reader)
+typedef struct {
+    void *base;
+    size_t size;
+    bool writer;
+    int width;
+    int height;
+    uint32_t slot_count;
+    size_t slot_bytes;
+    uint64_t next_index;
+    char name[SPECTATOR_NAME_MAX];
+} SpectatorFeed_t;
+
+// Writer side: never blocks and never allocates after open
+bool spectator_open_writer(SpectatorFeed_t *feed, const char *name, int width, int height);
+void spectator_publish(SpectatorFeed_t *feed, const FrameView_t *view);
+
+// Reader side: frames are copied out and validated with the slot seqlock
+bool spectator_open_reader(SpectatorFeed_t *feed, const char *name);
+uint64_t spectator_frames_published(const SpectatorFeed_t *feed);
+bool spectator_read(const SpectatorFeed_t *feed, uint64_t index,
+                    SpectatorFrame_t *frame, uint64_t *rows);
+bool spectator_read_latest(const SpectatorFeed_t *feed, SpectatorFrame_t *frame, uint64_t *rows);
+
+// Unmaps the segment; the writer also unlinks it
+void spectator_close(SpectatorFeed_t *feed);
+
+#endif  // TETRIS_SPECTATOR_H
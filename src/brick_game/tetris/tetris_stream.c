@@ -0,0 +1,177 @@
+#include "tetris_stream.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum { SCALAR_SCORE, SCALAR_HIGH_SCORE, SCALAR_LEVEL, SCALAR_SPEED, SCALAR_PAUSE, SCALAR_NEXT,
+       SCALAR_HOLD };
+
+static uint8_t *put_varint(uint8_t *p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static bool get_varint(const uint8_t **p, const uint8_t *end, uint64_t *v) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+        uint8_t byte = *(*p)++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *v = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Small deltas of either sign become small unsigned numbers
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+bool stream_init(FrameStream_t *stream, int width, int height, int keyframe_interval) {
+    if (!stream || width < 1 || width > 64 || height < 1 || keyframe_interval < 0) return false;
+
+    memset(stream, 0, sizeof(FrameStream_t));
+    stream->rows = calloc(height, sizeof(uint64_t));
+    if (!stream->rows) return false;
+
+    stream->width = width;
+    stream->height = height;
+    stream->keyframe_interval = keyframe_interval;
+    return true;
+}
+
+void stream_free(FrameStream_t *stream) {
+    if (!stream) return;
+
+    free(stream->rows);
+    memset(stream, 0, sizeof(FrameStream_t));
+}
+
+void stream_request_keyframe(FrameStream_t *stream) {
+    stream->synced = false;
+}
+
+static void reset_reference(FrameStream_t *stream) {
+    memset(stream->rows, 0, stream->height * sizeof(uint64_t));
+    memset(&stream->scalars, 0, sizeof(StreamScalars_t));
+}
+
+size_t stream_encode(FrameStream_t *stream, const FrameView_t *view, uint8_t *out) {
+    bool key = !stream->synced ||
+               (stream->keyframe_interval > 0 && stream->frames % stream->keyframe_interval == 0);
+    if (key) {
+        reset_reference(stream);
+    }
+
+    StreamScalars_t scalars = {{
+        [SCALAR_SCORE] = view->score,
+        [SCALAR_HIGH_SCORE] = view->high_score,
+        [SCALAR_LEVEL] = view->level,
+        [SCALAR_SPEED] = view->speed,
+        [SCALAR_PAUSE] = view->pause,
+        [SCALAR_NEXT] = view->preview_count ? view->preview[0] : -1,
+        [SCALAR_HOLD] = view->hold,
+    }};
+
+    uint8_t fields = key ? STREAM_KEYFRAME : 0;
+    uint8_t *p = out + 1;
+    for (int i = 0; i < STREAM_SCALARS; i++) {
+        int64_t delta = (int64_t)scalars.values[i] - stream->scalars.values[i];
+        if (delta || key) {
+            fields |= (uint8_t)(2 << i);
+            p = put_varint(p, zigzag(delta));
+        }
+    }
+    out[0] = fields;
+    stream->scalars = scalars;
+
+    // Runs of changed rows; the reference becomes this frame as we go
+    const uint64_t *rows = view->rows;
+    uint64_t *reference = stream->rows;
+    int height = stream->height;
+    int y = 0;
+    while (y < height) {
+        int start = y;
+        while (y < height && rows[y] == reference[y]) y++;
+        p = put_varint(p, (uint64_t)(y - start));
+        if (y == height) break;
+
+        start = y;
+        while (y < height && rows[y] != reference[y]) y++;
+        p = put_varint(p, (uint64_t)(y - start));
+        for (int r = start; r < y; r++) {
+            p = put_varint(p, rows[r] ^ reference[r]);
+            reference[r] = rows[r];
+        }
+    }
+
+    stream->frames++;
+    stream->synced = true;
+    return (size_t)(p - out);
+}
+
+static int decode_failed(FrameStream_t *stream) {
+    // The reference may be half-updated; only a keyframe can recover
+    stream->synced = false;
+    return -1;
+}
+
+int stream_decode(FrameStream_t *stream, const uint8_t *in, size_t size, StreamFrame_t *frame) {
+    const uint8_t *p = in;
+    const uint8_t *end = in + size;
+    if (p == end) return -1;
+
+    uint8_t fields = *p++;
+    bool key = fields & STREAM_KEYFRAME;
+    if (!key && !stream->synced) return -1;
+    if (key) {
+        reset_reference(stream);
+    }
+
+    uint64_t v;
+    for (int i = 0; i < STREAM_SCALARS; i++) {
+        if (!(fields & (2 << i))) continue;
+        if (!get_varint(&p, end, &v)) return decode_failed(stream);
+        stream->scalars.values[i] = (int32_t)(stream->scalars.values[i] + unzigzag(v));
+    }
+
+    uint64_t full_row = stream->width == 64 ? UINT64_MAX : (UINT64_C(1) << stream->width) - 1;
+    uint64_t height = (uint64_t)stream->height;
+    uint64_t y = 0;
+    while (y < height) {
+        if (!get_varint(&p, end, &v) || v > height - y) return decode_failed(stream);
+        y += v;
+        if (y == height) break;
+
+        if (!get_varint(&p, end, &v) || v == 0 || v > height - y) return decode_failed(stream);
+        for (uint64_t stop = y + v; y < stop; y++) {
+            uint64_t diff;
+            if (!get_varint(&p, end, &diff) || (diff & ~full_row)) return decode_failed(stream);
+            stream->rows[y] ^= diff;
+        }
+    }
+
+    stream->frames++;
+    stream->synced = true;
+
+    const int32_t *values = stream->scalars.values;
+    frame->keyframe = key;
+    frame->rows = stream->rows;
+    frame->score = values[SCALAR_SCORE];
+    frame->high_score = values[SCALAR_HIGH_SCORE];
+    frame->level = values[SCALAR_LEVEL];
+    frame->speed = values[SCALAR_SPEED];
+    frame->pause = values[SCALAR_PAUSE];
+    frame->next = values[SCALAR_NEXT];
+    frame->hold = values[SCALAR_HOLD];
+    return (int)(p - in);
+}
@@ -0,0 +1,74 @@
+#ifndef TETRIS_STREAM_H
+#define TETRIS_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tetris_frame.h"
+
+// Compact frame stream for sending frames to another process or a file.
+// Frames are self-delimiting, so a stream is their concatenation:
+//
+//   u8 fields    STREAM_KEYFRAME, then one bit per scalar that changed
+//   varint ...   zigzag delta of each changed scalar, in bit order
+//   runs         varint rows skipped, then, unless that reached the last
+//                row, varint row count and one varint per row; repeated
+//                until every row is covered
+//
+// Rows are XORed with the previous frame, so unchanged rows are skipped
+// and a moved piece costs a few bytes. A keyframe resets the reference to
+// an empty field and zero scalars first, which makes it decodable on its
+// own; the encoder emits one every keyframe_interval frames.
+
+#define STREAM_KEYFRAME 0x01
+#define STREAM_SCALARS 7
+#define STREAM_DEFAULT_KEYFRAME_INTERVAL 600
+
+// Worst case for one frame: every scalar present, every other row a run
+#define STREAM_MAX_FRAME_BYTES(height) (1 + STREAM_SCALARS * 5 + 3 + (height) * (3 + 3 + 10))
+
+// Score, high score, level, speed, pause, next piece and hold piece, in
+// field bit order; pieces are -1 when absent
+typedef struct {
+    int32_t values[STREAM_SCALARS];
+} StreamScalars_t;
+
+typedef struct {
+    int width;
+    int height;
+    int keyframe_interval;
+    uint64_t frames;
+    uint64_t *rows;  // reference field: the last frame encoded or decoded
+    StreamScalars_t scalars;
+    bool synced;  // the reference is valid; cleared to force a keyframe
+} FrameStream_t;
+
+// One decoded frame; rows belong to the stream and change on the next decode
+typedef struct {
+    bool keyframe;
+    const uint64_t *rows;
+    int score;
+    int high_score;
+    int level;
+    int speed;
+    int pause;
+    int next;
+    int hold;
+} StreamFrame_t;
+
+// keyframe_interval only matters when encoding; 0 means keyframe once
+bool stream_init(FrameStream_t *stream, int width, int height, int keyframe_interval);
+void stream_free(FrameStream_t *stream);
+
+// Makes the next encoded frame a keyframe, e.g. for a new receiver
+void stream_request_keyframe(FrameStream_t *stream);
+
+// Appends one frame to out, which needs STREAM_MAX_FRAME_BYTES(height)
+// bytes; returns the bytes written
+size_t stream_encode(FrameStream_t *stream, const FrameView_t *view, uint8_t *out);
+
+// Decodes the frame at the start of in; returns the bytes consumed, or -1
+// when the data is malformed or a delta arrives before any keyframe
+int stream_decode(FrameStream_t *stream, const uint8_t *in, size_t size, StreamFrame_t *frame);
+
+#endif  // TETRIS_STREAM_H
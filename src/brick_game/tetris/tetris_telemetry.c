@@ -0,0 +1,160 @@
+#define _POSIX_C_SOURCE 200809L
+#include "tetris_telemetry.h"
+#include "tetris_board.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Single-producer ring: the game thread advances head, the flush thread
+// advances tail. Both only grow; slots are index % TELEMETRY_RING.
+struct TelemetryWriter_s {
+    TelemetryRecord_t ring[TELEMETRY_RING];
+    _Atomic uint64_t head;
+    _Atomic uint64_t tail;
+    _Atomic uint64_t dropped;
+    atomic_bool stop;
+    atomic_bool failed;
+    FILE *file;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+};
+
+static bool write_span(TelemetryWriter_t *writer, uint64_t from, uint64_t to) {
+    while (from < to) {
+        size_t slot = (size_t)(from % TELEMETRY_RING);
+        size_t count = (size_t)(to - from);
+        if (count > TELEMETRY_RING - slot) count = TELEMETRY_RING - slot;
+        if (fwrite(&writer->ring[slot], sizeof(TelemetryRecord_t), count, writer->file) != count) {
+            return false;
+        }
+        from += count;
+    }
+    return true;
+}
+
+static void *flush_thread(void *arg) {
+    TelemetryWriter_t *writer = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&writer->lock);
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += TELEMETRY_FLUSH_MS * 1000000L;
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        while (!atomic_load(&writer->stop) &&
+               atomic_load(&writer->head) - atomic_load(&writer->tail) < TELEMETRY_FLUSH_BATCH) {
+            if (pthread_cond_timedwait(&writer->wake, &writer->lock, &until) != 0) break;
+        }
+        bool stopping = atomic_load(&writer->stop);
+        pthread_mutex_unlock(&writer->lock);
+
+        uint64_t tail = atomic_load_explicit(&writer->tail, memory_order_relaxed);
+        uint64_t head = atomic_load_explicit(&writer->head, memory_order_acquire);
+        if (head != tail) {
+            if (!write_span(writer, tail, head) || fflush(writer->file) != 0) {
+                atomic_store(&writer->failed, true);
+            }
+            atomic_store_explicit(&writer->tail, head, memory_order_release);
+        }
+        // The game has stopped appending by the time stop is set
+        if (stopping) break;
+    }
+    return NULL;
+}
+
+TelemetryWriter_t *telemetry_open(const char *path) {
+    if (!path) return NULL;
+
+    TelemetryWriter_t *writer = calloc(1, sizeof(TelemetryWriter_t));
+    if (!writer) return NULL;
+
+    writer->file = fopen(path, "wb");
+    TelemetryHeader_t header = {TELEMETRY_MAGIC, sizeof(TelemetryRecord_t)};
+    if (!writer->file || fwrite(&header, sizeof(header), 1, writer->file) != 1) {
+        if (writer->file) fclose(writer->file);
+        free(writer);
+        return NULL;
+    }
+
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->wake, NULL);
+    if (pthread_create(&writer->thread, NULL, flush_thread, writer) != 0) {
+        pthread_cond_destroy(&writer->wake);
+        pthread_mutex_destroy(&writer->lock);
+        fclose(writer->file);
+        free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+bool telemetry_close(TelemetryWriter_t *writer) {
+    if (!writer) return true;
+
+    pthread_mutex_lock(&writer->lock);
+    atomic_store(&writer->stop, true);
+    pthread_cond_signal(&writer->wake);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+
+    bool ok = !atomic_load(&writer->failed);
+    if (fclose(writer->file) != 0) ok = false;
+    pthread_cond_destroy(&writer->wake);
+    pthread_mutex_destroy(&writer->lock);
+    free(writer);
+    return ok;
+}
+
+bool telemetry_append(TelemetryWriter_t *writer, const TelemetryRecord_t *record) {
+    uint64_t head = atomic_load_explicit(&writer->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&writer->tail, memory_order_acquire);
+    if (head - tail >= TELEMETRY_RING) {
+        atomic_fetch_add_explicit(&writer->dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    writer->ring[head % TELEMETRY_RING] = *record;
+    atomic_store_explicit(&writer->head, head + 1, memory_order_release);
+
+    // Once per batch; the timed wait covers a wakeup lost to the race
+    if (head + 1 - tail == TELEMETRY_FLUSH_BATCH) {
+        pthread_cond_signal(&writer->wake);
+    }
+    return true;
+}
+
+uint64_t telemetry_dropped(const TelemetryWriter_t *writer) {
+    return writer ? atomic_load(&writer->dropped) : 0;
+}
+
+void telemetry_record_lock(const TetrisGame_t *game, int lines, int score_delta) {
+    if (!game || !game->telemetry) return;
+
+    const Piece_t *piece = &game->current_piece;
+    TelemetryRecord_t record = {
+        .lock_frame = game->frame,
+        .piece = (uint8_t)piece->type,
+        .x = (int8_t)piece->x,
+        .rotation = (uint8_t)piece->rotation,
+        .lines = (uint8_t)lines,
+        .score_delta = score_delta,
+        .level = (uint16_t)game->level,
+        .height = (uint16_t)board_stack_height(&game->board),
+    };
+    telemetry_append(game->telemetry, &record);
+}
+
+bool telemetry_read_header(FILE *file) {
+    TelemetryHeader_t header;
+    return fread(&header, sizeof(header), 1, file) == 1 && header.magic == TELEMETRY_MAGIC &&
+           header.record_size == sizeof(TelemetryRecord_t);
+}
+
+bool telemetry_read(FILE *file, TelemetryRecord_t *record) {
+    return fread(record, sizeof(*record), 1, file) == 1;
+}
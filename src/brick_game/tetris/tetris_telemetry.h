@@ -0,0 +1,57 @@
+#ifndef TETRIS_TELEMETRY_H
+#define TETRIS_TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "tetris_types.h"
+
+// Records waiting for the flush thread; a power of two. A game that gets
+// this far ahead of the disk drops records rather than waiting.
+#define TELEMETRY_RING 4096
+// The flush thread wakes this often, or once this many records are waiting
+#define TELEMETRY_FLUSH_MS 200
+#define TELEMETRY_FLUSH_BATCH 256
+
+#define TELEMETRY_MAGIC 0x4c455454u  // "TTEL"
+
+// One locked piece. Files hold a TelemetryHeader_t and then these records,
+// both in host byte order.
+typedef struct {
+    uint32_t lock_frame;   // gravity frames since Start when the piece locked
+    uint8_t piece;         // PieceType_t
+    int8_t x;              // piece column, as Piece_t.x
+    uint8_t rotation;
+    uint8_t lines;         // lines the lock cleared
+    int32_t score_delta;
+    uint16_t level;        // after the lock, so level-ups show on their piece
+    uint16_t height;       // stack height after clearing, in rows
+} TelemetryRecord_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t record_size;
+} TelemetryHeader_t;
+
+typedef struct TelemetryWriter_s TelemetryWriter_t;
+
+// Creates path, writes the header and starts the flush thread; NULL on failure
+TelemetryWriter_t *telemetry_open(const char *path);
+// Writes out everything recorded, stops the thread and closes the file;
+// false if any write failed
+bool telemetry_close(TelemetryWriter_t *writer);
+
+// Copies one record into the ring. Never blocks or allocates; once every
+// TELEMETRY_FLUSH_BATCH records it signals the flush thread, which may
+// cost a futex wake. False when the ring is full and the record was dropped.
+bool telemetry_append(TelemetryWriter_t *writer, const TelemetryRecord_t *record);
+uint64_t telemetry_dropped(const TelemetryWriter_t *writer);
+
+// Records the piece that just locked in game, when game->telemetry is set
+void telemetry_record_lock(const TetrisGame_t *game, int lines, int score_delta);
+
+// Reader side for tools: checks the header, then reads records one by one
+bool telemetry_read_header(FILE *file);
+bool telemetry_read(FILE *file, TelemetryRecord_t *record);
+
+#endif  // TETRIS_TELEMETRY_H
@@ -0,0 +1,56 @@
+// The piece shapes; every other piece table is generated from these by
+// tools/gen_piece_tables.c at build time
+#include "tetris_pieces.h"
+
+// Tetris piece templates [piece_type][rotation][y][x]
+const int piece_templates[PIECE_COUNT][4][PIECE_SIZE][PIECE_SIZE] = {
+    // I piece
+    {
+        {{0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0}},
+        {{0,0,1,0}, {0,0,1,0}, {0,0,1,0}, {0,0,1,0}},
+        {{0,0,0,0}, {0,0,0,0}, {1,1,1,1}, {0,0,0,0}},
+        {{0,1,0,0}, {0,1,0,0}, {0,1,0,0}, {0,1,0,0}}
+    },
+    // O piece
+    {
+        {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
+        {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
+        {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
+        {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}}
+    },
+    // T piece
+    {
+        {{0,0,0,0}, {0,1,0,0}, {1,1,1,0}, {0,0,0,0}},
+        {{0,0,0,0}, {0,1,0,0}, {0,1,1,0}, {0,1,0,0}},
+        {{0,0,0,0}, {0,0,0,0}, {1,1,1,0}, {0,1,0,0}},
+        {{0,0,0,0}, {0,1,0,0}, {1,1,0,0}, {0,1,0,0}}
+    },
+    // S piece
+    {
+        {{0,0,0,0}, {0,1,1,0}, {1,1,0,0}, {0,0,0,0}},
+        {{0,0,0,0}, {0,1,0,0}, {0,1,1,0}, {0,0,1,0}},
+        {{0,0,0,0}, {0,0,0,0}, {0,1,1,0}, {1,1,0,0}},
+        {{0,0,0,0}, {1,0,0,0}, {1,1,0,0}, {0,1,0,0}}
+    },
+    // Z piece
+    {
+        {{0,0,0,0}, {1,1,0,0}, {0,1,1,0}, {0,0,0,0}},
+        {{0,0,0,0}, {0,0,1,0}, {0,1,1,0}, {0,1,0,0}},
+        {{0,0,0,0}, {0,0,0,0}, {1,1,0,0}, {0,1,1,0}},
+        {{0,0,0,0}, {0,1,0,0}, {1,1,0,0}, {1,0,0,0}}
+    },
+    // J piece
+    {
+        {{0,0,0,0}, {1,0,0,0}, {1,1,1,0}, {0,0,0,0}},
+        {{0,0,0,0}, {0,1,1,0}, {0,1,0,0}, {0,1,0,0}},
+        {{0,0,0,0}, {0,0,0,0}, {1,1,1,0}, {0,0,1,0}},
+        {{0,0,0,0}, {0,1,0,0}, {0,1,0,0}, {1,1,0,0}}
+    },
+    // L piece
+    {
+        {{0,0,0,0}, {0,0,1,0}, {1,1,1,0}, {0,0,0,0}},
+        {{0,0,0,0}, {0,1,0,0}, {0,1,0,0}, {0,1,1,0}},
+        {{0,0,0,0}, {0,0,0,0}, {1,1,1,0}, {1,0,0,0}},
+        {{0,0,0,0}, {1,1,0,0}, {0,1,0,0}, {0,1,0,0}}
+    }
+};
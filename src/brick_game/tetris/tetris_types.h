@@ -2,8 +2,9 @@
 #define TETRIS_TYPES_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
-// Game constants
+// Game constants (classic geometry, also the default board size)
 #define BOARD_WIDTH 10
 #define BOARD_HEIGHT 20
 #define BOARD_EXTRA_HEIGHT 4
@@ -11,6 +12,22 @@
 #define PIECE_SIZE 4
 #define PIECE_COUNT 7
 
+// Preview queue length limits and its ring size (a power of two)
+#define PREVIEW_MIN 1
+#define PREVIEW_MAX 6
+#define PIECE_QUEUE_CAPACITY 16
+
+// Cell colours are the PieceType_t that filled a cell, or CELL_GARBAGE for
+// filled cells without one (garbage rows, direct edits); 3 bits each
+#define CELL_GARBAGE 7
+#define COLOR_PLANES 3
+
+// Limits for runtime board geometry
+#define BOARD_MIN_WIDTH PIECE_SIZE
+#define BOARD_MAX_WIDTH 64
+#define BOARD_MIN_HEIGHT PIECE_SIZE
+#define BOARD_MAX_HEIGHT 16384
+
 // User actions enum as specified in requirements
 typedef enum {
     Start,
@@ -58,12 +75,40 @@ typedef struct {
     int shape[PIECE_SIZE][PIECE_SIZE];
 } Piece_t;
 
+struct BoardKernels_s;
+struct TelemetryWriter_s;
+
+// Bit-packed board: one word per row, bit x set when column x is occupied.
+// Rows are 16, 32 or 64 bits wide depending on the board width, and
+// rows[0] is the top of the spawn area.
+typedef struct {
+    int width;
+    int height;
+    int total_height;
+    uint64_t full_row;
+    void *rows;
+    uint64_t *colors;  // COLOR_PLANES words per row, NULL unless enabled
+    const struct BoardKernels_s *kernels;
+} Board_t;
+
+// Upcoming piece types, refilled in batches up to capacity. Each entry is
+// also stored PIECE_QUEUE_CAPACITY slots later so the pieces from head on
+// are always contiguous.
+typedef struct {
+    uint8_t types[2 * PIECE_QUEUE_CAPACITY];
+    int head;
+    int count;
+    int preview;  // entries shown to players and bots
+} PieceQueue_t;
+
 // Main game structure
 typedef struct {
     GameState_t state;
-    int board[TOTAL_HEIGHT][BOARD_WIDTH];
+    Board_t board;
     Piece_t current_piece;
-    Piece_t next_piece;
+    PieceQueue_t queue;
+    int hold_piece;  // PieceType_t, -1 when the slot is empty
+    bool hold_used;  // one hold per spawned piece
     int score;
     int high_score;
     int level;
@@ -73,6 +118,12 @@ typedef struct {
     bool game_over;
     int timer;
     int drop_timer;
+    int pieces_spawned;
+    uint64_t rng_state;
+    uint64_t board_hash;  // kept in step with the board, see tetris_hash.h
+    uint64_t version;     // bumped when anything a frontend draws changes; never 0
+    uint32_t frame;       // gravity frames since Start
+    struct TelemetryWriter_s *telemetry;  // gets a record per lock when set
 } TetrisGame_t;
 
 #endif  // TETRIS_TYPES_H
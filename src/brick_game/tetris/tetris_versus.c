@@ -0,0 +1,222 @@
+#include "tetris_versus.h"
+#include "tetris_board.h"
+#include "tetris_fsm.h"
+#include "tetris_hash.h"
+#include "tetris_pieces.h"
+#include <string.h>
+
+#define VERSUS_GARBAGE_SALT UINT64_C(0x6a09e667f3bcc909)
+
+// Garbage rows sent for 0-4 lines cleared at once
+static const int attack_lines[] = {0, 0, 1, 2, 4};
+
+bool versus_init(VersusMatch_t *match, int players, int width, int height, uint64_t seed) {
+    if (!match || players < VERSUS_MIN_PLAYERS || players > VERSUS_MAX_PLAYERS) return false;
+
+    memset(match, 0, sizeof(VersusMatch_t));
+    for (int p = 0; p < players; p++) {
+        if (!game_init(&match->players[p].game, width, height)) {
+            versus_free(match);
+            return false;
+        }
+        match->player_count++;
+    }
+
+    versus_restart(match, seed);
+    return true;
+}
+
+void versus_free(VersusMatch_t *match) {
+    if (!match) return;
+
+    for (int p = 0; p < match->player_count; p++) {
+        game_destroy(&match->players[p].game);
+    }
+    match->player_count = 0;
+}
+
+void versus_restart(VersusMatch_t *match, uint64_t seed) {
+    for (int p = 0; p < match->player_count; p++) {
+        VersusPlayer_t *player = &match->players[p];
+        player->pending_count = 0;
+        player->lines_sent = 0;
+        player->lines_received = 0;
+        player->alive = true;
+
+        seed_piece_generator(&player->game, seed);
+        player->game.state = STATE_START;
+        fsm_process_action(&player->game, Start, false);
+    }
+
+    match->tick = 0;
+    match->garbage_rng = seed ^ VERSUS_GARBAGE_SALT;
+    match->event_count = 0;
+    match->over = false;
+    match->winner = -1;
+}
+
+int versus_pending_lines(const VersusPlayer_t *player) {
+    int lines = 0;
+    for (int i = 0; i < player->pending_count; i++) {
+        lines += player->pending[i].lines;
+    }
+    return lines;
+}
+
+// Cleared lines cancel the oldest pending garbage first
+static int cancel_pending(VersusPlayer_t *player, int attack) {
+    int used = 0;
+    while (attack > 0 && used < player->pending_count) {
+        GarbageBatch_t *batch = &player->pending[used];
+        int cancelled = attack < batch->lines ? attack : batch->lines;
+        batch->lines -= cancelled;
+        attack -= cancelled;
+        if (batch->lines == 0) used++;
+    }
+
+    player->pending_count -= used;
+    memmove(player->pending, player->pending + used,
+            (size_t)player->pending_count * sizeof(GarbageBatch_t));
+    return attack;
+}
+
+static void top_out(TetrisGame_t *game) {
+    game->state = STATE_GAME_OVER;
+    game->game_over = true;
+}
+
+// Pending garbage rises in between a lock and the next spawn
+static void apply_garbage(VersusPlayer_t *player) {
+    TetrisGame_t *game = &player->game;
+    Board_t *board = &game->board;
+    bool overflow = false;
+
+    for (int i = 0; i < player->pending_count; i++) {
+        const GarbageBatch_t *batch = &player->pending[i];
+        uint64_t garbage = board->full_row & ~(UINT64_C(1) << batch->hole);
+
+        game->board_hash = board_hash_garbage(game->board_hash, batch->lines, garbage);
+        overflow |= !board_push_garbage(board, batch->lines, garbage);
+        player->lines_received += batch->lines;
+    }
+    if (player->pending_count > 0) game->version++;
+    player->pending_count = 0;
+
+    if (overflow) {
+        game->board_hash = board_hash(board);
+        top_out(game);
+    } else if (is_game_over(game)) {
+        top_out(game);
+    }
+}
+
+static void step_player(VersusMatch_t *match, int index, const VersusInput_t *input) {
+    VersusPlayer_t *player = &match->players[index];
+    TetrisGame_t *game = &player->game;
+    GameState_t before = game->state;
+    int lines_before = game->lines_cleared;
+
+    // Every key but the last goes in while the piece still takes input; the
+    // last one rides the tick, so a single key steps exactly like fsm_tick
+    int last = input->count - 1;
+    for (int i = 0; i < last && fsm_takes_input(game); i++) {
+        fsm_process_action(game, input->keys[i].action, input->keys[i].hold);
+    }
+    if (last >= 0) {
+        fsm_tick(game, input->keys[last].action, input->keys[last].hold);
+    } else {
+        fsm_tick(game, FSM_IDLE, false);
+    }
+
+    int lines = game->lines_cleared - lines_before;
+    if (lines > 0) {
+        int attack = cancel_pending(player, attack_lines[lines < 4 ? lines : 4]);
+        if (attack > 0) {
+            AttackEvent_t *event = &match->events[match->event_count++];
+            event->tick = match->tick;
+            event->sender = index;
+            event->target = -1;
+            event->lines = attack;
+            event->hole = 0;
+            player->lines_sent += attack;
+        }
+    }
+
+    if (before == STATE_ATTACHING && game->state == STATE_SPAWN && player->pending_count > 0) {
+        apply_garbage(player);
+    }
+    player->alive = !game->game_over;
+}
+
+static int next_alive(const VersusMatch_t *match, int sender) {
+    for (int i = 1; i < match->player_count; i++) {
+        int p = (sender + i) % match->player_count;
+        if (match->players[p].alive) return p;
+    }
+    return -1;
+}
+
+static void deliver(VersusMatch_t *match, AttackEvent_t *event) {
+    event->target = next_alive(match, event->sender);
+    if (event->target < 0) return;
+
+    // xorshift64, advanced once per attack in delivery order
+    uint64_t x = match->garbage_rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    match->garbage_rng = x;
+
+    VersusPlayer_t *target = &match->players[event->target];
+    event->hole = (int)(x % (uint64_t)target->game.board.width);
+
+    if (target->pending_count == VERSUS_MAX_PENDING) {
+        target->pending[VERSUS_MAX_PENDING - 1].lines += event->lines;
+    } else {
+        target->pending[target->pending_count].lines = event->lines;
+        target->pending[target->pending_count].hole = event->hole;
+        target->pending_count++;
+    }
+}
+
+bool versus_input_push(VersusInput_t *input, UserAction_t action, bool hold) {
+    if (input->count == VERSUS_MAX_KEYS) return false;
+
+    input->keys[input->count].action = action;
+    input->keys[input->count].hold = hold;
+    input->count++;
+    return true;
+}
+
+bool versus_tick(VersusMatch_t *match, const VersusInput_t *inputs) {
+    if (!match || match->over) return false;
+
+    match->event_count = 0;
+    for (int p = 0; p < match->player_count; p++) {
+        if (match->players[p].alive) {
+            step_player(match, p, &inputs[p]);
+        }
+    }
+
+    // Attacks land only after every player has stepped, so player order
+    // within a tick does not decide who receives what
+    for (int i = 0; i < match->event_count; i++) {
+        deliver(match, &match->events[i]);
+    }
+
+    int alive = 0;
+    int last = -1;
+    for (int p = 0; p < match->player_count; p++) {
+        if (match->players[p].alive) {
+            alive++;
+            last = p;
+        }
+    }
+    if (alive <= 1) {
+        match->over = true;
+        match->winner = last;
+    }
+
+    match->tick++;
+    return !match->over;
+}
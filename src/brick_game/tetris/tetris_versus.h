@@ -0,0 +1,80 @@
+#ifndef TETRIS_VERSUS_H
+#define TETRIS_VERSUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_fsm.h"
+#include "tetris_types.h"
+
+#define VERSUS_MIN_PLAYERS 2
+#define VERSUS_MAX_PLAYERS 8
+#define VERSUS_MAX_PENDING 16  // garbage batches queued per player
+#define VERSUS_MAX_KEYS 8      // keys one player can press between two ticks
+
+typedef struct {
+    UserAction_t action;
+    bool hold;
+} VersusKey_t;
+
+// Keys one player pressed since the last tick, oldest first. No keys is an
+// idle tick: spawn, shift and attach still advance.
+typedef struct {
+    VersusKey_t keys[VERSUS_MAX_KEYS];
+    int count;
+} VersusInput_t;
+
+// Lines one lock sent after cancelling the sender's own pending garbage
+typedef struct {
+    uint64_t tick;
+    int sender;
+    int target;  // -1 when nobody was left to receive it
+    int lines;
+    int hole;    // column left open in every garbage row
+} AttackEvent_t;
+
+typedef struct {
+    int lines;
+    int hole;
+} GarbageBatch_t;
+
+typedef struct {
+    TetrisGame_t game;
+    GarbageBatch_t pending[VERSUS_MAX_PENDING];  // oldest first, added on the next lock
+    int pending_count;
+    int lines_sent;
+    int lines_received;
+    bool alive;
+} VersusPlayer_t;
+
+// Games advanced in lockstep by versus_tick(). Players step in index order
+// and the tick's attacks are delivered afterwards in sender order, so a
+// match depends only on its seed and its inputs.
+typedef struct {
+    VersusPlayer_t players[VERSUS_MAX_PLAYERS];
+    int player_count;
+    uint64_t tick;
+    uint64_t garbage_rng;
+    AttackEvent_t events[VERSUS_MAX_PLAYERS];  // attacks of the last tick
+    int event_count;
+    bool over;
+    int winner;  // -1 while running and on a draw
+} VersusMatch_t;
+
+bool versus_init(VersusMatch_t *match, int players, int width, int height, uint64_t seed);
+void versus_free(VersusMatch_t *match);
+
+// Starts a new match on the same boards; every player gets the same pieces
+void versus_restart(VersusMatch_t *match, uint64_t seed);
+
+// Appends a key; false when the queue is full and the key was dropped
+bool versus_input_push(VersusInput_t *input, UserAction_t action, bool hold);
+
+// Advances every player by their keys, in order, and one gravity frame;
+// inputs holds one entry per player. Keys pressed after a piece has
+// dropped within the same tick are discarded, as the piece no longer
+// takes input. Returns false once the match is over.
+bool versus_tick(VersusMatch_t *match, const VersusInput_t *inputs);
+
+int versus_pending_lines(const VersusPlayer_t *player);
+
+#endif  // TETRIS_VERSUS_H
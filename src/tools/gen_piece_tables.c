@@ -0,0 +1,165 @@
+// gen_piece_tables: writes tetris_piece_tables.h, the lookup tables the
+// engine uses instead of scanning piece_templates at run time
+#include <stdint.h>
+#include <stdio.h>
+#include "tetris_pieces.h"
+
+#define PIECE_CELLS 4
+
+static const char piece_names[PIECE_COUNT] = {'I', 'O', 'T', 'S', 'Z', 'J', 'L'};
+
+typedef struct {
+    int cell_count;
+    int cells[PIECE_CELLS][2];
+    unsigned rows[PIECE_SIZE];
+    unsigned shape;
+    int left, right, top, bottom;
+    int column_tops[PIECE_SIZE];
+    int column_bottoms[PIECE_SIZE];
+    int canonical;
+} Shape_t;
+
+static Shape_t shapes[PIECE_COUNT][4];
+
+static void analyse(int type, int rotation) {
+    Shape_t *s = &shapes[type][rotation];
+    s->left = s->top = PIECE_SIZE;
+    s->right = s->bottom = -1;
+
+    for (int x = 0; x < PIECE_SIZE; x++) {
+        s->column_tops[x] = s->column_bottoms[x] = -1;
+    }
+
+    for (int y = 0; y < PIECE_SIZE; y++) {
+        for (int x = 0; x < PIECE_SIZE; x++) {
+            if (!piece_templates[type][rotation][y][x]) continue;
+
+            if (s->cell_count < PIECE_CELLS) {
+                s->cells[s->cell_count][0] = x;
+                s->cells[s->cell_count][1] = y;
+            }
+            s->cell_count++;
+            s->rows[y] |= 1u << x;
+
+            if (x < s->left) s->left = x;
+            if (x > s->right) s->right = x;
+            if (y < s->top) s->top = y;
+            if (y > s->bottom) s->bottom = y;
+            if (s->column_tops[x] < 0) s->column_tops[x] = y;
+            s->column_bottoms[x] = y;
+        }
+        s->shape |= s->rows[y] << (y * PIECE_SIZE);
+    }
+
+    // Same cells up to translation as an earlier rotation
+    unsigned normalised = s->shape >> (s->top * PIECE_SIZE + s->left);
+    s->canonical = rotation;
+    for (int other = 0; other < rotation; other++) {
+        const Shape_t *o = &shapes[type][other];
+        if ((o->shape >> (o->top * PIECE_SIZE + o->left)) == normalised) {
+            s->canonical = o->canonical;
+            break;
+        }
+    }
+}
+
+// Prints one [PIECE_COUNT][4] table; row() prints the initialiser of one entry
+static void table(const char *comment, const char *declaration,
+                  void (*row)(const Shape_t *shape)) {
+    printf("\n// %s\n%s = {\n", comment, declaration);
+    for (int type = 0; type < PIECE_COUNT; type++) {
+        printf("    {  // %c\n", piece_names[type]);
+        for (int rotation = 0; rotation < 4; rotation++) {
+            printf("        ");
+            row(&shapes[type][rotation]);
+            printf(",\n");
+        }
+        printf("    },\n");
+    }
+    printf("};\n");
+}
+
+static void print_ints(const int *values, int count) {
+    printf("{");
+    for (int i = 0; i < count; i++) {
+        printf(i ? ", %d" : "%d", values[i]);
+    }
+    printf("}");
+}
+
+static void cells_row(const Shape_t *s) {
+    printf("{");
+    for (int i = 0; i < PIECE_CELLS; i++) {
+        printf(i ? ", {%d, %d}" : "{%d, %d}", s->cells[i][0], s->cells[i][1]);
+    }
+    printf("}");
+}
+
+static void row_masks_row(const Shape_t *s) {
+    printf("{");
+    for (int y = 0; y < PIECE_SIZE; y++) {
+        printf(y ? ", 0x%x" : "0x%x", s->rows[y]);
+    }
+    printf("}");
+}
+
+static void shape_mask_row(const Shape_t *s) {
+    printf("0x%04x", s->shape);
+}
+
+static void extent_row(const Shape_t *s) {
+    printf("{%d, %d, %d, %d}", s->left, s->right, s->top, s->bottom);
+}
+
+static void column_tops_row(const Shape_t *s) {
+    print_ints(s->column_tops, PIECE_SIZE);
+}
+
+static void column_bottoms_row(const Shape_t *s) {
+    print_ints(s->column_bottoms, PIECE_SIZE);
+}
+
+static void canonical_row(const Shape_t *s) {
+    printf("%d", s->canonical);
+}
+
+int main(void) {
+    for (int type = 0; type < PIECE_COUNT; type++) {
+        for (int rotation = 0; rotation < 4; rotation++) {
+            analyse(type, rotation);
+            if (shapes[type][rotation].cell_count != PIECE_CELLS) {
+                fprintf(stderr, "gen_piece_tables: %c rotation %d has %d cells, expected %d\n",
+                        piece_names[type], rotation, shapes[type][rotation].cell_count,
+                        PIECE_CELLS);
+                return 1;
+            }
+        }
+    }
+
+    printf("// Generated by tools/gen_piece_tables.c from piece_templates; do not edit\n");
+    printf("#ifndef TETRIS_PIECE_TABLES_H\n#define TETRIS_PIECE_TABLES_H\n\n");
+    printf("#include <stdint.h>\n#include \"tetris_types.h\"\n\n");
+    printf("#define PIECE_CELLS %d\n\n", PIECE_CELLS);
+    printf("typedef struct {\n    int8_t x, y;\n} PieceCell_t;\n\n");
+    printf("// Bounding box of the filled cells inside the 4x4 template\n");
+    printf("typedef struct {\n    int8_t left, right, top, bottom;\n} PieceExtent_t;\n");
+
+    table("Filled cells of [type][rotation] in row-major order",
+          "static const PieceCell_t piece_cells[PIECE_COUNT][4][PIECE_CELLS]", cells_row);
+    table("Bit x of row y set when the cell is filled",
+          "static const uint8_t piece_row_masks[PIECE_COUNT][4][PIECE_SIZE]", row_masks_row);
+    table("Whole shape, row y in bits 4y .. 4y + 3",
+          "static const uint16_t piece_shape_masks[PIECE_COUNT][4]", shape_mask_row);
+    table("Filled bounding box", "static const PieceExtent_t piece_extents[PIECE_COUNT][4]",
+          extent_row);
+    table("Highest filled row of each column, -1 when the column is empty",
+          "static const int8_t piece_column_tops[PIECE_COUNT][4][PIECE_SIZE]", column_tops_row);
+    table("Lowest filled row of each column, -1 when the column is empty",
+          "static const int8_t piece_column_bottoms[PIECE_COUNT][4][PIECE_SIZE]",
+          column_bottoms_row);
+    table("Lowest rotation with the same cells up to translation",
+          "static const uint8_t piece_canonical_rotation[PIECE_COUNT][4]", canonical_row);
+
+    printf("\n#endif  // TETRIS_PIECE_TABLES_H\n");
+    return ferror(stdout) ? 1 : 0;
+}
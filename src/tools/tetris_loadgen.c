@@ -0,0 +1,396 @@
+// tetris-loadgen: many bot players against tetris-server. Every player
+// mirrors its game locally from the same seed and inputs, so the bot can
+// decide without a round trip and each frame delta can be checked.
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include "tetris_bot.h"
+#include "tetris_fsm.h"
+#include "tetris_frame.h"
+#include "tetris_net.h"
+#include "tetris_pieces.h"
+#include "tetris_stream.h"
+
+#define LOADGEN_DEFAULT_ADDRESS "unix:/tmp/tetris-server.sock"
+#define LOADGEN_MAX_THREADS 64
+#define LOADGEN_MAX_EVENTS 256
+#define LOADGEN_BUFFER (NET_MAX_MESSAGE * 2)
+#define LATENCY_BUCKETS 100000  // 1 us each; the last one collects the rest
+
+typedef struct {
+    int fd;
+    bool ready;    // WELCOME received
+    bool waiting;  // an INPUT is in flight
+    bool open;
+    uint32_t seq;
+    uint64_t due_ns;
+    TetrisGame_t game;  // local mirror fed the same inputs
+    FrameExport_t frames;
+    FrameStream_t stream;  // field rebuilt from the server's frames
+    Bot_t bot;
+    NetBuffer_t in;
+    NetBuffer_t out;
+} Player_t;
+
+typedef struct {
+    pthread_t thread;
+    int epoll_fd;
+    Player_t **players;
+    int count;
+    uint64_t inputs;
+    uint64_t frames;
+    uint64_t bytes_in;
+    uint64_t mismatches;
+    uint64_t dropped;
+    uint64_t late;  // paced sends that missed their slot
+    uint64_t max_latency;
+    uint64_t *latency;
+} Client_t;
+
+static NetAddress_t server_address;
+static volatile sig_atomic_t stopping = 0;
+static uint64_t period_ns;  // 0 sends the next input as soon as a frame arrives
+static uint64_t end_ns;
+
+static void on_signal(int sig) {
+    (void)sig;
+    stopping = 1;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [-a unix:PATH|tcp:PORT] [-c PLAYERS] [-t THREADS] [-d SECONDS]\n"
+            "          [-r HZ (0 = closed loop)] [-s SEED]\n",
+            prog);
+}
+
+static void raise_fd_limit(void) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+static void player_free(Player_t *player) {
+    if (player->fd >= 0) close(player->fd);
+    bot_free(&player->bot);
+    frame_export_free(&player->frames);
+    game_destroy(&player->game);
+    net_buffer_free(&player->in);
+    net_buffer_free(&player->out);
+    stream_free(&player->stream);
+    free(player);
+}
+
+static Player_t *player_connect(uint64_t seed) {
+    Player_t *player = calloc(1, sizeof(Player_t));
+    if (!player) return NULL;
+
+    player->fd = -1;
+    if (!game_init(&player->game, BOARD_WIDTH, BOARD_HEIGHT) ||
+        !frame_export_init(&player->frames, BOARD_WIDTH, BOARD_HEIGHT) ||
+        !bot_init(&player->bot, &player->game, NULL) ||
+        !net_buffer_init(&player->in, LOADGEN_BUFFER) ||
+        !net_buffer_init(&player->out, LOADGEN_BUFFER) ||
+        !stream_init(&player->stream, BOARD_WIDTH, BOARD_HEIGHT, 0) ||
+        (player->fd = net_connect(&server_address)) < 0) {
+        player_free(player);
+        return NULL;
+    }
+    seed_piece_generator(&player->game, seed);
+
+    NetHello_t hello = {.version = NET_PROTOCOL_VERSION,
+                        .width = BOARD_WIDTH,
+                        .height = BOARD_HEIGHT,
+                        .seed = seed};
+    uint8_t *out = net_buffer_reserve(&player->out, NET_MAX_MESSAGE);
+    net_buffer_commit(&player->out, net_write_hello(out, NET_HELLO, &hello));
+    player->open = net_buffer_flush(&player->out, player->fd) != NET_IO_ERROR;
+    return player;
+}
+
+static void drop(Client_t *client, Player_t *player) {
+    if (!player->open) return;
+
+    player->open = false;
+    epoll_ctl(client->epoll_fd, EPOLL_CTL_DEL, player->fd, NULL);
+    client->dropped++;
+}
+
+// Next bot input, applied to the mirror before it goes out
+static void send_input(Client_t *client, Player_t *player, uint64_t now) {
+    UserAction_t action;
+    bool hold;
+    if (!bot_next_input(&player->bot, &player->game, &action, &hold)) {
+        // Game over: start again, and plan afresh for the new game
+        action = Start;
+        hold = false;
+        player->bot.planned_piece = -1;
+    }
+
+    NetInput_t input = {
+        .seq = ++player->seq, .stamp = now, .action = (uint8_t)action, .hold = hold};
+    net_step_game(&player->game, &input);
+    frame_export(&player->frames, &player->game);
+
+    uint8_t *out = net_buffer_reserve(&player->out, NET_MAX_MESSAGE);
+    if (!out) {
+        drop(client, player);
+        return;
+    }
+    net_buffer_commit(&player->out, net_write_input(out, &input));
+    NetIoResult_t result = net_buffer_flush(&player->out, player->fd);
+    if (result == NET_IO_CLOSED || result == NET_IO_ERROR) {
+        drop(client, player);
+        return;
+    }
+    player->waiting = true;
+    client->inputs++;
+}
+
+static void record_latency(Client_t *client, uint64_t ns) {
+    uint64_t us = ns / 1000;
+    client->latency[us < LATENCY_BUCKETS ? us : LATENCY_BUCKETS - 1]++;
+    if (ns > client->max_latency) client->max_latency = ns;
+}
+
+static bool handle_frame(Client_t *client, Player_t *player, const uint8_t *msg, int size,
+                         uint64_t now) {
+    NetFrame_t frame;
+    StreamFrame_t decoded;
+    if (!net_read_frame(msg, size, &frame) || !player->waiting || frame.seq != player->seq ||
+        stream_decode(&player->stream, frame.payload, (size_t)frame.payload_size, &decoded) !=
+            frame.payload_size) {
+        return false;
+    }
+
+    record_latency(client, now - frame.stamp);
+    client->frames++;
+    player->waiting = false;
+
+    const FrameView_t *expected = &player->frames.view;
+    if (memcmp(decoded.rows, expected->rows, BOARD_HEIGHT * sizeof(uint64_t)) != 0 ||
+        decoded.score != expected->score || decoded.level != expected->level ||
+        decoded.hold != expected->hold) {
+        client->mismatches++;
+    }
+    return true;
+}
+
+static void receive(Client_t *client, Player_t *player, uint64_t now) {
+    size_t before = net_buffer_pending(&player->in);
+    NetIoResult_t result = net_buffer_fill(&player->in, player->fd);
+    client->bytes_in += net_buffer_pending(&player->in) - before;
+
+    for (;;) {
+        const uint8_t *msg = player->in.data + player->in.start;
+        int size = net_buffer_next_message(&player->in);
+        if (size == 0) break;
+
+        NetHello_t welcome;
+        bool ok = size > 0 && (player->ready ? handle_frame(client, player, msg, size, now)
+                                             : net_read_hello(msg, size, &welcome));
+        if (!ok) {
+            drop(client, player);
+            return;
+        }
+        player->ready = true;
+        net_buffer_consume(&player->in, (size_t)size);
+    }
+
+    if (result == NET_IO_CLOSED || result == NET_IO_ERROR) {
+        drop(client, player);
+    } else if (period_ns == 0 && player->ready && !player->waiting) {
+        send_input(client, player, now);
+    }
+}
+
+static void *client_main(void *arg) {
+    Client_t *client = arg;
+    struct epoll_event events[LOADGEN_MAX_EVENTS];
+
+    for (;;) {
+        uint64_t now = now_ns();
+        if (stopping || now >= end_ns) break;
+
+        int count = epoll_wait(client->epoll_fd, events, LOADGEN_MAX_EVENTS, period_ns ? 1 : 100);
+        now = now_ns();
+        for (int i = 0; i < count; i++) {
+            receive(client, events[i].data.ptr, now);
+        }
+        if (!period_ns) continue;
+
+        // Paced mode: one input per period, never more than one in flight
+        for (int p = 0; p < client->count; p++) {
+            Player_t *player = client->players[p];
+            if (!player->open || !player->ready || player->waiting || now < player->due_ns) continue;
+
+            player->due_ns += period_ns;
+            if (player->due_ns < now) {
+                player->due_ns = now + period_ns;
+                client->late++;
+            }
+            send_input(client, player, now);
+        }
+    }
+    return NULL;
+}
+
+static uint64_t percentile(const uint64_t *histogram, uint64_t total, double fraction) {
+    uint64_t rank = (uint64_t)(fraction * (double)total);
+    uint64_t seen = 0;
+    for (int us = 0; us < LATENCY_BUCKETS; us++) {
+        seen += histogram[us];
+        if (seen > rank) return (uint64_t)us;
+    }
+    return LATENCY_BUCKETS;
+}
+
+int main(int argc, char **argv) {
+    const char *address_text = LOADGEN_DEFAULT_ADDRESS;
+    int player_count = 1000;
+    int thread_count = 1;
+    int duration = 10;
+    int rate = 60;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            usage(argv[0]);
+            return 1;
+        } else if (strcmp(argv[i], "-a") == 0) {
+            address_text = value;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            player_count = atoi(value);
+        } else if (strcmp(argv[i], "-t") == 0) {
+            thread_count = atoi(value);
+        } else if (strcmp(argv[i], "-d") == 0) {
+            duration = atoi(value);
+        } else if (strcmp(argv[i], "-r") == 0) {
+            rate = atoi(value);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            seed = strtoull(value, NULL, 10);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (!net_parse_address(address_text, &server_address) || player_count < 1 ||
+        thread_count < 1 || thread_count > LOADGEN_MAX_THREADS || duration < 1 || rate < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    raise_fd_limit();
+    struct sigaction action = {.sa_handler = on_signal};
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    period_ns = rate ? 1000000000ull / (uint64_t)rate : 0;
+
+    Client_t clients[LOADGEN_MAX_THREADS];
+    memset(clients, 0, sizeof(clients));
+    for (int t = 0; t < thread_count; t++) {
+        clients[t].epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        clients[t].players = calloc((size_t)player_count / thread_count + 1, sizeof(Player_t *));
+        clients[t].latency = calloc(LATENCY_BUCKETS, sizeof(uint64_t));
+        if (clients[t].epoll_fd < 0 || !clients[t].players || !clients[t].latency) {
+            fprintf(stderr, "%s: out of memory\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Connect everyone first so the run measures steady state
+    uint64_t connect_start = now_ns();
+    int failed = 0;
+    for (int p = 0; p < player_count && !stopping; p++) {
+        Client_t *client = &clients[p % thread_count];
+        Player_t *player = player_connect(seed + (uint64_t)p);
+        if (!player) {
+            failed++;
+            continue;
+        }
+
+        struct epoll_event event = {.events = EPOLLIN | EPOLLRDHUP, .data.ptr = player};
+        epoll_ctl(client->epoll_fd, EPOLL_CTL_ADD, player->fd, &event);
+        client->players[client->count++] = player;
+    }
+    double connect_seconds = (now_ns() - connect_start) / 1e9;
+
+    uint64_t start = now_ns();
+    end_ns = start + (uint64_t)duration * 1000000000ull;
+
+    // Spread first sends over one period so paced players are not in lockstep
+    for (int t = 0, k = 0; t < thread_count; t++) {
+        for (int p = 0; p < clients[t].count; p++, k++) {
+            clients[t].players[p]->due_ns = start + period_ns * (uint64_t)k / player_count;
+        }
+    }
+    for (int t = 0; t < thread_count; t++) {
+        pthread_create(&clients[t].thread, NULL, client_main, &clients[t]);
+    }
+
+    Client_t total = {0};
+    uint64_t *latency = calloc(LATENCY_BUCKETS, sizeof(uint64_t));
+    int held = 0;
+    for (int t = 0; t < thread_count; t++) {
+        Client_t *client = &clients[t];
+        pthread_join(client->thread, NULL);
+        total.inputs += client->inputs;
+        total.frames += client->frames;
+        total.bytes_in += client->bytes_in;
+        total.mismatches += client->mismatches;
+        total.dropped += client->dropped;
+        total.late += client->late;
+        if (client->max_latency > total.max_latency) total.max_latency = client->max_latency;
+        for (int us = 0; latency && us < LATENCY_BUCKETS; us++) {
+            latency[us] += client->latency[us];
+        }
+        for (int p = 0; p < client->count; p++) {
+            held += client->players[p]->open && client->players[p]->ready;
+            player_free(client->players[p]);
+        }
+        free(client->players);
+        free(client->latency);
+        close(client->epoll_fd);
+    }
+    double seconds = (now_ns() - start) / 1e9;
+
+    printf("%d players on %d thread%s, %s, %.1f s (connected in %.2f s)\n", player_count,
+           thread_count, thread_count == 1 ? "" : "s",
+           rate ? "paced" : "closed loop", seconds, connect_seconds);
+    if (rate) printf("pace: %d inputs/s per player, %llu late sends\n", rate,
+                     (unsigned long long)total.late);
+    printf("connections: %d held, %d failed, %llu dropped\n", held, failed,
+           (unsigned long long)total.dropped);
+    printf("messages: %llu inputs + %llu frames = %.0f msg/s\n", (unsigned long long)total.inputs,
+           (unsigned long long)total.frames, (total.inputs + total.frames) / seconds);
+    printf("frames: %.1f bytes avg, %llu mismatched\n",
+           total.frames ? (double)total.bytes_in / total.frames : 0.0,
+           (unsigned long long)total.mismatches);
+    if (latency && total.frames) {
+        printf("tick latency: p50 %llu us  p99 %llu us  p99.9 %llu us  max %.0f us\n",
+               (unsigned long long)percentile(latency, total.frames, 0.50),
+               (unsigned long long)percentile(latency, total.frames, 0.99),
+               (unsigned long long)percentile(latency, total.frames, 0.999),
+               total.max_latency / 1e3);
+    }
+    free(latency);
+
+    return held == player_count && total.mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,333 @@
+// tetris-server: hosts one engine per connection behind a local socket.
+// Each worker thread runs its own epoll loop; with TCP every worker has
+// its own SO_REUSEPORT listener, with a Unix socket they share one.
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include "tetris_fsm.h"
+#include "tetris_frame.h"
+#include "tetris_net.h"
+#include "tetris_pieces.h"
+#include "tetris_stream.h"
+
+#define SERVER_DEFAULT_ADDRESS "unix:/tmp/tetris-server.sock"
+#define SERVER_MAX_WORKERS 64
+#define SERVER_MAX_EVENTS 256
+#define SERVER_POLL_MS 200
+#define SERVER_IN_BUFFER (NET_MAX_MESSAGE * 2)
+#define SERVER_OUT_BUFFER (NET_MAX_MESSAGE * 2)
+
+typedef struct {
+    int fd;
+    uint32_t interest;
+    bool greeted;
+    TetrisGame_t game;
+    FrameExport_t frames;
+    FrameStream_t stream;
+    NetBuffer_t in;
+    NetBuffer_t out;
+} Connection_t;
+
+// Counters are written by the owning worker only and summed after join
+typedef struct {
+    pthread_t thread;
+    int epoll_fd;
+    int listen_fd;
+    uint64_t accepted;
+    uint64_t rejected;
+    uint64_t inputs;
+    uint64_t frames;
+    uint64_t bytes_out;
+} Worker_t;
+
+static NetAddress_t server_address;
+static volatile sig_atomic_t stopping = 0;
+static atomic_uint next_session = 1;
+static atomic_long open_connections = 0;
+static atomic_long peak_connections = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    stopping = 1;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-a unix:PATH|tcp:PORT] [-j WORKERS] [-d SECONDS]\n", prog);
+}
+
+// Thousands of sockets need more than the usual 1024 descriptors
+static void raise_fd_limit(void) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+static void close_connection(Connection_t *conn) {
+    close(conn->fd);
+    if (conn->greeted) {
+        game_destroy(&conn->game);
+        frame_export_free(&conn->frames);
+        stream_free(&conn->stream);
+    }
+    net_buffer_free(&conn->in);
+    net_buffer_free(&conn->out);
+    free(conn);
+    atomic_fetch_sub_explicit(&open_connections, 1, memory_order_relaxed);
+}
+
+static void accept_connections(Worker_t *worker) {
+    int fd;
+    while ((fd = net_accept(worker->listen_fd, &server_address)) >= 0) {
+        Connection_t *conn = calloc(1, sizeof(Connection_t));
+        if (!conn || !net_buffer_init(&conn->in, SERVER_IN_BUFFER) ||
+            !net_buffer_init(&conn->out, SERVER_OUT_BUFFER)) {
+            if (conn) {
+                net_buffer_free(&conn->in);
+                free(conn);
+            }
+            close(fd);
+            worker->rejected++;
+            continue;
+        }
+
+        conn->fd = fd;
+        conn->interest = EPOLLIN | EPOLLRDHUP;
+        struct epoll_event event = {.events = conn->interest, .data.ptr = conn};
+        long open = atomic_fetch_add_explicit(&open_connections, 1, memory_order_relaxed) + 1;
+        if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close_connection(conn);
+            worker->rejected++;
+            continue;
+        }
+
+        worker->accepted++;
+        long peak = atomic_load_explicit(&peak_connections, memory_order_relaxed);
+        while (open > peak && !atomic_compare_exchange_weak(&peak_connections, &peak, open)) {
+        }
+    }
+}
+
+static bool greet(Connection_t *conn, const uint8_t *msg, int size) {
+    NetHello_t hello;
+    if (!net_read_hello(msg, size, &hello) || net_message_type(msg) != NET_HELLO ||
+        hello.version != NET_PROTOCOL_VERSION || hello.height > NET_MAX_HEIGHT) {
+        return false;
+    }
+    if (!game_init(&conn->game, hello.width, hello.height)) return false;
+    if (!frame_export_init(&conn->frames, hello.width, hello.height) ||
+        !stream_init(&conn->stream, hello.width, hello.height, STREAM_DEFAULT_KEYFRAME_INTERVAL)) {
+        frame_export_free(&conn->frames);
+        game_destroy(&conn->game);
+        return false;
+    }
+    seed_piece_generator(&conn->game, hello.seed);
+    conn->greeted = true;
+
+    hello.session = atomic_fetch_add_explicit(&next_session, 1, memory_order_relaxed);
+    size_t written = net_write_hello(net_buffer_reserve(&conn->out, NET_MAX_MESSAGE), NET_WELCOME,
+                                     &hello);
+    net_buffer_commit(&conn->out, written);
+    return true;
+}
+
+// One tick of the connection's game, answered with a delta-coded frame
+static bool tick(Worker_t *worker, Connection_t *conn, const uint8_t *msg, int size) {
+    NetInput_t input;
+    if (!net_read_input(msg, size, &input)) return false;
+
+    net_step_game(&conn->game, &input);
+    const FrameView_t *view = frame_export(&conn->frames, &conn->game);
+    size_t written = net_write_frame(net_buffer_reserve(&conn->out, NET_MAX_MESSAGE), input.seq,
+                                     input.stamp, &conn->stream, view, &conn->game);
+    net_buffer_commit(&conn->out, written);
+
+    worker->inputs++;
+    worker->frames++;
+    worker->bytes_out += written;
+    return true;
+}
+
+// Handles complete messages until the input runs out or the output has no
+// room for another frame; the rest waits until the peer reads
+static bool process_messages(Worker_t *worker, Connection_t *conn) {
+    for (;;) {
+        if (conn->out.capacity - net_buffer_pending(&conn->out) < NET_MAX_MESSAGE) return true;
+
+        // A full input buffer without a whole message would never drain
+        const uint8_t *msg = conn->in.data + conn->in.start;
+        int size = net_buffer_next_message(&conn->in);
+        if (size <= 0) return size == 0;
+
+        bool ok = conn->greeted ? tick(worker, conn, msg, size) : greet(conn, msg, size);
+        if (!ok) return false;
+        net_buffer_consume(&conn->in, (size_t)size);
+    }
+}
+
+// Stop reading while the output is backed up; wait for writability only
+// while there is something left to send
+static bool update_interest(Worker_t *worker, Connection_t *conn) {
+    bool stalled = conn->out.capacity - net_buffer_pending(&conn->out) < NET_MAX_MESSAGE;
+    uint32_t interest = (stalled ? 0 : EPOLLIN | EPOLLRDHUP) |
+                        (net_buffer_pending(&conn->out) ? EPOLLOUT : 0);
+    if (interest == conn->interest) return true;
+
+    struct epoll_event event = {.events = interest, .data.ptr = conn};
+    conn->interest = interest;
+    return epoll_ctl(worker->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event) == 0;
+}
+
+static void service(Worker_t *worker, Connection_t *conn, uint32_t events) {
+    bool alive = !(events & EPOLLERR);
+
+    if (alive && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) {
+        NetIoResult_t result = net_buffer_fill(&conn->in, conn->fd);
+        alive = result == NET_IO_OK || result == NET_IO_FULL;
+    }
+    alive = alive && process_messages(worker, conn);
+    if (alive) {
+        NetIoResult_t result = net_buffer_flush(&conn->out, conn->fd);
+        alive = result == NET_IO_OK || result == NET_IO_FULL;
+    }
+    // Leftover input may fit now that the output drained
+    alive = alive && process_messages(worker, conn) && update_interest(worker, conn);
+
+    if (!alive) {
+        close_connection(conn);
+    }
+}
+
+static void *worker_main(void *arg) {
+    Worker_t *worker = arg;
+    struct epoll_event events[SERVER_MAX_EVENTS];
+
+    while (!stopping) {
+        int count = epoll_wait(worker->epoll_fd, events, SERVER_MAX_EVENTS, SERVER_POLL_MS);
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.ptr) {
+                service(worker, events[i].data.ptr, events[i].events);
+            } else {
+                accept_connections(worker);
+            }
+        }
+    }
+    return NULL;
+}
+
+static bool start_worker(Worker_t *worker, int shared_fd, bool reuse_port) {
+    worker->listen_fd = shared_fd >= 0 ? shared_fd : net_listen(&server_address, reuse_port);
+    worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (worker->listen_fd < 0 || worker->epoll_fd < 0) return false;
+
+    // A shared listener wakes one worker per connection, not all of them
+    struct epoll_event event = {.events = EPOLLIN | (shared_fd >= 0 ? EPOLLEXCLUSIVE : 0),
+                                .data.ptr = NULL};
+    return epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->listen_fd, &event) == 0 &&
+           pthread_create(&worker->thread, NULL, worker_main, worker) == 0;
+}
+
+int main(int argc, char **argv) {
+    const char *address_text = SERVER_DEFAULT_ADDRESS;
+    int worker_count = 1;
+    int duration = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            address_text = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            worker_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            duration = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!net_parse_address(address_text, &server_address) || worker_count < 1 ||
+        worker_count > SERVER_MAX_WORKERS || duration < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    raise_fd_limit();
+    struct sigaction action = {.sa_handler = on_signal};
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // SO_REUSEPORT only balances TCP; Unix workers share one listener
+    int shared_fd = -1;
+    if (server_address.is_unix || worker_count == 1) {
+        shared_fd = net_listen(&server_address, false);
+        if (shared_fd < 0) {
+            fprintf(stderr, "%s: cannot listen on %s: %s\n", argv[0], address_text, strerror(errno));
+            return 1;
+        }
+    }
+
+    Worker_t workers[SERVER_MAX_WORKERS];
+    memset(workers, 0, sizeof(workers));
+    int started = 0;
+    while (started < worker_count && start_worker(&workers[started], shared_fd, shared_fd < 0)) {
+        started++;
+    }
+    if (started < worker_count) {
+        fprintf(stderr, "%s: cannot start worker %d on %s: %s\n", argv[0], started, address_text,
+                strerror(errno));
+        stopping = 1;
+    } else {
+        printf("listening on %s with %d worker%s\n", address_text, worker_count,
+               worker_count == 1 ? "" : "s");
+        fflush(stdout);
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    const struct timespec poll = {0, SERVER_POLL_MS * 1000000L};
+    for (;;) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (stopping || (duration && now.tv_sec - start.tv_sec >= duration)) break;
+        nanosleep(&poll, NULL);
+    }
+    stopping = 1;
+
+    Worker_t total = {0};
+    for (int w = 0; w < started; w++) {
+        pthread_join(workers[w].thread, NULL);
+        total.accepted += workers[w].accepted;
+        total.rejected += workers[w].rejected;
+        total.inputs += workers[w].inputs;
+        total.frames += workers[w].frames;
+        total.bytes_out += workers[w].bytes_out;
+        if (workers[w].listen_fd != shared_fd) close(workers[w].listen_fd);
+        close(workers[w].epoll_fd);
+    }
+    if (shared_fd >= 0) close(shared_fd);
+    if (server_address.is_unix) unlink(server_address.path);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    double cpu = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+                 (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+
+    // Open connections are left to process exit, which closes them all
+    printf("%llu connections (peak %ld, %llu rejected), %llu inputs, %llu frames, "
+           "%.1f bytes/frame\n",
+           (unsigned long long)total.accepted, atomic_load(&peak_connections),
+           (unsigned long long)total.rejected,
+           (unsigned long long)total.inputs, (unsigned long long)total.frames,
+           total.frames ? (double)total.bytes_out / total.frames : 0.0);
+    printf("cpu %.2f s, %.2f us/tick\n", cpu, total.inputs ? cpu * 1e6 / total.inputs : 0.0);
+    return started < worker_count;
+}
@@ -0,0 +1,126 @@
+// tetris-spectate: read-only viewer for a game's shared-memory feed
+#define _POSIX_C_SOURCE 200809L
+#include <ncurses.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "tetris_types.h"
+#include "tetris_spectator.h"
+
+#define SPECTATE_POLL_NS 16666667L
+#define FIELD_Y 1
+#define FIELD_X 1
+
+static uint64_t rows[BOARD_MAX_HEIGHT];
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n] NAME\n", prog);
+    fprintf(stderr, "  -n  print one line per frame instead of drawing the board\n");
+}
+
+static void draw_frame(const SpectatorFrame_t *frame) {
+    int visible = (int)frame->height < LINES - 2 ? (int)frame->height : LINES - 2;
+    int first = (int)frame->height - visible;  // bottom of tall boards
+
+    erase();
+    mvaddch(FIELD_Y - 1, FIELD_X - 1, '+');
+    for (int y = 0; y < visible; y++) {
+        uint64_t row = rows[first + y];
+        move(FIELD_Y + y, FIELD_X - 1);
+        addch('|');
+        for (int x = 0; x < (int)frame->width; x++) {
+            addstr((row >> x) & 1 ? "[]" : "  ");
+        }
+        addch('|');
+    }
+
+    int info_x = FIELD_X + (int)frame->width * 2 + 3;
+    mvprintw(FIELD_Y, info_x, "SPECTATING");
+    mvprintw(FIELD_Y + 2, info_x, "Score: %d", frame->score);
+    mvprintw(FIELD_Y + 3, info_x, "High:  %d", frame->high_score);
+    mvprintw(FIELD_Y + 4, info_x, "Level: %d", frame->level);
+    mvprintw(FIELD_Y + 5, info_x, "Frame: %llu", (unsigned long long)frame->generation);
+    if (frame->pause) {
+        mvprintw(FIELD_Y + 7, info_x, "PAUSED");
+    }
+    mvprintw(FIELD_Y + 9, info_x, "Q - Quit");
+    refresh();
+}
+
+static void print_frame(const SpectatorFrame_t *frame) {
+    int stack = 0;
+    for (int y = 0; y < (int)frame->height; y++) {
+        if (rows[y]) {
+            stack = (int)frame->height - y;
+            break;
+        }
+    }
+
+    printf("%llu score=%d level=%d speed=%d pause=%d stack=%d\n",
+           (unsigned long long)frame->generation, frame->score, frame->level,
+           frame->speed, frame->pause, stack);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    bool headless = false;
+    const char *name = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0) {
+            headless = true;
+        } else if (!name) {
+            name = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!name) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    SpectatorFeed_t feed;
+    if (!spectator_open_reader(&feed, name)) {
+        fprintf(stderr, "%s: cannot attach to feed '%s'\n", argv[0], name);
+        return 1;
+    }
+
+    if (!headless) {
+        initscr();
+        cbreak();
+        noecho();
+        nodelay(stdscr, TRUE);
+        curs_set(0);
+    }
+
+    SpectatorFrame_t frame;
+    uint64_t last_generation = 0;
+    const struct timespec poll = {0, SPECTATE_POLL_NS};
+
+    for (;;) {
+        if (!headless) {
+            int ch = getch();
+            if (ch == 'q' || ch == 'Q') break;
+        }
+
+        if (spectator_read_latest(&feed, &frame, rows) && frame.generation != last_generation) {
+            last_generation = frame.generation;
+            if (headless) {
+                print_frame(&frame);
+            } else {
+                draw_frame(&frame);
+            }
+        }
+
+        nanosleep(&poll, NULL);
+    }
+
+    if (!headless) {
+        endwin();
+    }
+    spectator_close(&feed);
+
+    return 0;
+}
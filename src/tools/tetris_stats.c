@@ -0,0 +1,117 @@
+// tetris-stats: aggregates telemetry files written with `tetris -T FILE`.
+// Prints totals, the line-clear mix, and per level the pieces placed, the
+// placement rate in game time, the lines cleared and the stack height, so
+// difficulty curves and pieces per second can be compared between runs.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_telemetry.h"
+
+#define STATS_MAX_LEVEL 64
+#define STATS_FPS 60.0  // gravity frames per second of game time
+
+typedef struct {
+    uint64_t pieces;
+    uint64_t frames;  // game time spent placing this level's pieces
+    uint64_t lines;
+    uint64_t height_sum;
+    int height_max;
+} LevelStats_t;
+
+typedef struct {
+    uint64_t pieces;
+    uint64_t games;
+    uint64_t frames;
+    int64_t score;
+    uint64_t clears[5];  // locks by lines cleared
+    uint64_t types[PIECE_COUNT];
+    LevelStats_t levels[STATS_MAX_LEVEL + 1];
+} Stats_t;
+
+// Adds one file; a lock frame that goes backwards starts a new game
+static bool add_file(Stats_t *stats, const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    if (!telemetry_read_header(file)) {
+        fprintf(stderr, "%s: not a telemetry file\n", path);
+        fclose(file);
+        return false;
+    }
+
+    TelemetryRecord_t record;
+    uint32_t last_frame = 0;
+    bool in_game = false;
+    while (telemetry_read(file, &record)) {
+        if (!in_game || record.lock_frame < last_frame) {
+            stats->games++;
+            last_frame = 0;
+            in_game = true;
+        }
+        uint64_t frames = record.lock_frame - last_frame;
+        last_frame = record.lock_frame;
+
+        int level = record.level > STATS_MAX_LEVEL ? STATS_MAX_LEVEL : record.level;
+        LevelStats_t *lv = &stats->levels[level];
+        lv->pieces++;
+        lv->frames += frames;
+        lv->lines += record.lines;
+        lv->height_sum += record.height;
+        if (record.height > lv->height_max) lv->height_max = record.height;
+
+        stats->pieces++;
+        stats->frames += frames;
+        stats->score += record.score_delta;
+        stats->clears[record.lines <= 4 ? record.lines : 4]++;
+        if (record.piece < PIECE_COUNT) stats->types[record.piece]++;
+    }
+    fclose(file);
+    return true;
+}
+
+static double per_second(uint64_t count, uint64_t frames) {
+    return frames ? count * STATS_FPS / frames : 0.0;
+}
+
+static void print_stats(const Stats_t *stats) {
+    uint64_t lines = stats->clears[1] + 2 * stats->clears[2] + 3 * stats->clears[3] +
+                     4 * stats->clears[4];
+    printf("%llu pieces in %llu games, %.1f s of game time, %.2f pieces/s\n",
+           (unsigned long long)stats->pieces, (unsigned long long)stats->games,
+           stats->frames / STATS_FPS, per_second(stats->pieces, stats->frames));
+    printf("%llu lines: %llu single, %llu double, %llu triple, %llu tetris; score %lld\n",
+           (unsigned long long)lines, (unsigned long long)stats->clears[1],
+           (unsigned long long)stats->clears[2], (unsigned long long)stats->clears[3],
+           (unsigned long long)stats->clears[4], (long long)stats->score);
+
+    static const char names[PIECE_COUNT] = {'I', 'O', 'T', 'S', 'Z', 'J', 'L'};
+    printf("piece mix:");
+    for (int i = 0; i < PIECE_COUNT; i++) {
+        printf(" %c %.1f%%", names[i], stats->pieces ? 100.0 * stats->types[i] / stats->pieces : 0.0);
+    }
+    printf("\n\n%-6s %8s %9s %8s %10s %10s\n", "level", "pieces", "pieces/s", "lines",
+           "avg height", "max height");
+    for (int level = 0; level <= STATS_MAX_LEVEL; level++) {
+        const LevelStats_t *lv = &stats->levels[level];
+        if (!lv->pieces) continue;
+        printf("%-6d %8llu %9.2f %8llu %10.1f %10d\n", level, (unsigned long long)lv->pieces,
+               per_second(lv->pieces, lv->frames), (unsigned long long)lv->lines,
+               (double)lv->height_sum / lv->pieces, lv->height_max);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s FILE...\n", argv[0]);
+        return 1;
+    }
+
+    static Stats_t stats;
+    for (int i = 1; i < argc; i++) {
+        if (!add_file(&stats, argv[i])) return 1;
+    }
+    print_stats(&stats);
+    return 0;
+}
@@ -0,0 +1,413 @@
+// tetris-tune: cross-entropy search for bot evaluation weights. Every
+// generation samples a population of weight vectors around the current
+// mean, plays each on a fixed seed set across all cores, and refits the
+// mean and spread to the best fraction. Runs are reproducible from the
+// base seed and resumable from the checkpoint written after each generation.
+#define _GNU_SOURCE
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "tetris_bot.h"
+#include "tetris_fsm.h"
+#include "tetris_pieces.h"
+
+#define TUNE_WEIGHTS 7
+#define TUNE_MAX_THREADS 256
+#define TUNE_ELITE_FRACTION 0.1
+#define TUNE_INITIAL_SPREAD 0.5
+#define TUNE_NOISE 0.05  // added to the spread, halved every generation
+
+typedef struct {
+    int population;
+    int generations;
+    int seeds;
+    int max_pieces;
+    int threads;
+    uint64_t base_seed;
+    const char *checkpoint;
+} TuneConfig_t;
+
+// Search state; everything needed to resume lives here
+typedef struct {
+    int generation;  // generations completed
+    uint64_t rng;
+    double mean[TUNE_WEIGHTS];
+    double spread[TUNE_WEIGHTS];
+    double best[TUNE_WEIGHTS];
+    double best_fitness;
+} TuneState_t;
+
+// One generation's work, shared by the worker threads
+typedef struct {
+    const TuneConfig_t *config;
+    const uint64_t *game_seeds;
+    const double (*candidates)[TUNE_WEIGHTS];
+    int *lines;  // [candidate * seeds + seed]
+    atomic_int next_job;
+    atomic_llong pieces;
+} TuneBatch_t;
+
+typedef struct {
+    double fitness;
+    int index;
+} Ranked_t;
+
+static const char *weight_names[TUNE_WEIGHTS] = {
+    "lines", "holes", "height", "bumpiness", "wells", "row_transitions", "column_transitions"};
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [-p POPULATION] [-g GENERATIONS] [-n SEEDS] [-m MAX_PIECES]\n"
+            "          [-j THREADS] [-s BASE_SEED] [-c CHECKPOINT]\n",
+            prog);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// splitmix64: spreads consecutive seeds into unrelated streams
+static uint64_t mix_seed(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+static double uniform(uint64_t *state) {
+    *state = mix_seed(*state);
+    return ((*state >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double gaussian(uint64_t *state) {
+    double u = uniform(state);
+    double v = uniform(state);
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static void to_weights(const double *v, BotWeights_t *weights) {
+    weights->lines = v[0];
+    weights->holes = v[1];
+    weights->height = v[2];
+    weights->bumpiness = v[3];
+    weights->wells = v[4];
+    weights->row_transitions = v[5];
+    weights->column_transitions = v[6];
+}
+
+static void from_weights(const BotWeights_t *weights, double *v) {
+    v[0] = weights->lines;
+    v[1] = weights->holes;
+    v[2] = weights->height;
+    v[3] = weights->bumpiness;
+    v[4] = weights->wells;
+    v[5] = weights->row_transitions;
+    v[6] = weights->column_transitions;
+}
+
+// The evaluation is linear, so only the direction of the vector matters
+static void normalise(double *v) {
+    double norm = 0;
+    for (int i = 0; i < TUNE_WEIGHTS; i++) {
+        norm += v[i] * v[i];
+    }
+    norm = sqrt(norm);
+    for (int i = 0; norm > 0 && i < TUNE_WEIGHTS; i++) {
+        v[i] /= norm;
+    }
+}
+
+// One game from a fresh start; returns lines cleared
+static int play_game(TetrisGame_t *game, Bot_t *bot, uint64_t seed, int max_pieces,
+                     long *pieces) {
+    seed_piece_generator(game, seed);
+    game->state = STATE_START;
+    fsm_process_action(game, Start, false);
+    bot->planned_piece = -1;
+
+    while (game->pieces_spawned <= max_pieces && bot_play(bot, game)) {
+    }
+    *pieces += game->pieces_spawned;
+    return game->lines_cleared;
+}
+
+static void *worker_main(void *arg) {
+    TuneBatch_t *batch = arg;
+    const TuneConfig_t *config = batch->config;
+    TetrisGame_t game;
+    Bot_t bot;
+    long pieces = 0;
+
+    if (!game_init(&game, BOARD_WIDTH, BOARD_HEIGHT)) return NULL;
+    if (!bot_init(&bot, &game, NULL)) {
+        game_destroy(&game);
+        return NULL;
+    }
+
+    int jobs = config->population * config->seeds;
+    int job;
+    while ((job = atomic_fetch_add_explicit(&batch->next_job, 1, memory_order_relaxed)) < jobs) {
+        int candidate = job / config->seeds;
+        to_weights(batch->candidates[candidate], &bot.weights);
+        batch->lines[job] = play_game(&game, &bot, batch->game_seeds[job % config->seeds],
+                                      config->max_pieces, &pieces);
+    }
+
+    atomic_fetch_add_explicit(&batch->pieces, pieces, memory_order_relaxed);
+    bot_free(&bot);
+    game_destroy(&game);
+    return NULL;
+}
+
+static bool save_checkpoint(const char *path, const TuneConfig_t *config,
+                            const TuneState_t *state) {
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *file = fopen(tmp, "w");
+    if (!file) return false;
+
+    fprintf(file, "tetris-tune 1\n");
+    fprintf(file, "base_seed %llu\nseeds %d\nmax_pieces %d\n",
+            (unsigned long long)config->base_seed, config->seeds, config->max_pieces);
+    fprintf(file, "generation %d\nrng %llu\nbest_fitness %.17g\n", state->generation,
+            (unsigned long long)state->rng, state->best_fitness);
+
+    const double *vectors[] = {state->mean, state->spread, state->best};
+    const char *names[] = {"mean", "spread", "best"};
+    for (int v = 0; v < 3; v++) {
+        fprintf(file, "%s", names[v]);
+        for (int i = 0; i < TUNE_WEIGHTS; i++) {
+            fprintf(file, " %.17g", vectors[v][i]);
+        }
+        fprintf(file, "\n");
+    }
+
+    bool ok = !ferror(file);
+    ok &= fclose(file) == 0;
+    return ok && rename(tmp, path) == 0;
+}
+
+// Restores the search state and the seed set it was run with; returns 1
+// when resumed, 0 when there is no checkpoint and -1 when it is unreadable
+static int load_checkpoint(const char *path, TuneConfig_t *config, TuneState_t *state) {
+    FILE *file = fopen(path, "r");
+    if (!file) return 0;
+
+    TuneConfig_t loaded = *config;
+    TuneState_t resumed = {0};
+    unsigned long long base_seed, rng;
+    int version;
+    int fields = fscanf(file, "tetris-tune %d base_seed %llu seeds %d max_pieces %d "
+                              "generation %d rng %llu best_fitness %lg",
+                        &version, &base_seed, &loaded.seeds, &loaded.max_pieces,
+                        &resumed.generation, &rng, &resumed.best_fitness);
+    bool ok = fields == 7 && version == 1;
+
+    double *vectors[] = {resumed.mean, resumed.spread, resumed.best};
+    const char *names[] = {"mean", "spread", "best"};
+    for (int v = 0; ok && v < 3; v++) {
+        char name[16];
+        ok = fscanf(file, "%15s", name) == 1 && strcmp(name, names[v]) == 0;
+        for (int i = 0; ok && i < TUNE_WEIGHTS; i++) {
+            ok = fscanf(file, "%lg", &vectors[v][i]) == 1;
+        }
+    }
+    fclose(file);
+    if (!ok) return -1;
+
+    loaded.base_seed = base_seed;
+    resumed.rng = rng;
+    *config = loaded;
+    *state = resumed;
+    return 1;
+}
+
+// Best first; ties keep population order so the refit is deterministic
+static int compare_ranked(const void *a, const void *b) {
+    const Ranked_t *x = a;
+    const Ranked_t *y = b;
+    if (x->fitness != y->fitness) return x->fitness < y->fitness ? 1 : -1;
+    return x->index - y->index;
+}
+
+int main(int argc, char **argv) {
+    TuneConfig_t config = {.population = 200,
+                           .generations = 10,
+                           .seeds = 8,
+                           .max_pieces = 500,
+                           .threads = (int)sysconf(_SC_NPROCESSORS_ONLN),
+                           .base_seed = 1,
+                           .checkpoint = "tetris-tune.ckpt"};
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            usage(argv[0]);
+            return 1;
+        } else if (strcmp(argv[i], "-p") == 0) {
+            config.population = atoi(value);
+        } else if (strcmp(argv[i], "-g") == 0) {
+            config.generations = atoi(value);
+        } else if (strcmp(argv[i], "-n") == 0) {
+            config.seeds = atoi(value);
+        } else if (strcmp(argv[i], "-m") == 0) {
+            config.max_pieces = atoi(value);
+        } else if (strcmp(argv[i], "-j") == 0) {
+            config.threads = atoi(value);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            config.base_seed = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i], "-c") == 0) {
+            config.checkpoint = value;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (config.threads < 1) config.threads = 1;
+    if (config.threads > TUNE_MAX_THREADS) config.threads = TUNE_MAX_THREADS;
+
+    TuneState_t state = {0};
+    int resumed = load_checkpoint(config.checkpoint, &config, &state);
+    if (resumed < 0) {
+        fprintf(stderr, "%s: cannot parse checkpoint %s\n", argv[0], config.checkpoint);
+        return 1;
+    } else if (resumed) {
+        printf("resuming %s after generation %d (seed %llu, %d seeds, %d pieces)\n",
+               config.checkpoint, state.generation, (unsigned long long)config.base_seed,
+               config.seeds, config.max_pieces);
+    } else {
+        BotWeights_t defaults;
+        bot_default_weights(&defaults);
+        from_weights(&defaults, state.mean);
+        normalise(state.mean);
+        memcpy(state.best, state.mean, sizeof(state.best));
+        for (int i = 0; i < TUNE_WEIGHTS; i++) {
+            state.spread[i] = TUNE_INITIAL_SPREAD;
+        }
+        state.rng = mix_seed(config.base_seed ^ 0x7475);
+        state.best_fitness = -1;
+    }
+    if (config.population < 2 || config.seeds < 1 || config.max_pieces < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    int jobs = config.population * config.seeds;
+    uint64_t *game_seeds = malloc(sizeof(uint64_t) * config.seeds);
+    double (*candidates)[TUNE_WEIGHTS] = malloc(sizeof(*candidates) * config.population);
+    Ranked_t *ranked = malloc(sizeof(Ranked_t) * config.population);
+    int *lines = malloc(sizeof(int) * jobs);
+    if (!game_seeds || !candidates || !ranked || !lines) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+    for (int s = 0; s < config.seeds; s++) {
+        game_seeds[s] = mix_seed(config.base_seed + (uint64_t)s);
+    }
+
+    int elite = (int)(config.population * TUNE_ELITE_FRACTION);
+    if (elite < 2) elite = 2;
+    printf("population %d, elite %d, %d seeds, %d pieces per game, %d threads\n",
+           config.population, elite, config.seeds, config.max_pieces, config.threads);
+
+    int last = state.generation + config.generations;
+    while (state.generation < last) {
+        // Sample around the mean; the extra noise keeps the spread from
+        // collapsing before the mean settles
+        double noise = TUNE_NOISE / (double)(1 << (state.generation < 30 ? state.generation : 30));
+        for (int c = 0; c < config.population; c++) {
+            for (int i = 0; i < TUNE_WEIGHTS; i++) {
+                double spread = state.spread[i] + noise;
+                candidates[c][i] = state.mean[i] + spread * gaussian(&state.rng);
+            }
+            normalise(candidates[c]);
+        }
+
+        TuneBatch_t batch = {.config = &config,
+                             .game_seeds = game_seeds,
+                             .candidates = (const double (*)[TUNE_WEIGHTS])candidates,
+                             .lines = lines};
+        atomic_init(&batch.next_job, 0);
+        atomic_init(&batch.pieces, 0);
+
+        double start = now_seconds();
+        pthread_t threads[TUNE_MAX_THREADS];
+        int started = 0;
+        while (started < config.threads &&
+               pthread_create(&threads[started], NULL, worker_main, &batch) == 0) {
+            started++;
+        }
+        if (started == 0) {
+            worker_main(&batch);
+        }
+        for (int t = 0; t < started; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        double seconds = now_seconds() - start;
+
+        for (int c = 0; c < config.population; c++) {
+            long total = 0;
+            for (int s = 0; s < config.seeds; s++) {
+                total += lines[c * config.seeds + s];
+            }
+            ranked[c].fitness = (double)total / config.seeds;
+            ranked[c].index = c;
+        }
+        qsort(ranked, config.population, sizeof(Ranked_t), compare_ranked);
+
+        double elite_fitness = 0;
+        for (int i = 0; i < TUNE_WEIGHTS; i++) {
+            double mean = 0;
+            double var = 0;
+            for (int e = 0; e < elite; e++) {
+                mean += candidates[ranked[e].index][i];
+            }
+            mean /= elite;
+            for (int e = 0; e < elite; e++) {
+                double d = candidates[ranked[e].index][i] - mean;
+                var += d * d;
+            }
+            state.mean[i] = mean;
+            state.spread[i] = sqrt(var / elite);
+        }
+        for (int e = 0; e < elite; e++) {
+            elite_fitness += ranked[e].fitness / elite;
+        }
+        if (ranked[0].fitness > state.best_fitness) {
+            state.best_fitness = ranked[0].fitness;
+            memcpy(state.best, candidates[ranked[0].index], sizeof(state.best));
+        }
+        state.generation++;
+
+        long long pieces = atomic_load(&batch.pieces);
+        int cores = started ? started : 1;
+        printf("gen %3d  best %7.1f  elite %7.1f lines/game | %d games in %.2f s, "
+               "%.1f games/s/core, %.2f M pieces/min\n",
+               state.generation, ranked[0].fitness, elite_fitness, jobs, seconds,
+               jobs / seconds / cores, pieces / seconds * 60 / 1e6);
+        fflush(stdout);
+
+        if (!save_checkpoint(config.checkpoint, &config, &state)) {
+            fprintf(stderr, "%s: cannot write checkpoint %s\n", argv[0], config.checkpoint);
+        }
+    }
+
+    printf("best %.1f lines/game:\n", state.best_fitness);
+    for (int i = 0; i < TUNE_WEIGHTS; i++) {
+        printf("    weights->%s = %.4f;\n", weight_names[i], state.best[i]);
+    }
+
+    free(game_seeds);
+    free(candidates);
+    free(ranked);
+    free(lines);
+    return 0;
+}
@@ -1,6 +1,28 @@
 #include <check.h>
 #include <stdlib.h>
 #include "tetris.h"
+#include "tetris_board.h"
+#include "tetris_pieces.h"
+#include "tetris_rowscan.h"
+#include "tetris_spectator.h"
+#include "tetris_fsm.h"
+#include "tetris_bot.h"
+#include "tetris_puzzle.h"
+#include "tetris_hash.h"
+#include "tetris_movegen.h"
+#include "tetris_piece_tables.h"
+#include "tetris_versus.h"
+#include "tetris_net.h"
+#include "tetris_frame.h"
+#include "tetris_stream.h"
+#include "brick_runtime.h"
+#include "tetris_game.h"
+#include "frogger_game.h"
+#include "tetris_telemetry.h"
+#include <sys/socket.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
 
 // Test initialization
 START_TEST(test_init_game) {
@@ -165,6 +187,1166 @@ START_TEST(test_termination) {
 }
 END_TEST
 
+// Test runtime board geometry
+START_TEST(test_custom_geometry) {
+    ck_assert(init_game_with_geometry(16, 40));
+    ck_assert_int_eq(get_board_width(), 16);
+    ck_assert_int_eq(get_board_height(), 40);
+    
+    userInput(Start, false);
+    GameInfo_t info = updateCurrentState();
+    
+    ck_assert_ptr_ne(info.field, NULL);
+    for (int y = 0; y < get_board_height(); y++) {
+        ck_assert_ptr_ne(info.field[y], NULL);
+    }
+    
+    // Clean up
+    if (info.field) free_field_memory(info.field, get_board_height());
+    if (info.next) free_field_memory(info.next, PIECE_SIZE);
+    cleanup_game();
+}
+END_TEST
+
+// Test geometry limits
+START_TEST(test_invalid_geometry) {
+    ck_assert(!init_game_with_geometry(BOARD_MIN_WIDTH - 1, BOARD_HEIGHT));
+    ck_assert(!init_game_with_geometry(BOARD_MAX_WIDTH + 1, BOARD_HEIGHT));
+    ck_assert(!init_game_with_geometry(BOARD_WIDTH, BOARD_MAX_HEIGHT + 1));
+    ck_assert_int_eq(get_board_width(), BOARD_WIDTH);
+}
+END_TEST
+
+// Test line clearing in every row width class
+START_TEST(test_board_line_clear) {
+    const int widths[] = {10, 16, 32, 64};
+    
+    for (int w = 0; w < 4; w++) {
+        Board_t board;
+        ck_assert(board_init(&board, widths[w], 100));
+        int bottom = board.total_height - 1;
+        
+        // Two full rows around a marker row
+        board.kernels->set_row(&board, bottom, board.full_row);
+        board_set_cell(&board, 0, bottom - 1, true);
+        board.kernels->set_row(&board, bottom - 2, board.full_row);
+        board_set_cell(&board, widths[w] - 1, bottom - 3, true);
+        
+        ck_assert_int_eq(board.kernels->clear_lines(&board), 2);
+        ck_assert(board_get_cell(&board, 0, bottom));
+        ck_assert(board_get_cell(&board, widths[w] - 1, bottom - 1));
+        ck_assert_uint_eq(board.kernels->get_row(&board, bottom - 2), 0);
+        
+        board_free(&board);
+    }
+}
+END_TEST
+
+// Test collision at board edges in every row width class
+START_TEST(test_board_collision) {
+    const int widths[] = {10, 32, 64};
+    
+    for (int w = 0; w < 3; w++) {
+        Board_t board;
+        ck_assert(board_init(&board, widths[w], 20));
+        
+        Piece_t piece;
+        init_piece(&piece, PIECE_I);
+        piece.y = 5;
+        piece.x = widths[w] - PIECE_SIZE;
+        ck_assert(board.kernels->fits(&board, &piece));
+        piece.x++;
+        ck_assert(!board.kernels->fits(&board, &piece));
+        
+        // Vertical I has an empty left column and may hang off the edge
+        rotate_piece(&piece);
+        rotate_piece(&piece);
+        rotate_piece(&piece);
+        piece.x = -1;
+        ck_assert(board.kernels->fits(&board, &piece));
+        piece.x = -2;
+        ck_assert(!board.kernels->fits(&board, &piece));
+        
+        piece.x = 0;
+        board.kernels->place(&board, &piece);
+        ck_assert(board_get_cell(&board, 1, 5));
+        ck_assert(board_get_cell(&board, 1, 8));
+        ck_assert(!board.kernels->fits(&board, &piece));
+        
+        board_free(&board);
+    }
+}
+END_TEST
+
+// Test that every vectorised line clear matches the scalar one
+START_TEST(test_rowscan_differential) {
+    const int widths[] = {16, 32, 64};
+    uint64_t scalar_rows[300];
+    uint64_t simd_rows[300];
+    unsigned seed = 12345;
+    
+    for (int w = 0; w < 3; w++) {
+        int row_bytes = widths[w] / 8;
+        uint64_t full = widths[w] == 64 ? UINT64_MAX : (UINT64_C(1) << widths[w]) - 1;
+        
+        for (int round = 0; round < 200; round++) {
+            int count = 5 + round % 290;
+            
+            // Random rows, roughly a quarter of them full
+            for (int i = 0; i < count; i++) {
+                seed = seed * 1103515245u + 12345u;
+                uint64_t row = ((uint64_t)seed << 32 | (seed >> 3)) & full;
+                if ((seed >> 20) % 4 == 0) row = full;
+                memcpy((char *)scalar_rows + i * row_bytes, &row, row_bytes);
+            }
+            
+            for (int level = ROWSCAN_SSE2; level < ROWSCAN_LEVEL_COUNT; level++) {
+                if (!rowscan_level_supported(level)) continue;
+                
+                uint64_t expected_rows[300];
+                memcpy(expected_rows, scalar_rows, count * row_bytes);
+                memcpy(simd_rows, scalar_rows, count * row_bytes);
+                
+                int expected = rows_clear_full(ROWSCAN_SCALAR, expected_rows, widths[w],
+                                               count, BOARD_EXTRA_HEIGHT, full);
+                int actual = rows_clear_full(level, simd_rows, widths[w],
+                                             count, BOARD_EXTRA_HEIGHT, full);
+                
+                ck_assert_int_eq(actual, expected);
+                ck_assert_mem_eq(simd_rows, expected_rows, count * row_bytes);
+            }
+        }
+    }
+}
+END_TEST
+
+// Test that the packed frame matches the int grid export
+START_TEST(test_frame_matches_game_info) {
+    init_game();
+    userInput(Start, false);
+    userInput(Down, false);
+    
+    const FrameView_t *frame = updateCurrentFrame();
+    GameInfo_t info = updateCurrentState();
+    
+    ck_assert_ptr_ne(frame, NULL);
+    ck_assert_int_eq(frame->width, BOARD_WIDTH);
+    ck_assert_int_eq(frame->height, BOARD_HEIGHT);
+    ck_assert_int_eq(frame->score, info.score);
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        for (int x = 0; x < BOARD_WIDTH; x++) {
+            ck_assert_int_eq((int)((frame->rows[y] >> x) & 1), info.field[y][x]);
+        }
+    }
+    for (int y = 0; y < PIECE_SIZE; y++) {
+        for (int x = 0; x < PIECE_SIZE; x++) {
+            ck_assert_int_eq((frame->next >> (y * PIECE_SIZE + x)) & 1, info.next[y][x]);
+        }
+    }
+    
+    // Clean up
+    if (info.field) free_field_memory(info.field, BOARD_HEIGHT);
+    if (info.next) free_field_memory(info.next, PIECE_SIZE);
+}
+END_TEST
+
+// Test that frame deltas replay onto the previous frame
+START_TEST(test_frame_deltas) {
+    init_game();
+    userInput(Start, false);
+    for (int i = 0; i < 3; i++) {
+        userInput(Down, false);
+    }
+    
+    const FrameView_t *frame = updateCurrentFrame();
+    uint64_t generation = frame->generation;
+    uint64_t rows[BOARD_HEIGHT];
+    memcpy(rows, frame->rows, sizeof(rows));
+    
+    // Nothing moved: empty delta, new generation
+    frame = updateCurrentFrame();
+    ck_assert_uint_eq(frame->generation, generation + 1);
+    ck_assert_int_eq(frame->change_count, 0);
+    ck_assert_int_eq(frame->dirty_count, 0);
+    
+    userInput(Down, false);
+    frame = updateCurrentFrame();
+    ck_assert_int_gt(frame->change_count, 0);
+    ck_assert_int_gt(frame->dirty_count, 0);
+    
+    for (int i = 0; i < frame->change_count; i++) {
+        const CellChange_t *change = &frame->changes[i];
+        ck_assert(frame_row_dirty(frame, change->y));
+        if (change->filled) {
+            rows[change->y] |= UINT64_C(1) << change->x;
+        } else {
+            rows[change->y] &= ~(UINT64_C(1) << change->x);
+        }
+    }
+    ck_assert_mem_eq(rows, frame->rows, sizeof(rows));
+}
+END_TEST
+
+// Test a shared-memory feed round trip
+START_TEST(test_spectator_feed) {
+    char name[64];
+    snprintf(name, sizeof(name), "tetris_test_%d", (int)getpid());
+    
+    TetrisGame_t game;
+    FrameExport_t fx;
+    SpectatorFeed_t writer;
+    SpectatorFeed_t reader;
+    ck_assert(game_init(&game, BOARD_WIDTH, BOARD_HEIGHT));
+    ck_assert(frame_export_init(&fx, BOARD_WIDTH, BOARD_HEIGHT));
+    ck_assert(spectator_open_writer(&writer, name, BOARD_WIDTH, BOARD_HEIGHT));
+    ck_assert(spectator_open_reader(&reader, name));
+    ck_assert_int_eq(reader.height, BOARD_HEIGHT);
+    
+    board_set_cell(&game.board, 2, TOTAL_HEIGHT - 1, true);
+    game.score = 300;
+    const FrameView_t *view = NULL;
+    for (int i = 0; i < SPECTATOR_SLOTS + 1; i++) {
+        view = frame_export(&fx, &game);
+        spectator_publish(&writer, view);
+    }
+    
+    SpectatorFrame_t frame;
+    uint64_t rows[BOARD_HEIGHT];
+    ck_assert_uint_eq(spectator_frames_published(&reader), SPECTATOR_SLOTS + 1);
+    ck_assert(spectator_read_latest(&reader, &frame, rows));
+    ck_assert_uint_eq(frame.generation, view->generation);
+    ck_assert_int_eq(frame.score, 300);
+    ck_assert_mem_eq(rows, view->rows, sizeof(rows));
+    
+    // The oldest frame has been overwritten by the ring
+    ck_assert(!spectator_read(&reader, 0, &frame, rows));
+    spectator_close(&reader);
+    
+    // Readers refuse headers that would index outside the mapping: the
+    // header is magic, slot count, width, height, then the slot size
+    uint32_t *header = writer.base;
+    uint32_t good[2] = {header[1], header[3]};
+    header[1] = 0;
+    ck_assert(!spectator_open_reader(&reader, name));
+    header[1] = UINT32_MAX;
+    ck_assert(!spectator_open_reader(&reader, name));
+    header[1] = good[0];
+    header[3] = BOARD_MAX_HEIGHT + 1;
+    ck_assert(!spectator_open_reader(&reader, name));
+    header[3] = good[1];
+    ck_assert(spectator_open_reader(&reader, name));
+    
+    spectator_close(&reader);
+    spectator_close(&writer);
+    frame_export_free(&fx);
+    game_destroy(&game);
+}
+END_TEST
+
+// Test bot board features on a hand-built board
+START_TEST(test_bot_features) {
+    Board_t board;
+    ck_assert(board_init(&board, BOARD_WIDTH, BOARD_HEIGHT));
+    int bottom = board.total_height - 1;
+    ck_assert_int_eq(board_stack_height(&board), 0);
+    
+    // Column 0 is two high with a hole under it, column 1 is one high
+    board_set_cell(&board, 0, bottom - 1, true);
+    board_set_cell(&board, 1, bottom, true);
+    ck_assert_int_eq(board_stack_height(&board), 2);
+    
+    BotFeatures_t features;
+    bot_features(&board, 0, &features);
+    ck_assert_int_eq(features.holes, 1);
+    ck_assert_int_eq(features.aggregate_height, 3);
+    ck_assert_int_eq(features.bumpiness, 2);
+    
+    board_free(&board);
+}
+END_TEST
+
+// Test that seeded bot games are reproducible and clear lines
+START_TEST(test_bot_seeded_game) {
+    TetrisGame_t games[2];
+    Bot_t bots[2];
+    
+    for (int g = 0; g < 2; g++) {
+        ck_assert(game_init(&games[g], BOARD_WIDTH, BOARD_HEIGHT));
+        seed_piece_generator(&games[g], 42);
+        ck_assert(bot_init(&bots[g], &games[g], NULL));
+        while (games[g].pieces_spawned < 200 && bot_play(&bots[g], &games[g])) {
+        }
+    }
+    
+    ck_assert_int_eq(games[0].pieces_spawned, games[1].pieces_spawned);
+    ck_assert_int_eq(games[0].score, games[1].score);
+    ck_assert_int_gt(games[0].lines_cleared, 0);
+    
+    for (int g = 0; g < 2; g++) {
+        bot_free(&bots[g]);
+        game_destroy(&games[g]);
+    }
+}
+END_TEST
+
+// Test puzzle parsing and that the solver finds the line clears
+START_TEST(test_puzzle_solver) {
+    Puzzle_t puzzle;
+    PuzzleOptions_t options;
+    PuzzleResult_t result;
+    puzzle_default_options(&options);
+    options.table_bytes = 1 << 16;
+    
+    ck_assert(!puzzle_parse(&puzzle, "pieces Q\n"));
+    ck_assert(!puzzle_parse(&puzzle, "pieces O\nXXX\n"));
+    
+    ck_assert(puzzle_parse(&puzzle, "# two O pieces\npieces O O\nXXXXXX....\nXXXXXX....\n"));
+    ck_assert_int_eq(puzzle.piece_count, 2);
+    ck_assert(puzzle_solve(&puzzle, &options, &result));
+    ck_assert(result.solved);
+    ck_assert_int_eq(result.lines, 2);
+    ck_assert_int_eq(result.placement_count, 2);
+    ck_assert_int_gt(result.nodes, 0);
+    
+    // Replaying the answer must leave the board empty
+    Board_t *board = &puzzle.board;
+    for (int i = 0; i < result.placement_count; i++) {
+        Piece_t piece;
+        init_piece(&piece, result.placements[i].type);
+        for (int r = 0; r < result.placements[i].rotation; r++) {
+            rotate_piece(&piece);
+        }
+        piece.x = result.placements[i].x;
+        piece.y = result.placements[i].y;
+        ck_assert(board->kernels->fits(board, &piece));
+        board->kernels->place(board, &piece);
+        board->kernels->clear_lines(board);
+    }
+    for (int y = 0; y < board->total_height; y++) {
+        ck_assert_uint_eq(board->kernels->get_row(board, y), 0);
+    }
+    puzzle_free(&puzzle);
+    
+    // Odd column parity cannot be fixed by O pieces alone
+    ck_assert(puzzle_parse(&puzzle, "size 6 8\npieces O O O\nXXXXX.\n"));
+    ck_assert(puzzle_solve(&puzzle, &options, &result));
+    ck_assert(!result.solved);
+    ck_assert_int_gt(result.pruned, 0);
+    puzzle_free(&puzzle);
+    
+    // Line mode: an I into the well clears four
+    options.perfect_clear = false;
+    ck_assert(puzzle_parse(&puzzle, "pieces I\nXXXXXXXXX.\nXXXXXXXXX.\nXXXXXXXXX.\nXXXXXXXXX.\n"));
+    ck_assert(puzzle_solve(&puzzle, &options, &result));
+    ck_assert_int_eq(result.lines, 4);
+    puzzle_free(&puzzle);
+    
+    // A ragged stack: rows that need more cells than the queue has left are
+    // pruned instead of searched
+    ck_assert(puzzle_parse(&puzzle, "pieces I T L J\nX.XXXXXXX.\nXX.XXXXXX.\n"
+                                    "XXX.XXXXX.\nXXXX.XXXX.\nXXXXX.XXX.\n"));
+    ck_assert(puzzle_solve(&puzzle, &options, &result));
+    ck_assert_int_eq(result.lines, 2);
+    ck_assert_int_gt(result.pruned, 0);
+    puzzle_free(&puzzle);
+}
+END_TEST
+
+// Test that the incremental board hash tracks recomputation and replays
+START_TEST(test_state_hash) {
+    TetrisGame_t games[2];
+    Bot_t bots[2];
+    
+    for (int g = 0; g < 2; g++) {
+        ck_assert(game_init(&games[g], BOARD_WIDTH, BOARD_HEIGHT));
+        seed_piece_generator(&games[g], 7);
+        ck_assert(bot_init(&bots[g], &games[g], NULL));
+    }
+    ck_assert_uint_eq(games[0].board_hash, 0);
+    
+    // The incremental hash must track a full recomputation through clears
+    while (games[0].pieces_spawned < 300 && bot_play(&bots[0], &games[0])) {
+        bot_play(&bots[1], &games[1]);
+        ck_assert_uint_eq(games[0].board_hash, board_hash(&games[0].board));
+        ck_assert_uint_eq(game_hash(&games[0]), game_hash(&games[1]));
+    }
+    ck_assert_int_gt(games[0].lines_cleared, 0);
+    
+    // A different piece position changes the hash
+    Piece_t moved = games[0].current_piece;
+    moved.x++;
+    ck_assert_uint_ne(piece_hash(&moved), piece_hash(&games[0].current_piece));
+    
+    for (int g = 0; g < 2; g++) {
+        bot_free(&bots[g]);
+        game_destroy(&games[g]);
+    }
+    
+    // Global API: moving the piece changes the state hash, moving back restores it
+    init_game();
+    userInput(Start, false);
+    userInput(Up, false);
+    userInput(Up, false);
+    uint64_t spawned = get_state_hash();
+    userInput(Left, false);
+    ck_assert_uint_ne(get_state_hash(), spawned);
+    userInput(Right, false);
+    ck_assert_uint_eq(get_state_hash(), spawned);
+    cleanup_game();
+}
+END_TEST
+
+// Feeds a landing's inputs to the engine and checks where the piece locks
+static void replay_landing(TetrisGame_t *game, const MoveGen_t *gen, const Landing_t *landing,
+                           const Piece_t *start) {
+    const uint8_t *inputs = movegen_landing_inputs(gen, landing);
+    
+    game->state = STATE_MOVING;
+    game->current_piece = *start;
+    for (int i = 0; i < landing->input_count; i++) {
+        UserAction_t action;
+        bool hold;
+        ck_assert_int_eq(game->state, STATE_MOVING);
+        move_input_action(inputs[i], &action, &hold);
+        fsm_process_action(game, action, hold);
+    }
+    ck_assert_int_eq(game->state, STATE_ATTACHING);
+    ck_assert_int_eq(game->current_piece.x, landing->x);
+    ck_assert_int_eq(game->current_piece.y, landing->y);
+    ck_assert_int_eq(game->current_piece.rotation, landing->rotation);
+}
+
+// Test that every generated landing is reachable by its input sequence
+START_TEST(test_move_generator) {
+    const int expected[PIECE_COUNT] = {17, 9, 34, 17, 17, 34, 34};
+    TetrisGame_t game;
+    MoveGen_t gen;
+    Piece_t start;
+    
+    ck_assert(game_init(&game, BOARD_WIDTH, BOARD_HEIGHT));
+    ck_assert(movegen_init(&gen, BOARD_WIDTH, BOARD_HEIGHT));
+    
+    // Empty board: symmetric rotations collapse into one landing each
+    for (int type = 0; type < PIECE_COUNT; type++) {
+        init_piece(&start, type);
+        ck_assert_int_eq(movegen_generate(&gen, &game.board, &start), expected[type]);
+        for (int i = 0; i < gen.landing_count; i++) {
+            replay_landing(&game, &gen, &gen.landings[i], &start);
+        }
+    }
+    
+    // Pocket under a roof in columns 0-1 that a straight drop cannot reach
+    const int bottom = TOTAL_HEIGHT - 1;
+    for (int x = 4; x < BOARD_WIDTH; x++) {
+        board_set_cell(&game.board, x, bottom, true);
+        board_set_cell(&game.board, x, bottom - 1, true);
+    }
+    board_set_cell(&game.board, 0, bottom - 2, true);
+    board_set_cell(&game.board, 1, bottom - 2, true);
+    
+    init_piece(&start, PIECE_O);
+    ck_assert_int_gt(movegen_generate(&gen, &game.board, &start), 0);
+    bool tucked = false;
+    for (int i = 0; i < gen.landing_count; i++) {
+        const Landing_t *landing = &gen.landings[i];
+        replay_landing(&game, &gen, landing, &start);
+        tucked |= landing->x + 1 == 0 && landing->y + 2 == bottom;
+    }
+    ck_assert(tucked);
+    ck_assert_int_gt(gen.states_expanded, 0);
+    
+    movegen_free(&gen);
+    game_destroy(&game);
+}
+END_TEST
+
+// Test that the packed piece tables match the cell templates
+START_TEST(test_piece_tables_match_templates) {
+    for (int type = 0; type < PIECE_COUNT; type++) {
+        unsigned normalised[4];
+        
+        for (int rotation = 0; rotation < 4; rotation++) {
+            const PieceExtent_t *extent = &piece_extents[type][rotation];
+            int cell = 0;
+            unsigned shape = 0;
+            
+            for (int y = 0; y < PIECE_SIZE; y++) {
+                unsigned row = 0;
+                for (int x = 0; x < PIECE_SIZE; x++) {
+                    if (!piece_templates[type][rotation][y][x]) continue;
+                    
+                    ck_assert_int_lt(cell, PIECE_CELLS);
+                    ck_assert_int_eq(piece_cells[type][rotation][cell].x, x);
+                    ck_assert_int_eq(piece_cells[type][rotation][cell].y, y);
+                    cell++;
+                    row |= 1u << x;
+                    
+                    ck_assert(x >= extent->left && x <= extent->right);
+                    ck_assert(y >= extent->top && y <= extent->bottom);
+                    ck_assert_int_le(piece_column_tops[type][rotation][x], y);
+                    ck_assert_int_ge(piece_column_bottoms[type][rotation][x], y);
+                }
+                ck_assert_uint_eq(piece_row_masks[type][rotation][y], row);
+                shape |= row << (y * PIECE_SIZE);
+            }
+            ck_assert_int_eq(cell, PIECE_CELLS);
+            ck_assert_uint_eq(piece_shape_masks[type][rotation], shape);
+            
+            // Extents and column profiles are tight
+            for (int x = 0; x < PIECE_SIZE; x++) {
+                int top = piece_column_tops[type][rotation][x];
+                int bottom = piece_column_bottoms[type][rotation][x];
+                ck_assert_int_eq(top < 0, !((shape >> x) & 0x1111));
+                if (top >= 0) {
+                    ck_assert(piece_templates[type][rotation][top][x]);
+                    ck_assert(piece_templates[type][rotation][bottom][x]);
+                }
+            }
+            ck_assert(shape & (0x1111u << extent->left) && shape & (0x1111u << extent->right));
+            ck_assert(shape & (0xfu << (extent->top * PIECE_SIZE)));
+            ck_assert(shape & (0xfu << (extent->bottom * PIECE_SIZE)));
+            
+            normalised[rotation] = shape >> (extent->top * PIECE_SIZE + extent->left);
+            int canonical = piece_canonical_rotation[type][rotation];
+            ck_assert_int_le(canonical, rotation);
+            ck_assert_uint_eq(normalised[canonical], normalised[rotation]);
+            for (int other = 0; other < canonical; other++) {
+                ck_assert_uint_ne(normalised[other], normalised[rotation]);
+            }
+            
+            // Board helpers read the tables through the piece's rotation
+            Piece_t piece;
+            init_piece(&piece, type);
+            for (int r = 0; r < rotation; r++) rotate_piece(&piece);
+            for (int y = 0; y < PIECE_SIZE; y++) {
+                ck_assert_uint_eq(piece_row_mask(&piece, y), piece_row_masks[type][rotation][y]);
+            }
+        }
+    }
+}
+END_TEST
+
+// Test the preview queue against the raw generator, across ring wraps, and the hold slot
+START_TEST(test_preview_queue_and_hold) {
+    TetrisGame_t game;
+    TetrisGame_t reference;
+    ck_assert(game_init(&game, BOARD_WIDTH, BOARD_HEIGHT));
+    ck_assert(game_init(&reference, BOARD_WIDTH, BOARD_HEIGHT));
+    seed_piece_generator(&game, 99);
+    seed_piece_generator(&reference, 99);
+    
+    ck_assert(!piece_queue_set_preview(&game, PREVIEW_MIN - 1));
+    ck_assert(!piece_queue_set_preview(&game, PREVIEW_MAX + 1));
+    ck_assert(piece_queue_set_preview(&game, PREVIEW_MAX));
+    
+    PieceType_t expected[64];
+    for (int i = 0; i < 64; i++) {
+        expected[i] = next_piece_type(&reference);
+    }
+    
+    fsm_process_action(&game, Start, false);
+    fsm_process_action(&game, Start, false);
+    ck_assert_int_eq(game.state, STATE_MOVING);
+    ck_assert_int_eq(game.hold_piece, -1);
+    
+    // Dropping pieces in the middle column walks the ring past several wraps
+    for (int piece = 0; piece < 3 * PIECE_QUEUE_CAPACITY; piece++) {
+        ck_assert_int_eq(game.current_piece.type, expected[piece]);
+        
+        int count;
+        const uint8_t *view = piece_queue_view(&game, &count);
+        ck_assert_int_eq(count, PREVIEW_MAX);
+        for (int i = 0; i < count; i++) {
+            ck_assert_int_eq(view[i], expected[piece + 1 + i]);
+        }
+        
+        board_clear(&game.board);
+        game.board_hash = 0;
+        fsm_process_action(&game, Down, true);
+        fsm_process_action(&game, Start, false);
+        fsm_process_action(&game, Start, false);
+        ck_assert_int_eq(game.state, STATE_MOVING);
+    }
+    
+    // First hold takes the next piece, a second one before locking is ignored
+    int base = 3 * PIECE_QUEUE_CAPACITY;
+    fsm_process_action(&game, Up, false);
+    ck_assert_int_eq(game.hold_piece, expected[base]);
+    ck_assert_int_eq(game.current_piece.type, expected[base + 1]);
+    fsm_process_action(&game, Up, false);
+    ck_assert_int_eq(game.current_piece.type, expected[base + 1]);
+    
+    // After the next spawn hold swaps the two pieces
+    fsm_process_action(&game, Down, true);
+    fsm_process_action(&game, Start, false);
+    fsm_process_action(&game, Start, false);
+    ck_assert_int_eq(game.current_piece.type, expected[base + 2]);
+    fsm_process_action(&game, Up, false);
+    ck_assert_int_eq(game.current_piece.type, expected[base]);
+    ck_assert_int_eq(game.hold_piece, expected[base + 2]);
+    ck_assert_int_eq(game.current_piece.y, 0);
+    
+    // Idle ticks run attach and spawn without touching the hold slot
+    fsm_process_action(&game, Down, true);
+    for (int i = 0; i < 2 && game.state != STATE_MOVING; i++) {
+        fsm_tick(&game, FSM_IDLE, false);
+    }
+    ck_assert_int_eq(game.state, STATE_MOVING);
+    ck_assert_int_eq(game.current_piece.type, expected[base + 3]);
+    ck_assert_int_eq(game.hold_piece, expected[base + 2]);
+    
+    game_destroy(&game);
+    game_destroy(&reference);
+}
+END_TEST
+
+// Test that bot versus matches replay identically and garbage keeps the hash in step
+static void play_versus_match(VersusMatch_t *match, Bot_t bots[2], AttackEvent_t *log, int capacity,
+                              int *logged) {
+    *logged = 0;
+    
+    for (int tick = 0; tick < 20000; tick++) {
+        VersusInput_t inputs[2] = {0};
+        for (int p = 0; p < 2; p++) {
+            UserAction_t action;
+            bool hold;
+            if (bot_next_input(&bots[p], &match->players[p].game, &action, &hold)) {
+                versus_input_push(&inputs[p], action, hold);
+            }
+        }
+        bool running = versus_tick(match, inputs);
+        
+        for (int p = 0; p < 2; p++) {
+            const TetrisGame_t *game = &match->players[p].game;
+            ck_assert_uint_eq(game->board_hash, board_hash(&game->board));
+        }
+        for (int i = 0; i < match->event_count && *logged < capacity; i++) {
+            log[(*logged)++] = match->events[i];
+        }
+        if (!running) break;
+    }
+}
+
+START_TEST(test_versus_lockstep) {
+    VersusMatch_t matches[2];
+    Bot_t bots[2][2];
+    AttackEvent_t logs[2][256];
+    int logged[2];
+    
+    ck_assert(!versus_init(&matches[0], 1, BOARD_WIDTH, BOARD_HEIGHT, 5));
+    for (int m = 0; m < 2; m++) {
+        ck_assert(versus_init(&matches[m], 2, BOARD_WIDTH, BOARD_HEIGHT, 5));
+        for (int p = 0; p < 2; p++) {
+            ck_assert(bot_init(&bots[m][p], &matches[m].players[p].game, NULL));
+        }
+        play_versus_match(&matches[m], bots[m], logs[m], 256, &logged[m]);
+    }
+    
+    ck_assert_int_gt(logged[0], 0);
+    ck_assert_int_eq(logged[0], logged[1]);
+    for (int i = 0; i < logged[0]; i++) {
+        ck_assert_uint_eq(logs[0][i].tick, logs[1][i].tick);
+        ck_assert_int_eq(logs[0][i].sender, logs[1][i].sender);
+        ck_assert_int_eq(logs[0][i].lines, logs[1][i].lines);
+        ck_assert_int_eq(logs[0][i].hole, logs[1][i].hole);
+    }
+    ck_assert_uint_eq(matches[0].tick, matches[1].tick);
+    ck_assert_int_eq(matches[0].winner, matches[1].winner);
+    
+    int received = 0;
+    for (int p = 0; p < 2; p++) {
+        received += matches[0].players[p].lines_received;
+        ck_assert_uint_eq(game_hash(&matches[0].players[p].game),
+                          game_hash(&matches[1].players[p].game));
+    }
+    ck_assert_int_gt(received, 0);
+    
+    // Garbage rows come in under the stack with exactly one hole
+    Board_t board;
+    ck_assert(board_init(&board, BOARD_WIDTH, BOARD_HEIGHT));
+    board_set_cell(&board, 3, TOTAL_HEIGHT - 1, true);
+    uint64_t garbage = board.full_row & ~(UINT64_C(1) << 7);
+    uint64_t hash = board_hash_garbage(board_hash(&board), 2, garbage);
+    ck_assert(board_push_garbage(&board, 2, garbage));
+    ck_assert_uint_eq(hash, board_hash(&board));
+    ck_assert(board_get_cell(&board, 3, TOTAL_HEIGHT - 3));
+    ck_assert_uint_eq(board.kernels->get_row(&board, TOTAL_HEIGHT - 1), garbage);
+    ck_assert_uint_eq(board.kernels->get_row(&board, TOTAL_HEIGHT - 2), garbage);
+    board_free(&board);
+    
+    // Keys pressed within one tick all apply, in order
+    VersusMatch_t *match = &matches[0];
+    VersusInput_t idle[2] = {0};
+    versus_restart(match, 9);
+    while (match->players[0].game.state != STATE_MOVING) {
+        versus_tick(match, idle);
+    }
+    int x = match->players[0].game.current_piece.x;
+    VersusInput_t keys[2] = {0};
+    ck_assert(versus_input_push(&keys[0], Left, false));
+    ck_assert(versus_input_push(&keys[0], Left, false));
+    versus_tick(match, keys);
+    ck_assert_int_eq(match->players[0].game.current_piece.x, x - 2);
+    for (int i = 2; i < VERSUS_MAX_KEYS; i++) {
+        ck_assert(versus_input_push(&keys[0], Right, false));
+    }
+    ck_assert(!versus_input_push(&keys[0], Right, false));
+    
+    for (int m = 0; m < 2; m++) {
+        for (int p = 0; p < 2; p++) {
+            bot_free(&bots[m][p]);
+        }
+        versus_free(&matches[m]);
+    }
+}
+END_TEST
+
+// Test the wire protocol: round trips, framing, and a frame stream that
+// rebuilds the field over a real socket pair
+START_TEST(test_net_protocol) {
+    uint8_t msg[NET_MAX_MESSAGE];
+    NetHello_t hello = {.version = NET_PROTOCOL_VERSION, .width = 10, .height = 20, .seed = 99};
+    NetHello_t read_back;
+    int size = (int)net_write_hello(msg, NET_HELLO, &hello);
+    
+    ck_assert_int_eq(net_message_size(msg, (size_t)size - 1), 0);
+    ck_assert_int_eq(net_message_size(msg, (size_t)size + 5), size);
+    ck_assert(net_read_hello(msg, size, &read_back));
+    ck_assert_int_eq(read_back.height, 20);
+    ck_assert_uint_eq(read_back.seed, 99);
+    ck_assert(!net_read_input(msg, size, &(NetInput_t){0}));
+    
+    NetInput_t input = {.seq = 7, .stamp = UINT64_C(1) << 40, .action = Left, .hold = 1};
+    NetInput_t decoded;
+    size = (int)net_write_input(msg, &input);
+    ck_assert(net_read_input(msg, size, &decoded));
+    ck_assert_uint_eq(decoded.seq, 7);
+    ck_assert_uint_eq(decoded.stamp, input.stamp);
+    ck_assert_int_eq(decoded.action, Left);
+    msg[NET_LENGTH_BYTES + 13] = 42;
+    ck_assert(!net_read_input(msg, size, &decoded));
+    msg[0] = 0xff;
+    msg[1] = 0xff;
+    ck_assert_int_eq(net_message_size(msg, 2), -1);
+    
+    // A valid length that cannot fit the buffer fails instead of waiting
+    // forever for bytes there is no room to read
+    NetBuffer_t small;
+    ck_assert(net_buffer_init(&small, 64));
+    uint8_t *space = net_buffer_reserve(&small, 64);
+    memset(space, 0, 64);
+    space[0] = 100;
+    net_buffer_commit(&small, 32);
+    ck_assert_int_eq(net_buffer_next_message(&small), 0);
+    net_buffer_commit(&small, 32);
+    ck_assert_int_eq(net_buffer_next_message(&small), -1);
+    net_buffer_free(&small);
+    
+    int sockets[2];
+    ck_assert_int_eq(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets), 0);
+    
+    // Server and client ends of one game, both driven by the same inputs
+    TetrisGame_t server, mirror;
+    FrameExport_t server_frames, mirror_frames;
+    FrameStream_t encoder, decoder;
+    NetBuffer_t out, in;
+    Bot_t bot;
+    ck_assert(game_init(&server, BOARD_WIDTH, BOARD_HEIGHT));
+    ck_assert(game_init(&mirror, BOARD_WIDTH, BOARD_HEIGHT));
+    seed_piece_generator(&server, 3);
+    seed_piece_generator(&mirror, 3);
+    ck_assert(frame_export_init(&server_frames, BOARD_WIDTH, BOARD_HEIGHT));
+    ck_assert(frame_export_init(&mirror_frames, BOARD_WIDTH, BOARD_HEIGHT));
+    ck_assert(stream_init(&encoder, BOARD_WIDTH, BOARD_HEIGHT, 50));
+    ck_assert(stream_init(&decoder, BOARD_WIDTH, BOARD_HEIGHT, 0));
+    ck_assert(net_buffer_init(&out, NET_MAX_MESSAGE * 2));
+    ck_assert(net_buffer_init(&in, NET_MAX_MESSAGE * 2));
+    ck_assert(bot_init(&bot, &mirror, NULL));
+    
+    int payload = 0;
+    for (uint32_t seq = 1; seq <= 600 && !mirror.game_over; seq++) {
+        UserAction_t action;
+        bool hold;
+        ck_assert(bot_next_input(&bot, &mirror, &action, &hold));
+        input = (NetInput_t){.seq = seq, .stamp = seq * 10, .action = (uint8_t)action, .hold = hold};
+        net_step_game(&mirror, &input);
+        frame_export(&mirror_frames, &mirror);
+        
+        net_step_game(&server, &input);
+        const FrameView_t *view = frame_export(&server_frames, &server);
+        net_buffer_commit(&out, net_write_frame(net_buffer_reserve(&out, NET_MAX_MESSAGE), seq,
+                                                input.stamp, &encoder, view, &server));
+        ck_assert_int_eq(net_buffer_flush(&out, sockets[0]), NET_IO_OK);
+        ck_assert_int_eq(net_buffer_fill(&in, sockets[1]), NET_IO_OK);
+        
+        NetFrame_t frame;
+        StreamFrame_t decoded;
+        size = net_message_size(in.data + in.start, net_buffer_pending(&in));
+        ck_assert_int_gt(size, 0);
+        ck_assert(net_read_frame(in.data + in.start, size, &frame));
+        ck_assert_int_eq(stream_decode(&decoder, frame.payload, (size_t)frame.payload_size, &decoded),
+                         frame.payload_size);
+        net_buffer_consume(&in, (size_t)size);
+        
+        ck_assert_uint_eq(frame.seq, seq);
+        ck_assert_uint_eq(frame.stamp, input.stamp);
+        ck_assert_int_eq(decoded.score, mirror.score);
+        ck_assert_int_eq(memcmp(decoded.rows, mirror_frames.rows, BOARD_HEIGHT * sizeof(uint64_t)), 0);
+        payload += frame.payload_size;
+    }
+    ck_assert_int_gt(payload, 0);
+    ck_assert_uint_eq(game_hash(&server), game_hash(&mirror));
+    
+    close(sockets[0]);
+    ck_assert_int_eq(net_buffer_fill(&in, sockets[1]), NET_IO_CLOSED);
+    close(sockets[1]);
+    bot_free(&bot);
+    stream_free(&encoder);
+    stream_free(&decoder);
+    net_buffer_free(&out);
+    net_buffer_free(&in);
+    frame_export_free(&server_frames);
+    frame_export_free(&mirror_frames);
+    game_destroy(&server);
+    game_destroy(&mirror);
+}
+END_TEST
+
+// Test that the state version moves with every change a frame can show
+START_TEST(test_state_version) {
+    TetrisGame_t game;
+    FrameExport_t fx;
+    Bot_t bot;
+    ck_assert(game_init(&game, BOARD_WIDTH, BOARD_HEIGHT));
+    ck_assert(frame_export_init(&fx, BOARD_WIDTH, BOARD_HEIGHT));
+    seed_piece_generator(&game, 11);
+    ck_assert(bot_init(&bot, &game, NULL));
+    
+    // Anything that shows up in a frame must move the version
+    const FrameView_t *view = frame_export(&fx, &game);
+    uint64_t version = game.version;
+    int score = view->score;
+    int hold = view->hold;
+    int next = view->preview[0];
+    int redraws = 0;
+    int steps = 0;
+    for (; steps < 5000 && bot_play(&bot, &game); steps++) {
+        fsm_update_timer(&game);
+        view = frame_export(&fx, &game);
+        bool changed = view->change_count > 0 || view->score != score || view->hold != hold ||
+                       view->preview[0] != next;
+        if (changed) {
+            ck_assert_uint_ne(game.version, version);
+        }
+        redraws += game.version != version;
+        version = game.version;
+        score = view->score;
+        hold = view->hold;
+        next = view->preview[0];
+    }
+    ck_assert_int_gt(redraws, steps / 2);
+    bot_free(&bot);
+    frame_export_free(&fx);
+    game_destroy(&game);
+    
+    // Global API: no-op inputs and gravity ticks keep the version
+    init_game();
+    ck_assert_uint_ne(tetris_state_version(), 0);
+    userInput(Start, false);
+    userInput(Up, false);
+    uint64_t spawned = tetris_state_version();
+    for (int i = 0; i < BOARD_WIDTH; i++) {
+        userInput(Left, false);
+    }
+    ck_assert_uint_ne(tetris_state_version(), spawned);
+    uint64_t at_wall = tetris_state_version();
+    userInput(Left, false);
+    update_game_timer();
+    ck_assert_uint_eq(tetris_state_version(), at_wall);
+    userInput(Pause, false);
+    ck_assert_uint_ne(tetris_state_version(), at_wall);
+    cleanup_game();
+}
+END_TEST
+
+// Test that cell colours follow locks and line clears
+START_TEST(test_cell_colors) {
+    TetrisGame_t game;
+    ck_assert(game_init(&game, BOARD_WIDTH, BOARD_HEIGHT));
+    Board_t *board = &game.board;
+    ck_assert_ptr_ne(board->colors, NULL);
+    int bottom = board->total_height - 1;
+    
+    // A T above a bottom row that an I completes
+    for (int x = PIECE_SIZE; x < BOARD_WIDTH; x++) {
+        board_set_cell(board, x, bottom, true);
+    }
+    ck_assert_int_eq(board_get_color(board, BOARD_WIDTH - 1, bottom), CELL_GARBAGE);
+    Piece_t t = {.type = PIECE_T, .x = 4, .y = bottom - 5};
+    place_piece(&game, &t);
+    game.current_piece = (Piece_t){.type = PIECE_I, .x = 0, .y = bottom - 1};
+    place_piece(&game, &game.current_piece);
+    ck_assert_int_eq(board_get_color(board, 0, bottom), PIECE_I);
+    ck_assert_int_eq(clear_completed_lines(&game), 1);
+    
+    // Colours move with their rows, and garbage pushed in underneath is grey
+    const PieceCell_t *cells = piece_cells[PIECE_T][0];
+    for (int i = 0; i < PIECE_CELLS; i++) {
+        int x = t.x + cells[i].x;
+        int y = t.y + cells[i].y;
+        ck_assert(board_get_cell(board, x, y + 1));
+        ck_assert_int_eq(board_get_color(board, x, y + 1), PIECE_T);
+    }
+    ck_assert(board_push_garbage(board, 1, board->full_row & ~UINT64_C(1)));
+    ck_assert_int_eq(board_get_color(board, 1, bottom), CELL_GARBAGE);
+    for (int i = 0; i < PIECE_CELLS; i++) {
+        ck_assert_int_eq(board_get_color(board, t.x + cells[i].x, t.y + cells[i].y), PIECE_T);
+    }
+    
+    // Exports carry the falling piece's colour, in the view and its changes
+    FrameExport_t fx;
+    ck_assert(frame_export_init(&fx, BOARD_WIDTH, BOARD_HEIGHT));
+    frame_export(&fx, &game);
+    game.state = STATE_MOVING;
+    game.current_piece = (Piece_t){.type = PIECE_S, .x = 0, .y = BOARD_EXTRA_HEIGHT};
+    const FrameView_t *view = frame_export(&fx, &game);
+    ck_assert_int_eq(view->change_count, PIECE_CELLS);
+    for (int i = 0; i < view->change_count; i++) {
+        const CellChange_t *change = &view->changes[i];
+        ck_assert_int_eq(change->color, PIECE_S);
+        ck_assert_int_eq(frame_cell_color(view->colors, change->x, change->y), PIECE_S);
+    }
+    frame_export_free(&fx);
+    game_destroy(&game);
+}
+END_TEST
+
+// Test the frame stream: keyframe cadence, joining mid-stream, and exact
+// reconstruction of rows and scalars from the deltas
+START_TEST(test_frame_stream) {
+    TetrisGame_t game;
+    FrameExport_t fx;
+    FrameStream_t encoder, decoder, late;
+    Bot_t bot;
+    ck_assert(game_init(&game, BOARD_WIDTH, BOARD_HEIGHT));
+    seed_piece_generator(&game, 11);
+    ck_assert(frame_export_init(&fx, BOARD_WIDTH, BOARD_HEIGHT));
+    ck_assert(bot_init(&bot, &game, NULL));
+    ck_assert(!stream_init(&encoder, 65, BOARD_HEIGHT, 10));
+    ck_assert(stream_init(&encoder, BOARD_WIDTH, BOARD_HEIGHT, 10));
+    ck_assert(stream_init(&decoder, BOARD_WIDTH, BOARD_HEIGHT, 0));
+    ck_assert(stream_init(&late, BOARD_WIDTH, BOARD_HEIGHT, 0));
+    
+    uint8_t buf[STREAM_MAX_FRAME_BYTES(BOARD_HEIGHT)];
+    StreamFrame_t frame;
+    int keyframes = 0;
+    for (int tick = 0; tick < 400; tick++) {
+        if (!bot_play(&bot, &game)) break;
+        fsm_update_timer(&game);
+        const FrameView_t *view = frame_export(&fx, &game);
+        
+        size_t size = stream_encode(&encoder, view, buf);
+        ck_assert_uint_le(size, sizeof(buf));
+        ck_assert_int_eq(stream_decode(&decoder, buf, size, &frame), (int)size);
+        ck_assert_int_eq(memcmp(frame.rows, view->rows, BOARD_HEIGHT * sizeof(uint64_t)), 0);
+        ck_assert_int_eq(frame.score, view->score);
+        ck_assert_int_eq(frame.level, view->level);
+        ck_assert_int_eq(frame.next, view->preview[0]);
+        ck_assert_int_eq(frame.hold, view->hold);
+        ck_assert(frame.keyframe == (tick % 10 == 0));
+        keyframes += frame.keyframe;
+        
+        // A receiver joining late waits for the next keyframe; a truncated
+        // frame fails cleanly instead of reading past the end
+        if (tick >= 5) {
+            if (tick % 10 == 0) {
+                ck_assert_int_eq(stream_decode(&late, buf, size - 1, &frame), -1);
+            }
+            int consumed = stream_decode(&late, buf, size, &frame);
+            ck_assert_int_eq(consumed, tick < 10 ? -1 : (int)size);
+        }
+    }
+    ck_assert_int_eq(keyframes, 40);
+    ck_assert_int_eq(memcmp(late.rows, decoder.rows, BOARD_HEIGHT * sizeof(uint64_t)), 0);
+    
+    // An unchanged frame is the fields byte plus one skip over every row,
+    // and a receiver that lost a delta waits for the next keyframe
+    frame_export(&fx, &game);
+    stream_encode(&encoder, &fx.view, buf);
+    ck_assert_uint_eq(stream_encode(&encoder, &fx.view, buf), 2);
+    ck_assert_int_eq(stream_decode(&decoder, buf, 1, &frame), -1);
+    ck_assert_int_eq(stream_decode(&decoder, buf, 2, &frame), -1);
+    stream_request_keyframe(&encoder);
+    ck_assert(stream_encode(&encoder, &fx.view, buf) > 2 && (buf[0] & STREAM_KEYFRAME));
+    
+    stream_free(&encoder);
+    stream_free(&decoder);
+    stream_free(&late);
+    bot_free(&bot);
+    frame_export_free(&fx);
+    game_destroy(&game);
+}
+END_TEST
+
+// Test the game registry, the runtime's change tracking and the Frogger lanes
+START_TEST(test_game_registry) {
+    // The runtime only knows the games registered with it, once each
+    game_registry_add(&tetris_game_vtable);
+    game_registry_add(&frogger_game_vtable);
+    ck_assert(!game_registry_add(&tetris_game_vtable));
+    ck_assert(!game_registry_add(NULL));
+    ck_assert_ptr_eq(game_registry_find("tetris"), &tetris_game_vtable);
+    ck_assert_ptr_eq(game_registry_find("frogger"), &frogger_game_vtable);
+    ck_assert_ptr_eq(game_registry_find("snake"), NULL);
+    ck_assert_ptr_eq(game_registry_get(2), NULL);
+    
+    // Every game starts on Start and keeps running on steps alone; frames
+    // are only re-exported when the version moves
+    for (int i = 0; game_registry_get(i); i++) {
+        // Frontends draw the panel controls and help screen from the vtable
+        ck_assert_ptr_nonnull(game_registry_get(i)->controls);
+        ck_assert_ptr_nonnull(game_registry_get(i)->help);
+        BrickRuntime_t rt;
+        ck_assert(runtime_open(&rt, game_registry_get(i), 7));
+        bool changed;
+        runtime_frame(&rt, &changed);
+        ck_assert(changed);
+        runtime_frame(&rt, &changed);
+        ck_assert(!changed);
+        
+        runtime_input(&rt, Start, false);
+        int exports = 0;
+        for (int f = 0; f < 600; f++) {
+            runtime_step(&rt);
+            const GameFrame_t *frame = runtime_frame(&rt, &changed);
+            exports += changed;
+            ck_assert_int_eq(frame->width, BOARD_WIDTH);
+            ck_assert_int_eq(frame->height, BOARD_HEIGHT);
+        }
+        ck_assert_int_gt(exports, 0);
+        ck_assert_int_lt(exports, 600);
+        runtime_close(&rt);
+    }
+    
+    // Tetris runs the library's own game: options set through tetris.h
+    // apply, a second runtime is refused, and closing leaves the game to
+    // whoever initialised it
+    init_game();
+    ck_assert(set_preview_count(3));
+    BrickRuntime_t rt;
+    BrickRuntime_t second;
+    ck_assert(runtime_open(&rt, &tetris_game_vtable, 5));
+    ck_assert(!runtime_open(&second, &tetris_game_vtable, 5));
+    runtime_input(&rt, Start, false);
+    runtime_step(&rt);
+    ck_assert_int_eq(runtime_frame(&rt, NULL)->preview_count, 3);
+    ck_assert_uint_eq(rt.exported, tetris_state_version());
+    runtime_close(&rt);
+    ck_assert_int_eq(get_preview_queue(NULL), 3);
+    cleanup_game();
+    
+    // A custom-geometry game is refused rather than replaced under its owner
+    ck_assert(init_game_with_geometry(12, 24));
+    ck_assert(!runtime_open(&rt, &tetris_game_vtable, 5));
+    ck_assert_int_eq(get_board_width(), 12);
+    ck_assert_int_eq(get_board_height(), 24);
+    cleanup_game();
+    ck_assert(runtime_open(&rt, &tetris_game_vtable, 5));
+    runtime_close(&rt);
+    ck_assert_int_eq(tetris_state_version(), 0);
+    
+    // Frogger lanes turn as rings, and a car reaching the frog costs a life
+    FroggerGame_t frog;
+    frogger_init(&frog, 11);
+    frogger_input(&frog, Start);
+    FroggerLane_t *lane = &frog.lanes[BOARD_HEIGHT - 3];
+    lane->cars = 1;
+    lane->offset = FROGGER_RING - 1;
+    lane->step = 1;
+    lane->period = 1;
+    ck_assert_int_eq(frogger_lane_row(lane), 0);
+    frog.frog_x = 0;
+    frog.frog_y = BOARD_HEIGHT - 3;
+    frogger_step(&frog);
+    ck_assert_int_eq(frogger_lane_row(lane), 1);
+    ck_assert_int_eq(frog.lives, FROGGER_LIVES - 1);
+    ck_assert_int_eq(frog.frog_y, BOARD_HEIGHT - 1);
+    
+    // Reaching row 0 scores and sends the frog back
+    for (int y = 1; y < BOARD_HEIGHT; y++) {
+        frog.lanes[y].cars = 0;
+    }
+    for (int y = BOARD_HEIGHT - 1; y > 0; y--) {
+        frogger_input(&frog, Up);
+    }
+    ck_assert_int_eq(frog.score, 1);
+    ck_assert_int_eq(frog.frog_y, BOARD_HEIGHT - 1);
+    
+    // Through the runtime, the forward key the frontend sends (Action for
+    // W and the Up arrow) hops the frog one row up
+    BrickRuntime_t frog_rt;
+    ck_assert(runtime_open(&frog_rt, &frogger_game_vtable, 3));
+    runtime_input(&frog_rt, Start, false);
+    const FroggerGame_t *hopper = frog_rt.game;
+    int start_x = hopper->frog_x;
+    runtime_input(&frog_rt, Action, false);
+    ck_assert_int_eq(hopper->frog_y, BOARD_HEIGHT - 2);
+    const GameFrame_t *frame = runtime_frame(&frog_rt, NULL);
+    ck_assert(frame->rows[BOARD_HEIGHT - 2] & (UINT64_C(1) << start_x));
+    runtime_close(&frog_rt);
+}
+END_TEST
+
+// Test that every lock reaches the telemetry file and adds up to the game
+START_TEST(test_telemetry) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/test_telemetry_%d", (int)getpid());
+    
+    TetrisGame_t game;
+    Bot_t bot;
+    ck_assert(game_init(&game, BOARD_WIDTH, BOARD_HEIGHT));
+    seed_piece_generator(&game, 42);
+    game.telemetry = telemetry_open(path);
+    ck_assert_ptr_nonnull(game.telemetry);
+    ck_assert(bot_init(&bot, &game, NULL));
+    while (game.pieces_spawned < 300 && bot_play(&bot, &game)) {
+        fsm_update_timer(&game);
+    }
+    ck_assert_int_eq(telemetry_dropped(game.telemetry), 0);
+    ck_assert(telemetry_close(game.telemetry));
+    game.telemetry = NULL;
+    
+    FILE *file = fopen(path, "rb");
+    ck_assert_ptr_nonnull(file);
+    ck_assert(telemetry_read_header(file));
+    TelemetryRecord_t record;
+    int records = 0;
+    int lines = 0;
+    int score = 0;
+    uint32_t last_frame = 0;
+    while (telemetry_read(file, &record)) {
+        ck_assert_uint_ge(record.lock_frame, last_frame);
+        ck_assert_int_lt(record.piece, PIECE_COUNT);
+        ck_assert_int_le(record.height, BOARD_HEIGHT);
+        last_frame = record.lock_frame;
+        lines += record.lines;
+        score += record.score_delta;
+        records++;
+    }
+    fclose(file);
+    unlink(path);
+    
+    // The piece in play has not locked yet
+    ck_assert_int_eq(records, game.pieces_spawned - 1);
+    ck_assert_int_eq(lines, game.lines_cleared);
+    ck_assert_int_eq(score, game.score);
+    ck_assert_uint_gt(last_frame, 0);
+    
+    bot_free(&bot);
+    game_destroy(&game);
+}
+END_TEST
+
 Suite *tetris_suite(void) {
     Suite *s;
     TCase *tc_core;
@@ -181,6 +1363,28 @@ Suite *tetris_suite(void) {
     tcase_add_test(tc_core, test_memory_allocation);
     tcase_add_test(tc_core, test_piece_rotation);
     tcase_add_test(tc_core, test_termination);
+    tcase_add_test(tc_core, test_custom_geometry);
+    tcase_add_test(tc_core, test_invalid_geometry);
+    tcase_add_test(tc_core, test_board_line_clear);
+    tcase_add_test(tc_core, test_board_collision);
+    tcase_add_test(tc_core, test_rowscan_differential);
+    tcase_add_test(tc_core, test_frame_matches_game_info);
+    tcase_add_test(tc_core, test_frame_deltas);
+    tcase_add_test(tc_core, test_spectator_feed);
+    tcase_add_test(tc_core, test_bot_features);
+    tcase_add_test(tc_core, test_bot_seeded_game);
+    tcase_add_test(tc_core, test_puzzle_solver);
+    tcase_add_test(tc_core, test_state_hash);
+    tcase_add_test(tc_core, test_move_generator);
+    tcase_add_test(tc_core, test_piece_tables_match_templates);
+    tcase_add_test(tc_core, test_preview_queue_and_hold);
+    tcase_add_test(tc_core, test_versus_lockstep);
+    tcase_add_test(tc_core, test_net_protocol);
+    tcase_add_test(tc_core, test_frame_stream);
+    tcase_add_test(tc_core, test_state_version);
+    tcase_add_test(tc_core, test_cell_colors);
+    tcase_add_test(tc_core, test_game_registry);
+    tcase_add_test(tc_core, test_telemetry);
     
     suite_add_tcase(s, tc_core);
     